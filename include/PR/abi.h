@@ -0,0 +1,120 @@
+/**
+ * @file abi.h
+ * @brief RSP audio microcode command list (aspMain ABI)
+ *
+ * Each command is two words: opcode and flags in the top byte of w0,
+ * operands in the rest. The synthesizer builds one list per audio frame;
+ * on hardware it runs as an M_AUDTASK, on host builds os_host_audio.c
+ * interprets it directly.
+ */
+
+#ifndef _ABI_H_
+#define _ABI_H_
+
+#include "types.h"
+
+/* Opcodes */
+#define A_SPNOOP        0
+#define A_ADPCM         1
+#define A_CLEARBUFF     2
+#define A_ENVMIXER      3
+#define A_LOADBUFF      4
+#define A_RESAMPLE      5
+#define A_SAVEBUFF      6
+#define A_SEGMENT       7
+#define A_SETBUFF       8
+#define A_SETVOL        9
+#define A_DMEMMOVE      10
+#define A_LOADADPCM     11
+#define A_MIXER         12
+#define A_INTERLEAVE    13
+#define A_POLEF         14
+#define A_SETLOOP       15
+
+/* Flags */
+#define A_CONTINUE      0x00
+#define A_INIT          0x01
+#define A_LOOP          0x02
+#define A_OUT           0x02
+#define A_LEFT          0x02
+#define A_RIGHT         0x00
+#define A_VOL           0x04
+#define A_RATE          0x00
+#define A_AUX           0x08
+#define A_NOAUX         0x00
+#define A_MAIN          0x00
+#define A_MIX           0x10
+
+/* Resampler unity pitch (1.15 fixed point) */
+#define A_UNITY_PITCH   0x8000
+
+typedef struct Acmd {
+    u32     w0;
+    u32     w1;
+} Acmd;
+
+/* State blocks saved to RDRAM between frames (in samples) */
+#define ADPCMFSIZE      16          /* Samples per ADPCM frame */
+#define ADPCM_STATE     16          /* ADPCM_STATE s16 per voice */
+#define RESAMPLE_STATE  16
+#define ENVMIX_STATE    40
+#define POLEF_STATE     4
+
+#define _A_OP(op, f)    (((u32)(op) << 24) | (((u32)(f) & 0xFF) << 16))
+
+#define aADPCMdec(pkt, f, s) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_ADPCM, f); _a->w1 = (u32)(s); }
+
+#define aClearBuffer(pkt, d, c) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_CLEARBUFF, 0) | ((u32)(d) & 0xFFFF); \
+      _a->w1 = (u32)(c); }
+
+#define aEnvMixer(pkt, f, s) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_ENVMIXER, f); _a->w1 = (u32)(s); }
+
+#define aLoadBuffer(pkt, s) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_LOADBUFF, 0); _a->w1 = (u32)(s); }
+
+#define aMix(pkt, f, g, i, o) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_MIXER, f) | ((u32)(g) & 0xFFFF); \
+      _a->w1 = (((u32)(i) & 0xFFFF) << 16) | ((u32)(o) & 0xFFFF); }
+
+#define aPoleFilter(pkt, f, g, s) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_POLEF, f) | ((u32)(g) & 0xFFFF); \
+      _a->w1 = (u32)(s); }
+
+#define aResample(pkt, f, p, s) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_RESAMPLE, f) | ((u32)(p) & 0xFFFF); \
+      _a->w1 = (u32)(s); }
+
+#define aSaveBuffer(pkt, s) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_SAVEBUFF, 0); _a->w1 = (u32)(s); }
+
+#define aSegment(pkt, s, b) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_SEGMENT, 0); \
+      _a->w1 = (((u32)(s) & 0xFF) << 24) | ((u32)(b) & 0xFFFFFF); }
+
+#define aSetBuffer(pkt, f, i, o, c) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_SETBUFF, f) | ((u32)(i) & 0xFFFF); \
+      _a->w1 = (((u32)(o) & 0xFFFF) << 16) | ((u32)(c) & 0xFFFF); }
+
+#define aSetVolume(pkt, f, v, t, r) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_SETVOL, f) | ((u32)(v) & 0xFFFF); \
+      _a->w1 = (((u32)(t) & 0xFFFF) << 16) | ((u32)(r) & 0xFFFF); }
+
+#define aSetLoop(pkt, a) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_SETLOOP, 0); _a->w1 = (u32)(a); }
+
+#define aDMEMMove(pkt, i, o, c) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_DMEMMOVE, 0) | ((u32)(i) & 0xFFFF); \
+      _a->w1 = (((u32)(o) & 0xFFFF) << 16) | ((u32)(c) & 0xFFFF); }
+
+#define aLoadADPCM(pkt, c, d) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_LOADADPCM, 0) | ((u32)(c) & 0xFFFF); \
+      _a->w1 = (u32)(d); }
+
+#define aInterleave(pkt, l, r) \
+    { Acmd *_a = (pkt); _a->w0 = _A_OP(A_INTERLEAVE, 0); \
+      _a->w1 = (((u32)(l) & 0xFFFF) << 16) | ((u32)(r) & 0xFFFF); }
+
+#endif /* _ABI_H_ */
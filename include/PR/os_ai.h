@@ -12,4 +12,29 @@
 s32 osAiSetNextBuffer(void *addr, u32 size);
 s32 osAiSetFrequency(u32 frequency);
 
+#ifdef HOST_BUILD
+#include "PR/abi.h"
+
+/* Host audio interpreter statistics (os_host_audio.c) */
+typedef struct OSHostAudioStats {
+    u32     frames;             /* Command lists executed */
+    s32     voices_last;        /* Envmixer passes in the last list */
+    u64     ns_last;            /* Wall time of the last list */
+    u64     ns_per_voice_last;  /* ns_last / voices_last */
+    u64     ns_total;
+    u64     voice_frames_total; /* Sum of voices over all lists */
+    u64     op_ns[16];          /* Time per A_* opcode (opt-in) */
+    u32     op_count[16];       /* Commands per A_* opcode (opt-in) */
+} OSHostAudioStats;
+
+void __osHostAudioRun(Acmd *cmds, s32 count);
+void __osHostAudioSetSegment(s32 seg, void *base);
+OSHostAudioStats *__osHostAudioGetStats(void);
+void __osHostAudioResetStats(void);
+void __osHostAudioSetOpTiming(s32 on);
+s32 __osHostAudioRecord(const char *path);
+void __osHostAudioStopRecord(void);
+u32 __osHostAudioBench(s32 voices, s32 frames, const char *wav_path);
+#endif
+
 #endif /* _OS_AI_H_ */
@@ -22,6 +22,28 @@ typedef struct OSMesgQueue_s {
     OSMesg      *msg;           /* Message buffer array */
 } OSMesgQueue;
 
+/*
+ * Single-producer/single-consumer queue (os_spsc.c)
+ *
+ * Power-of-two ring with free-running indices: the producer only writes
+ * tail, the consumer only writes head, so neither side masks interrupts
+ * on the fast path. The bells are ordinary queues used only to sleep
+ * when the ring is empty (consumer) or full (producer).
+ */
+typedef struct OSSpscQueue_s {
+    volatile u32 head;          /* Next slot to read (consumer-owned) */
+    volatile u32 tail;          /* Next slot to write (producer-owned) */
+    u32         mask;           /* Capacity - 1 */
+    OSMesg      *msg;           /* Message buffer array */
+    volatile u8 recvWaiting;    /* Consumer is (about to be) asleep */
+    volatile u8 sendWaiting;    /* Producer is (about to be) asleep */
+    u16         pad;
+    OSMesgQueue recvBell;       /* Wakes the consumer */
+    OSMesgQueue sendBell;       /* Wakes the producer */
+    OSMesg      recvBellBuf[1];
+    OSMesg      sendBellBuf[1];
+} OSSpscQueue;
+
 /* Message queue flags */
 #define OS_MESG_NOBLOCK     0
 #define OS_MESG_BLOCK       1
@@ -32,4 +54,15 @@ s32 osSendMesg(OSMesgQueue *mq, OSMesg msg, s32 flags);
 s32 osRecvMesg(OSMesgQueue *mq, OSMesg *msg, s32 flags);
 s32 osJamMesg(OSMesgQueue *mq, OSMesg msg, s32 flags);
 
+s32 osCreateSpscQueue(OSSpscQueue *q, OSMesg *msg, s32 count);
+s32 osSpscSend(OSSpscQueue *q, OSMesg msg, s32 flags);
+s32 osSpscRecv(OSSpscQueue *q, OSMesg *msg, s32 flags);
+
+#ifdef HOST_BUILD
+/* Host backend (os_host.c): average blocking round trip in ns */
+u32 __osHostMesgRoundTrip(s32 iterations);
+/* Host benchmark (os_spsc.c): messages/sec through OSMesgQueue or OSSpscQueue */
+u32 __osHostMesgThroughput(s32 count, s32 use_spsc, s32 threaded);
+#endif
+
 #endif /* _OS_MESSAGE_H_ */
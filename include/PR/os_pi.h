@@ -82,4 +82,16 @@ s32 osPiStartDma(OSIoMesg *mb, s32 priority, s32 direction,
 void osCreatePiManager(s32 pri, OSMesgQueue *cmdQ, OSMesg *cmdBuf, s32 cmdMsgCnt);
 OSPiHandle *osCartRomInit(void);
 
+#ifdef HOST_BUILD
+/* Host PI backend (os_host_pi.c): DMA served from a ROM image file */
+typedef struct OSHostPiStats {
+    u32 requests;           /* osPiStartDma calls */
+    u32 bytes;              /* Bytes read from the image */
+} OSHostPiStats;
+
+u32 __osHostRomOpen(const char *path);
+void __osHostRomClose(void);
+OSHostPiStats *__osHostPiGetStats(s32 reset);
+#endif
+
 #endif /* _OS_PI_H_ */
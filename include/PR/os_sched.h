@@ -0,0 +1,73 @@
+/**
+ * @file os_sched.h
+ * @brief Scheduler deadline policy and frame statistics
+ *
+ * The scheduler measures retrace→RDP-done time for every graphics frame
+ * (__osScFrameTime) and predicts the next frame's cost. When the
+ * prediction crowds the frame budget it raises a pressure level and
+ * notifies a client callback, so the game can shed work (particles,
+ * shadows, draw distance) before a retrace is actually missed.
+ */
+
+#ifndef _OS_SCHED_H_
+#define _OS_SCHED_H_
+
+#include "types.h"
+
+/* osGetCount() rate: CPU clock / 2 */
+#define OS_SC_COUNT_HZ          46875000
+
+/* Default budget: one NTSC field */
+#define OS_SC_BUDGET_60HZ       (OS_SC_COUNT_HZ / 60)
+
+/* Split screen: two fields (30 fps) */
+#define OS_SC_BUDGET_30HZ       (OS_SC_COUNT_HZ / 30)
+
+/* Pressure levels (0 = full quality) */
+#define OS_SC_PRESSURE_NONE     0
+#define OS_SC_PRESSURE_LOW      1
+#define OS_SC_PRESSURE_HIGH     2
+#define OS_SC_PRESSURE_CRITICAL 3
+
+/* Policy thresholds, in 1/16ths of the budget */
+#define OS_SC_RAISE_16THS       15  /* Raise when prediction > 15/16 */
+#define OS_SC_LOWER_16THS       12  /* Lower when prediction < 12/16 ... */
+#define OS_SC_LOWER_FRAMES      30  /* ... for this many frames in a row */
+
+/**
+ * Pressure callback - runs on the scheduler thread, so it should only
+ * latch the new level for the game thread to apply.
+ */
+typedef void (*OSScPressureFunc)(s32 level, u32 predicted, u32 budget);
+
+/* Per-frame statistics */
+typedef struct OSScFrameStats {
+    u32     frames;             /* Graphics frames completed */
+    u32     last_ticks;         /* Last retrace→RDP-done time */
+    u32     avg_ticks;          /* Smoothed frame time (1/4 EWMA) */
+    u32     predicted_ticks;    /* Predicted next frame time */
+    u32     budget_ticks;       /* Current frame budget */
+    u32     missed;             /* Frames over budget */
+    u32     predicted_over;     /* Frames whose prediction crossed the raise mark */
+    u32     raises;             /* Pressure level increases */
+    u32     lowers;             /* Pressure level decreases */
+    s32     level;              /* Current OS_SC_PRESSURE_* */
+    s32     calm_frames;        /* Consecutive frames under the lower mark */
+} OSScFrameStats;
+
+/* Deadline timers */
+void osScResetTime(void);
+void osScEnableTime(void);
+void osScDisableTime(void);
+void osScUpdateTime(void);
+void osScSetDeadline(f32 time);
+void osScAddDeadline(f32 time);
+f32 osScGetTimeRemaining(void);
+s32 osScDeadlinePassed(void);
+
+/* Deadline policy */
+void osScSetFrameBudget(u32 ticks);
+void osScSetPressureCallback(OSScPressureFunc func);
+OSScFrameStats *osScGetFrameStats(void);
+
+#endif /* _OS_SCHED_H_ */
@@ -0,0 +1,85 @@
+/**
+ * @file os_sctrace.h
+ * @brief Scheduler timeline profiler
+ *
+ * Ring-buffered RSP/RDP/CPU timeline recorded with osGetCount(). The
+ * scheduler logs task starts/ends, yields and retraces; game threads add
+ * their own begin/end markers. osScTraceExport() writes the ring as
+ * Chrome trace-event JSON (load in chrome://tracing or Perfetto).
+ */
+
+#ifndef _OS_SCTRACE_H_
+#define _OS_SCTRACE_H_
+
+#include "types.h"
+
+/* Ring size (power of 2) - about two seconds of 4-player frames */
+#define SC_TRACE_MAX_EVENTS     1024
+#define SC_TRACE_MAX_MARKERS    16
+
+/* Event kinds */
+#define SC_TRACE_GFX_TASK       0   /* Graphics task on the RSP */
+#define SC_TRACE_AUDIO_TASK     1   /* Audio task on the RSP */
+#define SC_TRACE_RDP            2   /* RDP rasterizing a task */
+#define SC_TRACE_YIELD          3   /* Gfx task asked to yield */
+#define SC_TRACE_RETRACE        4   /* VI retrace */
+#define SC_TRACE_EXEC           5   /* __scExec dispatched work */
+#define SC_TRACE_MARKER         6   /* Game-thread marker (id = marker) */
+
+/* Phases (Chrome trace "ph") */
+#define SC_TRACE_BEGIN          'B'
+#define SC_TRACE_END            'E'
+#define SC_TRACE_INSTANT        'i'
+
+/* Timeline rows */
+#define SC_TRACK_SCHED          0
+#define SC_TRACK_RSP            1
+#define SC_TRACK_RDP            2
+#define SC_TRACK_THREAD         8   /* + OSThread id for markers */
+
+/* Game marker ids */
+#define SC_MARK_GAME_FRAME      0   /* game_frame_update() */
+#define SC_MARK_GAME_LOOP       1   /* game_loop() render pass */
+
+typedef struct OSScTraceEvent {
+    u32     count;              /* osGetCount() timestamp */
+    u8      kind;               /* SC_TRACE_* */
+    u8      phase;              /* SC_TRACE_BEGIN/END/INSTANT */
+    u8      track;              /* SC_TRACK_* */
+    u8      id;                 /* Marker id (SC_TRACE_MARKER only) */
+} OSScTraceEvent;
+
+typedef struct OSScTrace {
+    OSScTraceEvent  events[SC_TRACE_MAX_EVENTS];
+    u32             head;       /* Total events recorded (wraps ring) */
+    s32             enabled;
+} OSScTrace;
+
+extern OSScTrace __osScTrace;
+
+void osScTraceEnable(s32 enable);
+void osScTraceReset(void);
+void osScTraceRecord(s32 kind, s32 phase, s32 track, s32 id);
+void osScTraceSetMarkerName(s32 id, const char *name);
+void osScTraceBegin(s32 marker);
+void osScTraceEnd(s32 marker);
+s32 osScTraceExport(char *buf, s32 size);
+
+#ifdef HOST_BUILD
+s32 osScTraceWriteFile(const char *path);
+#endif
+
+/* Hooks compile away in matching builds so decompiled code stays byte-exact */
+#if defined(NON_MATCHING) || defined(HOST_BUILD)
+#define SC_TRACE(kind, phase, track)    osScTraceRecord(kind, phase, track, 0)
+#define SC_TRACE_MARK_BEGIN(marker)     osScTraceBegin(marker)
+#define SC_TRACE_MARK_END(marker)       osScTraceEnd(marker)
+#define SC_TRACE_ENABLE(on)             osScTraceEnable(on)
+#else
+#define SC_TRACE(kind, phase, track)
+#define SC_TRACE_MARK_BEGIN(marker)
+#define SC_TRACE_MARK_END(marker)
+#define SC_TRACE_ENABLE(on)
+#endif
+
+#endif /* _OS_SCTRACE_H_ */
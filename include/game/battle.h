@@ -40,11 +40,17 @@
 #define PICKUP_ARMOR            3   /* Damage reduction */
 #define NUM_PICKUP_TYPES        4
 
-/* Battle constants */
+/* Battle constants (table sizes may be raised for host benches) */
+#ifndef BATTLE_MAX_PLAYERS
 #define BATTLE_MAX_PLAYERS      4       /* Max players in battle */
+#endif
 #define BATTLE_MAX_PICKUPS      32      /* Max pickups on map */
+#ifndef BATTLE_MAX_PROJECTILES
 #define BATTLE_MAX_PROJECTILES  16      /* Max active projectiles */
+#endif
+#ifndef BATTLE_MAX_MINES
 #define BATTLE_MAX_MINES        8       /* Max mines per player */
+#endif
 #define BATTLE_MAX_HEALTH       100     /* Starting health */
 #define BATTLE_RESPAWN_TIME     180     /* Frames to respawn (3 sec) */
 #define BATTLE_PICKUP_RESPAWN   300     /* Pickup respawn time (5 sec) */
@@ -56,6 +62,19 @@
 #define DAMAGE_RAM              20      /* Boosted collision */
 #define DAMAGE_COLLISION        10      /* Normal collision */
 
+/* Spatial hash entity kinds */
+#define BATTLE_ENT_PLAYER       0
+#define BATTLE_ENT_PROJECTILE   1
+#define BATTLE_ENT_MINE         2
+#define BATTLE_ENT_PICKUP       3
+
+/* Spatial hash sizing (XZ plane) */
+#define BATTLE_GRID_CELL        16.0f   /* Cell edge in world units */
+#define BATTLE_GRID_BUCKETS     64      /* Hash buckets (power of 2) */
+#define BATTLE_GRID_MAX_ENTS    (BATTLE_MAX_PLAYERS + BATTLE_MAX_PROJECTILES + \
+                                 BATTLE_MAX_MINES * BATTLE_MAX_PLAYERS + BATTLE_MAX_PICKUPS)
+#define BATTLE_GRID_MAX_HITS    16      /* Max results per radius query */
+
 /* Projectile structure */
 typedef struct BattleProjectile {
     u8      active;             /* Is projectile active? */
@@ -119,6 +138,36 @@ typedef struct BattlePlayer {
 
 } BattlePlayer;
 
+/* Spatial hash entry - one per live entity, chained per bucket */
+typedef struct BattleGridEnt {
+    u8      kind;               /* BATTLE_ENT_* */
+    u8      index;              /* Index into the kind's array */
+    s16     next;               /* Next entry in bucket (-1 = end) */
+    s16     cell_x;             /* Cell coordinates, to reject hash aliases */
+    s16     cell_z;
+} BattleGridEnt;
+
+/* Radius query result */
+typedef struct BattleGridHit {
+    u8      kind;               /* BATTLE_ENT_* */
+    u8      index;              /* Index into the kind's array */
+    u16     pad;
+    f32     dist_sq;            /* Squared XZ distance to query point */
+} BattleGridHit;
+
+/* Per-frame spatial hash over all battle entities */
+typedef struct BattleGrid {
+    s16     head[BATTLE_GRID_BUCKETS];          /* First entry per bucket */
+    BattleGridEnt ents[BATTLE_GRID_MAX_ENTS];
+    s32     num_ents;
+    u32     build_frame;        /* frame_counter at last build */
+
+    /* Stats for the last frame */
+    u32     queries;            /* Radius/nearest queries issued */
+    u32     candidates;         /* Entries distance-tested */
+    u32     hits;               /* Entries returned */
+} BattleGrid;
+
 /* Battle mode state */
 typedef struct BattleState {
     u8      state;              /* BATTLE_STATE_* */
@@ -150,6 +199,9 @@ typedef struct BattleState {
     u32     match_time;         /* Total match duration */
     s32     winner;             /* Winner player index (-1 if none) */
 
+    /* Spatial hash, rebuilt once per frame */
+    BattleGrid grid;
+
 } BattleState;
 
 /* Global battle state */
@@ -201,6 +253,33 @@ void battle_check_mine_triggers(void);
 void battle_check_pickup_collection(void);
 void battle_check_player_collisions(void);
 
+/* Spatial queries */
+void battle_grid_build(void);
+s32 battle_grid_query_radius(f32 pos[3], f32 radius, s32 kind_mask, s32 exclude_player,
+                             BattleGridHit *hits, s32 max_hits);
+s32 battle_grid_nearest(f32 pos[3], f32 max_range, s32 kind, s32 exclude_player, f32 *dist_sq);
+
+#ifdef HOST_BUILD
+/* Combined collision check benchmark results, ns per frame */
+typedef struct BattleBenchStats {
+    u32     frames;
+    s32     players;            /* Live entities each frame */
+    s32     projectiles;
+    s32     mines;
+    s32     pickups;
+    u32     brute_ns;           /* Every entity against every player */
+    u32     build_ns;           /* battle_grid_build */
+    u32     check_ns;           /* The four battle_check_* passes */
+    u32     brute_tests;        /* Pair tests per frame, brute force */
+    u32     grid_tests;         /* Grid candidates tested per frame */
+    u32     hits;               /* Projectile hits, mine triggers, pickups */
+    u32     mismatches;         /* Frames where grid and brute force disagree */
+} BattleBenchStats;
+
+void battle_check_bench(s32 players, s32 projectiles, s32 mines, s32 frames,
+                        BattleBenchStats *out);
+#endif
+
 /* Queries */
 s32 battle_is_active(void);
 s32 battle_player_alive(s32 player);
@@ -105,6 +105,15 @@ typedef struct BoostPad {
     u8      pad[2];
 } BoostPad;
 
+/* Boost pad record in the track's boost pad section */
+typedef struct BoostPadRecord {
+    f32     pos[3];             /* World position */
+    f32     width;              /* Pad width */
+    f32     length;             /* Pad length */
+    f32     rotation;           /* Facing angle */
+    f32     multiplier;         /* Speed boost amount */
+} BoostPadRecord;
+
 /* Per-player boost state */
 typedef struct PlayerBoost {
     /* Meter/charges */
@@ -195,7 +204,7 @@ s32 boost_get_charges(s32 player);
 void boost_add_charge(s32 player);
 
 /* Boost pads */
-void boost_load_pads(void *track_data);
+void boost_load_pads(void *track_data, u32 size);
 void boost_clear_pads(void);
 s32 boost_add_pad(f32 *pos, f32 width, f32 length, f32 rotation, f32 mult);
 void boost_check_pads(s32 player, f32 *pos);
@@ -118,6 +118,9 @@ void camera_set_mode(s32 mode);
 
 /* Per-frame update */
 void camera_update(void);
+#ifdef NON_MATCHING
+CameraData *camera_get_view(s32 view);
+#endif
 void camera_check_view_change(void);
 void camera_set_view(void);
 
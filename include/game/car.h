@@ -324,12 +324,35 @@ void model_iteration(void);
 void modelstop(void);
 void multigo(s16 drone_index);
 
+/* Model thread pipeline statistics (osGetCount() ticks) */
+typedef struct ModelPipeStats {
+    u32     frames;             /* Update_MDrive() calls timed */
+    u32     sync_wait_last;     /* Game thread wait for the model batch */
+    u32     sync_wait_max;
+    f32     interval_mean;      /* Frame interval, 1/16 EWMA */
+    f32     interval_var;       /* Frame interval variance (latency jitter) */
+    s32     threaded;           /* Model on its own thread */
+} ModelPipeStats;
+
+void model_pipe_enable(s32 enable);
+ModelPipeStats *model_pipe_get_stats(void);
+#ifdef HOST_BUILD
+void model_pipe_bench(s32 frames, void (*render)(void), ModelPipeStats out[2]);
+#endif
+
+/* Render-only car transform, blended between the last two model substeps */
+typedef struct CarDisplay {
+    f32     pos[3];
+    f32     uvs[3][3];
+} CarDisplay;
+
+CarDisplay *car_get_display(s32 slot);
+u32 car_get_appearance(s32 slot);
+
 /* Communication and data update */
 void multicomm(void);
 void communication(void);
 void update_game_data(void);
-void update_player_model(s32 curtime);
-void update_drone_models(s32 curtime);
 void update_model(s32 slot, s32 curtime);
 void update_link_cars(void);
 
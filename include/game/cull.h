@@ -0,0 +1,81 @@
+/**
+ * cull.h - Per-viewport frustum culling
+ *
+ * Each viewport keeps a snapshot of the six frustum planes built by
+ * render_set_projection/render_set_camera. Spheres are tested with one
+ * dot product per plane, boxes with the sign-selected nearest corner.
+ * Static track objects are grouped into a bounding volume hierarchy so a
+ * whole subtree is rejected (or accepted) with a single box test.
+ * Split-screen viewports can share one walk of the tree, each object
+ * coming back with a bitmask of the viewports that see it.
+ *
+ * LOD is picked from the same per-viewport state: an object's projected
+ * radius in pixels (radius / distance x viewport height / 2tan(fovy/2)),
+ * so a quarter-screen viewport drops detail sooner than full screen.
+ * Switches need the size to clear the threshold by a hysteresis band,
+ * and a global bias (driven by the frame-time governor) scales all
+ * sizes at once.
+ */
+
+#ifndef CULL_H
+#define CULL_H
+
+#include "types.h"
+
+#define CULL_MAX_VIEWS      4
+#define CULL_MAX_STATIC     600     /* MAX_TRK_OBJS from arcade */
+#define CULL_BVH_LEAF       4       /* Objects per leaf */
+#define CULL_ALL_PLANES     0x3F
+
+/* LOD */
+#define LOD_LEVELS          4
+#define LOD_HYST_16THS      3       /* Band: +-3/16 of each threshold */
+#define LOD_CLASS_CAR       0       /* Cars (car_lod_select) */
+#define LOD_CLASS_MBOX      1       /* MBOX props (entity_lod_select) */
+#define LOD_CLASS_ZOID      2       /* ZOID render objects (render_object) */
+#define LOD_CLASS_CAR_ENT   3       /* Car entities (entity_lod_select type 1) */
+#define LOD_NUM_CLASSES     4
+
+/* Per-frame counters (summed over all viewports) */
+typedef struct CullStats {
+    u32     frames;
+    u32     tested;             /* Objects considered */
+    u32     culled;             /* Objects rejected */
+    u32     nodes_visited;      /* BVH nodes tested */
+    u32     nodes_rejected;     /* Subtrees culled whole */
+    u32     nodes_accepted;     /* Subtrees accepted whole */
+    u32     plane_tests;        /* Plane dot products */
+    u32     lod_selects;        /* lod_select calls */
+    u32     lod_switches;       /* Selections that changed level */
+    u32     lod_held;           /* Switches suppressed by hysteresis */
+    u32     lod_level[LOD_LEVELS];  /* Selections per level */
+} CullStats;
+
+/* Frame / viewport setup */
+void cull_frame_begin(void);
+void cull_view_begin(s32 view);
+void cull_view_bind(s32 view, const void *camera);
+s32  cull_view_find(const void *camera);
+void cull_view_update(f32 pixels_per_unit);
+s32  cull_view_current(void);
+
+/* Single tests: 1 = visible, 0 = culled */
+s32  cull_sphere(s32 view, f32 center[3], f32 radius);
+s32  cull_box(s32 view, f32 min[3], f32 max[3]);
+
+/* Batch tests */
+s32  cull_spheres(s32 view, f32 (*centers)[3], f32 *radii, s32 count, u8 *visible);
+s32  cull_bvh_build(f32 (*centers)[3], f32 *radii, s32 count);
+s32  cull_bvh_run(s32 view, u8 *visible);
+
+/* All viewports in one walk: bit per viewport that sees each object */
+s32  cull_bvh_run_views(s32 view_mask, u8 *masks);
+
+/* Screen-space LOD */
+s32  lod_select(s32 view, s32 cls, f32 radius, f32 distance, s32 current);
+void lod_set_bias(f32 bias);
+f32  lod_get_bias(void);
+
+CullStats *cull_get_stats(void);
+
+#endif /* CULL_H */
@@ -0,0 +1,41 @@
+/**
+ * ground.h - Per-car ground height cache
+ *
+ * Each car publishes its four tire contact points once per frame. The
+ * points seed a small world-aligned height grid centred on the car, so
+ * shadow, particle and camera ground queries that land near a car read
+ * the cached heights instead of walking track geometry again. When the
+ * contacts are coplanar the whole grid comes from the fitted plane;
+ * otherwise (curbs, crests, one wheel airborne) grid vertices are filled
+ * on first use from the full query and shared by every later caller.
+ * Queries outside every car's grid fall through to the full query.
+ */
+
+#ifndef GROUND_H
+#define GROUND_H
+
+#include "types.h"
+
+#define GROUND_MAX_CARS     8       /* MAX_LINKS */
+#define GROUND_GRID         4       /* Vertices per side (3x3 cells) */
+#define GROUND_HALF_EXTENT  8.0f    /* Grid half-size around the car (ft) */
+#define GROUND_PLANAR_TOL   0.25f   /* Max contact residual for plane fill (ft) */
+
+typedef struct GroundStats {
+    u32     frames;
+    u32     patches;            /* Cars that published contacts */
+    u32     planar;             /* ...whose grid came from the plane fit */
+    u32     queries;            /* ground_cache_query calls */
+    u32     hits;               /* Answered from a car grid */
+    u32     fills;              /* Grid vertices filled by a full query */
+    u32     fallbacks;          /* ground_get_y misses sent to a full query */
+} GroundStats;
+
+void ground_cache_begin_frame(void);
+void ground_cache_set_car(s32 slot, f32 contacts[4][3]);
+s32  ground_cache_query(f32 x, f32 z, f32 *y);
+f32  ground_get_y(f32 x, f32 z);
+
+GroundStats *ground_get_stats(void);
+
+#endif /* GROUND_H */
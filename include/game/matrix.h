@@ -0,0 +1,53 @@
+/**
+ * matrix.h - 4x4 matrix conversion for the RSP
+ *
+ * Float <-> 16.16 fixed-point Mtx conversion (matrix.c). NON_MATCHING
+ * builds add a batch converter and a per-frame matrix arena: dynamic
+ * matrices are bump-allocated from a double-buffered pool, and static
+ * ones (props, track objects) live in a cache slot that is only
+ * reconverted when marked dirty.
+ */
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "types.h"
+
+void guMtxIdentF(f32 mtx[4][4]);
+void guMtxF2L(f32 src[4][4], u16 *dst);
+void guMtxL2F(u16 *src, f32 dst[4][4]);
+void guMtxIdent(u16 *mtx);
+
+#ifdef NON_MATCHING
+
+#define MTX_ARENA_SIZE      512     /* Dynamic matrices per frame */
+#define MTX_CACHE_SIZE      256     /* Static matrix slots */
+
+typedef struct MtxStats {
+    u32     frames;
+    u32     dynamic_last;       /* Dynamic matrices converted last frame */
+    u32     dynamic_hwm;        /* Peak dynamic matrices in one frame */
+    u32     cache_converted;    /* Static slots reconverted (dirty) */
+    u32     cache_hits;         /* Static slot fetches with no conversion */
+    u32     overflows;          /* Arena allocations refused */
+    u32     batches;            /* guMtxF2L_batch calls */
+} MtxStats;
+
+void guMtxF2L_batch(const f32 (*src)[4][4], Mtx *dst, s32 n);
+
+/* Per-frame dynamic arena */
+void mtx_arena_begin_frame(void);
+Mtx *mtx_arena_convert(const f32 (*src)[4][4], s32 n);
+
+/* Static cache */
+s32  mtx_cache_alloc(void);
+void mtx_cache_free(s32 slot);
+void mtx_cache_set(s32 slot, const f32 src[4][4]);
+void mtx_cache_flush(void);
+Mtx *mtx_cache_get(s32 slot);
+
+MtxStats *mtx_get_stats(void);
+
+#endif /* NON_MATCHING */
+
+#endif /* MATRIX_H */
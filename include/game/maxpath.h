@@ -110,6 +110,7 @@ extern s16 gMPRecordIndex;
 void maxpath_init(s32 record_mode);
 void maxpath_reset(void);
 void maxpath_load(s32 track_id);
+void maxpath_load_data(void *data, u32 size);
 void maxpath_init_car(s32 car_index);
 
 /* Per-frame update */
@@ -146,6 +147,7 @@ f32 maxpath_steer_to_point(s32 car_index, f32 target[3]);
 void maxpath_start_lap(s32 car_index);
 void maxpath_end_lap(s32 car_index);
 s32 maxpath_get_lap(s32 car_index);
+s32 maxpath_get_section(s32 car_index, s32 num_sections);
 
 /* Recording (for creating new paths) */
 void maxpath_start_record(s32 path_index);
@@ -46,6 +46,12 @@
 #define MINIMAP_SIZE_LARGE      96      /* Large radar */
 #define MINIMAP_SIZE_FULL       160     /* Full screen */
 
+/* Outline LODs */
+#define MINIMAP_NUM_LODS        3       /* Simplified outline levels */
+#define MINIMAP_MAX_SRC_POINTS  512     /* Path points fed to simplification */
+#define MINIMAP_MAX_LOD_POINTS  96      /* Points kept per LOD */
+#define MINIMAP_OUTLINE_SHIFT   2       /* Sub-pixel bits in outline coords */
+
 /* Track point for map outline */
 typedef struct MapPoint {
     f32     x, z;               /* World coordinates */
@@ -72,6 +78,12 @@ typedef struct MapMarker {
     f32     scale;              /* Size multiplier */
 } MapMarker;
 
+/* Simplified outline, pre-projected to map space at MINIMAP_SIZE_FULL */
+typedef struct MapOutlineLod {
+    s16     pts[MINIMAP_MAX_LOD_POINTS][2];     /* Map pixels << MINIMAP_OUTLINE_SHIFT */
+    s32     count;
+} MapOutlineLod;
+
 /* Track map data */
 typedef struct TrackMap {
     /* Bounds in world coordinates */
@@ -90,6 +102,9 @@ typedef struct TrackMap {
     MapPoint checkpoints[20];
     s32     checkpoint_count;
 
+    /* Simplified outlines, finest first */
+    MapOutlineLod lods[MINIMAP_NUM_LODS];
+
     /* Map texture if pre-rendered */
     u32     texture_id;
     u8      has_texture;
@@ -143,6 +158,10 @@ typedef struct MinimapState {
     /* Track map data */
     TrackMap *track_map;
 
+    /* Screen-space outline batch built by minimap_draw_track */
+    s16     batch[MINIMAP_MAX_LOD_POINTS][2];
+    s32     batch_count;
+
 } MinimapState;
 
 /* Global minimap state */
@@ -156,6 +175,7 @@ void minimap_reset(void);
 s32 minimap_load_track(s32 track_id);
 void minimap_unload_track(void);
 void minimap_generate_from_checkpoints(void);
+s32 minimap_select_lod(void);
 
 /* Display control */
 void minimap_show(void);
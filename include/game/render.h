@@ -42,6 +42,20 @@
 #define GFX_POOL_SIZE       0x10000 /* 64KB display list pool */
 #define GFX_STACK_SIZE      0x0400  /* Matrix stack entries */
 #define GFX_VTX_CACHE_SIZE  32      /* Vertex cache size for F3DEX2 */
+#define GFX_MAX_VIEWS       4       /* Split-screen viewports per frame */
+#define GFX_ARENA_WARN_8THS 7       /* Near-full warning at 7/8 of a view's slice */
+#define GFX_ARENA_MAIN_8THS 4       /* Frame list (frame_start dl++ path) share */
+#define GFX_FRAME_TAIL      2       /* Frame list commands kept for frame_end */
+
+/* Sorted draw queue (render_object -> render_draw_flush) */
+#define RENDER_MAX_DRAWS    512     /* Draws per flush, all viewports */
+
+/* Materials: combine mode + render mode pairs */
+#define RENDER_MAT_SHADE        0   /* Untextured, opaque */
+#define RENDER_MAT_TEX          1   /* Textured, opaque */
+#define RENDER_MAT_SHADE_XLU    2   /* Untextured, translucent */
+#define RENDER_MAT_TEX_XLU      3   /* Textured, translucent */
+#define RENDER_NUM_MATERIALS    4
 
 /* Render priority (for sorting) */
 #define RENDER_PRI_BACKGROUND   0   /* Sky, far terrain */
@@ -81,6 +95,12 @@ typedef struct RenderObject {
     u8      alpha;              /* Alpha/translucency (0-255) */
     u8      priority;           /* Render priority */
     s16     sortOffset;         /* Z-sort offset for ordering */
+    f32     radius;             /* Bounding radius (0 = no LOD selection) */
+    s32     lod;                /* Current detail level (0 = full) */
+    Gfx     *dl;                /* Geometry display list (NULL = nothing to draw) */
+    Gfx     *lod_dl[3];         /* LOD 1-3 lists (NULL = use the next finer one) */
+    s16     texture;            /* render_set_texture_table index, -1 = none */
+    s16     mtx_slot;           /* Static matrix cache slot, -1 = per frame */
 } RenderObject;
 
 /**
@@ -125,6 +145,47 @@ typedef struct TextureInfo {
     u8      wrapT;              /* T-axis wrap mode */
 } TextureInfo;
 
+/*
+ * Display list arena telemetry, one record per split-screen mode
+ * (index = number of viewports - 1). High-water marks are in Gfx
+ * commands and are what the per-mode DL budget should be sized from.
+ */
+typedef struct GfxArenaStats {
+    u32     frames;                     /* Frames built in this mode */
+    u32     hwm_total;                  /* Peak commands in one frame */
+    u32     hwm_view[GFX_MAX_VIEWS];    /* Peak commands per viewport */
+    u32     last_view[GFX_MAX_VIEWS];   /* Commands in the last frame */
+    u32     warnings;                   /* Slices that crossed the warn mark */
+    u32     overflows;                  /* Allocations refused */
+    u32     overflow_cmds;              /* Commands refused */
+    u32     stalls;                     /* Frames started while the RDP held the buffer */
+} GfxArenaStats;
+
+/*
+ * Sorted draw telemetry for the last completed frame. "saved" counts
+ * state commands the flush did not emit because the previous draw had
+ * already set the same state.
+ */
+typedef struct RenderSortStats {
+    u32     frames;
+    u32     draws;              /* Draws emitted */
+    u32     combine_set;        /* G_SETCOMBINE emitted */
+    u32     combine_saved;
+    u32     mode_set;           /* Render mode (G_SETOTHERMODE_L) emitted */
+    u32     mode_saved;
+    u32     tex_loads;          /* Texture loads emitted */
+    u32     tex_saved;
+    u32     dropped;            /* Queue, matrix arena or DL slice full */
+    u32     shared;             /* Draws reusing another viewport's matrix */
+} RenderSortStats;
+
+/**
+ * Display list pressure hook - called from gfx_alloc_dl the first time a
+ * viewport's slice crosses the warn mark or refuses an allocation in a
+ * frame. Use it to shed detail for the following frames.
+ */
+typedef void (*GfxArenaFunc)(s32 view, u32 used, u32 capacity, s32 overflowed);
+
 /* ======================= GLOBAL VARIABLES ======================== */
 
 /* Current render state */
@@ -168,6 +229,53 @@ void render_frame_start(void);
  */
 void render_frame_end(void);
 
+/**
+ * render_frame_pressure - Scheduler pressure callback
+ * Latches the level; it is applied at the next render_frame_start.
+ * @param level OS_SC_PRESSURE_* level (0 = full quality)
+ * @param predicted Predicted RDP frame time (ticks)
+ * @param budget Frame budget (ticks)
+ */
+void render_frame_pressure(s32 level, u32 predicted, u32 budget);
+
+/**
+ * render_dl_pressure - Display list arena hook (see GfxArenaFunc)
+ * Raises the latched detail level one step for the next frame.
+ */
+void render_dl_pressure(s32 view, u32 used, u32 capacity, s32 overflowed);
+
+/**
+ * render_set_detail_level - Apply a quality level immediately
+ * Scales particle density, shadow coverage and fog/draw distance.
+ * @param level 0 (full) to 3 (minimum)
+ */
+void render_set_detail_level(s32 level);
+
+/* ---- Sorted Draws ---- */
+
+/**
+ * render_set_texture_table - Textures RenderObject.texture indexes
+ * @param table Texture descriptors (4, 8 or 16-bit texels)
+ * @param stream_ids Track texture id per entry for streamed (address 0)
+ *                   entries, -1 = none; NULL if none are streamed
+ * @param count Entries in table (at most 255)
+ */
+void render_set_texture_table(const TextureInfo *table, const s16 *stream_ids, s32 count);
+
+/**
+ * render_draw_flush - Sort queued draws and emit them
+ * Each draw goes to its viewport's display list slice. render_scene
+ * flushes the views it queues; render_frame_end flushes whatever is
+ * queued after it.
+ * @return Draws emitted
+ */
+s32 render_draw_flush(void);
+
+/**
+ * render_get_sort_stats - Draw sorting counters for the last frame
+ */
+RenderSortStats *render_get_sort_stats(void);
+
 /* ---- Display List Management (from gfx.c) ---- */
 
 /**
@@ -180,10 +288,73 @@ void gfx_init_dl(Gfx *start, Gfx *end);
 /**
  * gfx_alloc_dl - Allocate space in display list
  * @param size Number of Gfx commands to allocate
- * @return Pointer to allocated display list space
+ * @return Pointer to allocated display list space, or NULL if the
+ *         current viewport's slice is full (NON_MATCHING builds)
  */
 Gfx *gfx_alloc_dl(u32 size);
 
+/**
+ * gfx_arena_init - Set up the double-buffered display list arena
+ * @param buf0 First frame buffer
+ * @param buf1 Second frame buffer
+ * @param count Capacity of each buffer in Gfx commands
+ */
+void gfx_arena_init(Gfx *buf0, Gfx *buf1, u32 count);
+
+/**
+ * gfx_arena_begin_frame - Flip buffers and split the new one per viewport
+ * The buffer base holds the frame's own display list, written linearly
+ * from the returned pointer; viewport slices follow it.
+ * @param num_views Viewports this frame (1-4)
+ * @return Base of the frame's display list
+ */
+Gfx *gfx_arena_begin_frame(s32 num_views);
+
+/**
+ * gfx_arena_set_view - Direct gfx_alloc_dl at one viewport's slice
+ * @param view Viewport index
+ */
+void gfx_arena_set_view(s32 view);
+
+/**
+ * gfx_dl_free - Commands gfx_alloc_dl can still hand out
+ * @return Free commands in the current viewport's slice
+ */
+u32 gfx_dl_free(void);
+
+/**
+ * gfx_frame_reserve - Check frame list room before writing with dl++
+ * Keeps GFX_FRAME_TAIL commands back for frame_end's sync and end.
+ * @param cur Current frame list write pointer (*gfx_dl_ptr)
+ * @param size Commands about to be written
+ * @return 1 if they fit (always before gfx_arena_init), 0 if not
+ */
+s32 gfx_frame_reserve(Gfx *cur, u32 size);
+
+/**
+ * gfx_arena_end_frame - Close the frame and mark its buffer busy
+ * @param end Final write pointer of the frame's display list
+ *            (NULL if nothing was written from the base)
+ * @return Commands used this frame
+ */
+u32 gfx_arena_end_frame(Gfx *end);
+
+/**
+ * gfx_arena_retire - RDP finished the oldest submitted buffer
+ */
+void gfx_arena_retire(void);
+
+/**
+ * gfx_arena_set_callback - Install the pressure hook (NULL to clear)
+ */
+void gfx_arena_set_callback(GfxArenaFunc func);
+
+/**
+ * gfx_arena_get_stats - Telemetry for one split-screen mode
+ * @param num_views Viewports (1-4)
+ */
+GfxArenaStats *gfx_arena_get_stats(s32 num_views);
+
 /* ---- Scene Setup ---- */
 
 /**
@@ -212,6 +383,12 @@ void render_set_projection(f32 fovy, f32 aspect, f32 near, f32 far);
  */
 void render_set_camera(f32 eye[3], f32 target[3], f32 up[3]);
 
+/**
+ * render_update_frustum - Rebuild gFrustumPlanes from the camera and
+ * projection; called by render_set_camera and render_set_projection
+ */
+void render_update_frustum(void);
+
 /**
  * render_set_fog - Configure fog parameters
  * @param near Fog start distance
@@ -237,6 +414,40 @@ void render_set_fog(s32 near, s32 far, u8 r, u8 g, u8 b);
  */
 void render_object(RenderObject *obj);
 
+/**
+ * render_set_object_dl - Attach an object's geometry for one detail level
+ * @param lod 0 (full) to 3; render_object draws the list for the level
+ *            lod_select picked, or the next finer one that is set
+ */
+void render_set_object_dl(s32 objnum, s32 lod, Gfx *dl);
+
+/**
+ * render_place_object - Put an object at its world position, upright
+ * @param yaw Heading about the vertical axis (radians)
+ * @param radius Bounding radius for culling and LOD (0 = always drawn)
+ */
+void render_place_object(s32 objnum, const f32 pos[3], f32 yaw, f32 radius);
+
+/**
+ * render_set_object_texture - Texture an object draws with
+ * @param texture render_set_texture_table index, -1 = untextured
+ */
+void render_set_object_texture(s32 objnum, s32 texture);
+
+/**
+ * render_objects_views - Queue every render object for all viewports
+ *
+ * One traversal for split screen: one walk of the cull hierarchy gives
+ * every viewport that sees each object, its matrix and LOD are computed
+ * once, and a draw is queued for each of those viewports. Set up every
+ * viewport in the mask (cull_view_begin, render_set_projection,
+ * render_set_camera) first; render_scene does this each frame.
+ *
+ * @param view_mask Bit per viewport to draw
+ * @return Draws queued
+ */
+s32 render_objects_views(s32 view_mask);
+
 /**
  * render_scene_large - Render large scene geometry
  * Address: 0x80087A08 (10KB function)
@@ -249,7 +460,9 @@ void render_scene_large(void);
  * render_scene - Set up scene for rendering
  * Address: 0x800A04C4 (2.7KB function)
  *
- * Configures viewport, projection, and view matrices.
+ * Configures viewport, projection, and view matrices for each viewport
+ * (one per split-screen player) and queues what each one sees; split
+ * screen queues all viewports in one render_objects_views traversal.
  */
 void render_scene(void);
 
@@ -10,6 +10,7 @@
 
 #include "types.h"
 #include "game/physics.h"
+#include "game/structs.h"
 
 /* Road surface codes (from arcade road.h) */
 #define ROAD_ASPHALT    0   /* Normal road */
@@ -70,6 +71,39 @@ typedef struct RoadSegment {
     u16     checkpoint_id;      /* Associated checkpoint */
 } RoadSegment;
 
+/* Segment index limits */
+#define ROAD_MAX_SEGMENTS   1024    /* Segments indexed per track */
+#define ROAD_GRID_DIM       32      /* Grid cells per axis */
+#define ROAD_GRID_MAX_REFS  8192    /* Segment references across all cells */
+
+/* Precomputed segment data for point queries */
+typedef struct RoadSegInfo {
+    f32     start[3];           /* Centerline start */
+    f32     dir[3];             /* Unit centerline direction */
+    f32     length;             /* Centerline length (XY plane) */
+    f32     half_width;         /* Half road width */
+} RoadSegInfo;
+
+/* Segment index built at track load */
+typedef struct RoadSegIndex {
+    RoadSegInfo info[ROAD_MAX_SEGMENTS];
+    u16     cell_start[ROAD_GRID_DIM * ROAD_GRID_DIM + 1];  /* Offsets into refs */
+    u16     refs[ROAD_GRID_MAX_REFS];   /* Segment indices, grouped by cell */
+    f32     origin[2];          /* Grid minimum corner (XY) */
+    f32     inv_cell[2];        /* Cells per unit */
+    s32     num_segments;       /* Segments indexed */
+    s16     car_segment[MAX_CARS];  /* Last segment found per car */
+    u32     queries;            /* Point queries this track */
+    u32     cache_hits;         /* Queries answered by the car cache */
+    u32     segments_tested;    /* Candidate segments examined */
+} RoadSegIndex;
+
+/* Road table at the start of the track geometry section */
+typedef struct RoadGeometryHeader {
+    u32     num_segments;       /* RoadSegment records that follow */
+    f32     total_length;       /* Centerline length of one lap */
+} RoadGeometryHeader;
+
 /* Track data structure */
 typedef struct TrackData {
     s32         num_segments;       /* Total road segments */
@@ -84,7 +118,7 @@ typedef struct TrackData {
 } TrackData;
 
 /* Current track state */
-extern TrackData *gCurrentTrack;
+extern TrackData *gRoadTrack;
 extern s32 gTrackLoaded;
 
 /* Road system functions */
@@ -105,16 +139,35 @@ s32 road_is_boost_surface(u8 roadcode);
 s32 road_is_shortcut(u8 roadcode);
 
 /* Track loading */
-void road_load_track(s32 track_id);
+void road_load_segments(void *data, u32 size);
 void road_unload_track(void);
 TrackData* road_get_track_data(void);
 
 /* Track queries */
 f32 road_get_track_length(void);
 s32 road_get_segment_at_pos(f32 pos[3]);
+s32 road_get_car_segment(s32 car_index, f32 pos[3]);
+s32 road_get_car_direction(s32 car_index, f32 pos[3], f32 dir[3]);
+f32 road_get_car_width(s32 car_index, f32 pos[3]);
+void road_build_segment_index(void);
 void road_get_road_direction(f32 pos[3], f32 dir[3]);
 f32 road_get_road_width(f32 pos[3]);
 
+#ifdef HOST_BUILD
+/* Segment lookup benchmark results, ns per car query */
+typedef struct RoadBenchStats {
+    u32     queries;            /* Car positions answered per method */
+    u32     linear_ns;          /* Nearest centerline over every segment */
+    u32     grid_ns;            /* road_get_segment_at_pos */
+    u32     car_ns;             /* road_get_car_segment */
+    u32     cache_hits;         /* Car queries answered from the last segment */
+    u32     segments_tested;    /* Candidates examined, grid and car queries */
+    u32     mismatches;         /* Grid answers that differ from the linear scan */
+} RoadBenchStats;
+
+void road_index_bench(s32 segments, s32 frames, RoadBenchStats *out);
+#endif
+
 /* Arcade compatibility - init_road */
 void init_road(CarPhysics *m);
 
@@ -58,6 +58,11 @@
 #define OBJECT_SHADOW_SCALE     0.8f    /* Scale factor for object shadows */
 #define OBJECT_SHADOW_ALPHA     128     /* Base alpha for object shadows */
 
+/* Shadow quality (lowered under frame-time pressure) */
+#define SHADOW_QUALITY_FULL     0       /* All car shadows */
+#define SHADOW_QUALITY_LOCAL    1       /* Only cars with a local viewport */
+#define SHADOW_QUALITY_OFF      2       /* No car shadows */
+
 /* ======================= TYPEDEFS ======================== */
 
 /**
@@ -144,6 +149,21 @@ void shadow_update(s16 slot);
  */
 void shadow_remove(s16 slot);
 
+/**
+ * shadow_set_quality - Limit which cars get shadows
+ * @param quality SHADOW_QUALITY_* level
+ */
+void shadow_set_quality(s32 quality);
+
+/**
+ * shadow_set_tires - Record a car's tire positions for this frame
+ * @param slot Car slot index
+ * @param tirePos Tire positions
+ * @param airdist Distance from each tire to the road
+ * Also publishes the tire contacts to the ground cache (ground.h)
+ */
+void shadow_set_tires(s16 slot, f32 tirePos[4][3], f32 airdist[4]);
+
 /**
  * shadow_hide - Hide shadow temporarily
  * @param slot Car slot index
@@ -382,6 +382,7 @@ void sound_wparms(u16 cmd, s32 nargs, u16 *parms);
 /* Arcade-style sound function */
 void SOUND(u16 cmd);
 void SOUNDS(u16 cmd, s32 nargs, ...);
+void sound_exec(u16 cmd);
 
 /* Attract mode control */
 void set_attract_sound(s32 effects, s32 music);
@@ -464,6 +465,111 @@ s32 sndUpdateMoobEngine(u16 objID, u8 handle, u8 priority,
                         s32 x, s32 y,
                         u16 velocity, u16 vel_angle, u16 rpm, u16 etorque);
 
+/* ========================================================================
+ * Game -> audio command ring
+ *
+ * SOUND()/SOUNDS() and the per-handle snd* updates are staged on the
+ * game thread, coalesced (last update per handle wins), flushed into a
+ * lock-free SPSC ring once per game frame and drained once per audio
+ * frame.
+ * ======================================================================== */
+
+#define SND_CMD_RING_SIZE   64      /* Ring capacity (power of 2) */
+#define SND_CMD_STAGE_MAX   64      /* Commands staged per game frame */
+
+/* Command kinds */
+#define SNDCMD_SOUND        0       /* SOUND(cmd) - never coalesced */
+#define SNDCMD_POSITION     1       /* sndChangePosition */
+#define SNDCMD_PITCH        2       /* sndChangePitch */
+#define SNDCMD_MOOB_ENGINE  3       /* sndUpdateMoobEngine */
+#define SNDCMD_START        4       /* sndStart* - never coalesced */
+#define SNDCMD_KILL         5       /* sndKillMoob - never coalesced */
+#define SNDCMD_STOP         6       /* sound_stop/sound_stop_all - never coalesced */
+#define SNDCMD_NUM_KINDS    7
+#define SNDCMD_NONE         0xFF    /* Superseded while staged */
+
+/* SNDCMD_START/SNDCMD_STOP flags (SndCmd.pad) */
+#define SNDCMD_F_POSITIONAL 0x01
+#define SNDCMD_F_ALL        0x02    /* SNDCMD_STOP: every voice, not just id */
+
+typedef struct SndCmd {
+    u8      kind;               /* SNDCMD_* */
+    u8      handle;             /* Sound handle (coalescing key) */
+    u8      priority;
+    u8      pad;
+    u16     id;                 /* Sound command / object ID */
+    u16     pitch;              /* Pitch or engine RPM */
+    s32     x, y;               /* Position */
+    u16     velocity;
+    u16     vel_angle;
+    u16     etorque;
+    u8      volume;             /* SNDCMD_START volume (0-127) */
+    u8      pad2;
+} SndCmd;
+
+typedef struct SndCmdStats {
+    u32     issued;             /* Commands from game code */
+    u32     coalesced;          /* Absorbed by a later update to the same handle */
+    u32     queued;             /* Pushed into the ring */
+    u32     dropped;            /* Ring full at flush */
+    u32     drained;            /* Executed on the audio side */
+} SndCmdStats;
+
+void snd_cmd_init(void);
+void snd_cmd_flush(void);
+void snd_cmd_drain(void);
+SndCmdStats *snd_cmd_get_stats(void);
+
+/* ========================================================================
+ * Virtual voices
+ *
+ * Every requested sound gets a virtual voice scored by audible volume x
+ * priority. Only the top NUM_SFX_CHANNELS voices own a physical channel;
+ * the rest keep their clock running and are revived if they become
+ * audible enough again.
+ * ======================================================================== */
+
+#define SND_MAX_VOICES      48      /* Virtual voice table */
+#define SND_ONESHOT_FRAMES  120     /* One-shot lifetime until bank lengths are known */
+#define SND_REF_DIST        256.0f  /* Distance at which gain halves */
+#define SND_AUDIBLE_MIN     2       /* Below this a voice is inaudible */
+
+typedef struct SndVoice {
+    u16     sound_id;
+    u8      handle;             /* Moob handle (0 = anonymous one-shot) */
+    u8      priority;           /* Higher is more important */
+    u8      volume;             /* Requested volume (0-127) */
+    u8      audible;            /* Volume after distance falloff */
+    u8      flags;              /* SNDCMD_F_* */
+    s8      channel;            /* Physical channel, -1 if virtual */
+    u8      active;
+    u8      looping;
+    u16     pitch;
+    s32     x, y;               /* Source position */
+    u32     start_frame;        /* Audio frame the sound started */
+    u32     score;              /* audible * (priority + 1) */
+} SndVoice;
+
+typedef struct SndVoiceStats {
+    s32     voices;             /* Active virtual voices */
+    s32     physical;           /* ... of which own a channel */
+    s32     peak_voices;
+    s32     pressure_pct;       /* voices * 100 / channels */
+    u32     starts;
+    u32     rejected;           /* Voice table full, lower score than all */
+    u32     steals;             /* Channel taken by a higher score */
+    u32     revivals;           /* Virtual voice given a channel again */
+    u32     expired;            /* One-shots that finished */
+} SndVoiceStats;
+
+s32 snd_voice_start(u16 sound_id, u8 handle, u8 priority, u8 volume,
+                    s32 x, s32 y, s32 positional);
+void snd_voice_kill_handle(u8 handle);
+void snd_voice_stop_id(u16 sound_id);
+void snd_voice_stop_all(void);
+void snd_voice_update(void);
+SndVoiceStats *snd_voice_get_stats(void);
+
 /* ========================================================================
  * Additional Arcade Sound Constants (sounds.c/sounds.h)
  * ======================================================================== */
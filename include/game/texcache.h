@@ -0,0 +1,56 @@
+/**
+ * texcache.h - Track texture residency cache
+ *
+ * Track textures stay in ROM (optionally deflated) until drawn. A fixed
+ * pool of TMEM-sized RDRAM slots holds the decompressed copies; a miss
+ * DMAs and inflates the texture into a free slot or the least recently
+ * used one. Slots touched this frame or last frame are never evicted,
+ * since the display list the RDP is still reading may point at them.
+ *
+ * Each texture is registered with a mask of the track sections that use
+ * it (the lap split into TEXCACHE_SECTIONS equal runs of maxpath points).
+ * Every frame the cache prefetches a few textures for the section ahead
+ * of the local player's car, so most loads happen before they are drawn.
+ */
+
+#ifndef TEXCACHE_H
+#define TEXCACHE_H
+
+#include "types.h"
+
+#define TEXCACHE_MAX_TEXTURES   256     /* Texture ids (texture_params_setup range) */
+#define TEXCACHE_SLOT_SIZE      0x1000  /* One TMEM load (4KB) */
+#define TEXCACHE_MAX_SLOTS      32      /* Default budget: 128KB */
+#define TEXCACHE_SECTIONS       16      /* Lap split for prefetch */
+#define TEXCACHE_PREFETCH       2       /* Prefetch loads per frame */
+
+#define TEXCACHE_FLAG_COMPRESSED    (1 << 0)    /* Stored deflated in ROM */
+
+/* Counters for one lap */
+typedef struct TexCacheStats {
+    s32     lap;                /* Lap these counters cover */
+    u32     frames;
+    u32     hits;               /* texcache_get found it resident */
+    u32     misses;             /* ...loaded it on demand */
+    u32     prefetches;         /* Loaded ahead by section */
+    u32     evictions;
+    u32     refused;            /* No evictable slot */
+    u32     failed;             /* Image failed to inflate; unregistered */
+    u32     bytes_loaded;       /* ROM bytes DMAed */
+    u32     bytes_decompressed; /* Bytes inflated into slots */
+    u32     hit_pct;            /* hits / (hits + misses), set at lap end */
+} TexCacheStats;
+
+void texcache_init(void);
+void texcache_set_budget(s32 slots);
+void texcache_register(s32 id, u32 rom_addr, u32 rom_size, u32 ram_size,
+                       u32 flags, u16 section_mask);
+void texcache_flush(void);
+
+void texcache_frame(void);
+void *texcache_get(s32 id);
+s32  texcache_is_resident(s32 id);
+
+TexCacheStats *texcache_get_stats(s32 last_lap);
+
+#endif /* TEXCACHE_H */
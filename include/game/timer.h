@@ -31,6 +31,23 @@ void frame_time_update(void);
 f32  frame_time_get_delta(void);
 f32  frame_time_get_fps(void);
 
+/* Fixed-step physics (independent of render rate) */
+#define PHYSICS_HZ              60      /* Model substeps per second */
+#define PHYSICS_MAX_SUBSTEPS    6       /* Cap per frame (0.1s, matches delta clamp) */
+
+typedef struct FrameTimeStats {
+    u32     frames;             /* Render frames timed */
+    u32     substeps_total;     /* Physics substeps run */
+    s32     substeps_last;      /* Substeps due this frame */
+    s32     substeps_max;       /* Most substeps in one frame */
+    u32     idle_frames;        /* Frames with no substep (render ahead) */
+    u32     clamped_frames;     /* Frames that dropped time over the cap */
+} FrameTimeStats;
+
+s32  frame_time_physics_steps(void);
+f32  frame_time_get_alpha(void);
+FrameTimeStats *frame_time_get_stats(void);
+
 /******* ARCADE-COMPATIBLE TIMING FUNCTIONS *******/
 /* Based on arcade game/sselect.c timing system */
 /* Uses millisecond time base (ONE_SEC = 1000) */
@@ -75,6 +75,31 @@
 #define SURFACE_RAMP            7       /* Jump ramp */
 #define NUM_SURFACE_TYPES       8
 
+/* Track data sections (ROM track directory) */
+#define TRACK_SECTION_GEOMETRY      0   /* Display geometry */
+#define TRACK_SECTION_CHECKPOINTS   1   /* TrackCheckpoint records */
+#define TRACK_SECTION_MAXPATHS      2   /* MaxPathHeader + points, per path */
+#define TRACK_SECTION_BOOST_PADS    3   /* Boost pad records */
+#define TRACK_SECTION_RESPAWNS      4   /* Respawn points */
+#define TRACK_SECTION_TARGETS       5   /* Breakable/animated targets */
+#define TRACK_SECTION_TEXTURES      6   /* TrackTextureEntry records */
+#define NUM_TRACK_SECTIONS          7
+
+/* Track section flags */
+#define TRACK_SECTION_FLAG_COMPRESSED   (1 << 0)    /* Stored deflated in ROM */
+#define TRACK_SECTION_FLAG_CRITICAL     (1 << 1)    /* Needed before race start */
+
+/* Track directory */
+#define TRACK_DIR_MAGIC         0x54524B44  /* 'TRKD' */
+#define TRACK_DIR_VERSION       1
+#define TRACK_DIR_INDEX_ROM     0x00BFF000  /* Last 4 KB of the 12 MB cartridge */
+#define TRACK_DIR_INDEX_MAGIC   0x54524B49  /* 'TRKI' */
+#define TRACK_DMA_CHUNK         0x4000      /* Bytes per PI DMA request */
+#define TRACK_STREAM_BUDGET     0x10000     /* Bytes streamed per frame in-race */
+#define TRACK_MAX_TEXTURES      255         /* Render texture table entries */
+#define TRACK_OBJECT_LODS       4           /* Display lists per placed object */
+#define TRACK_OBJECT_NO_DL      0xFFFFFFFF  /* No list at this detail level */
+
 /* Checkpoint structure */
 typedef struct TrackCheckpoint {
     f32     pos[3];             /* Position */
@@ -167,6 +192,82 @@ typedef struct TrackTiming {
     s16     before_finish;      /* Checkpoint before finish */
 } TrackTiming;
 
+/* Track directory entry (ROM) */
+typedef struct TrackSectionEntry {
+    u32     rom_offset;         /* Offset from directory start */
+    u32     rom_size;           /* Bytes stored in ROM */
+    u32     ram_size;           /* Bytes after decompression */
+    u16     type;               /* TRACK_SECTION_* */
+    u16     flags;              /* TRACK_SECTION_FLAG_* */
+} TrackSectionEntry;
+
+/* Streamed texture record (TRACK_SECTION_TEXTURES) */
+typedef struct TrackTextureEntry {
+    s16     id;                 /* Track texture id (texture_data_array index) */
+    u16     sections;           /* Bit per lap section that draws it */
+    u32     rom_offset;         /* Offset from directory start */
+    u32     rom_size;           /* Bytes stored in ROM */
+    u32     ram_size;           /* Bytes after decompression */
+    u32     flags;              /* TEXCACHE_FLAG_* */
+    u16     width;              /* Texels */
+    u16     height;
+    u8      format;             /* G_IM_FMT_* */
+    u8      size;               /* G_IM_SIZ_* */
+    u8      wrapS;              /* G_TX_* wrap/mirror/clamp */
+    u8      wrapT;
+} TrackTextureEntry;
+
+/* Placed track object record (TRACK_SECTION_TARGETS) */
+typedef struct TrackObjectEntry {
+    s16     objnum;             /* Render object slot */
+    s16     defnum;             /* Model definition */
+    s16     texture;            /* TrackTextureEntry index, -1 = untextured */
+    u16     flags;              /* OBJ_FLAG_* */
+    f32     pos[3];             /* World position */
+    f32     yaw;                /* Heading about the vertical axis (radians) */
+    f32     radius;             /* Bounding radius, 0 = never culled */
+    u32     dl_offset[TRACK_OBJECT_LODS];   /* Into the geometry section */
+} TrackObjectEntry;
+
+/* Track directory header (ROM) */
+typedef struct TrackDirectory {
+    u32     magic;              /* TRACK_DIR_MAGIC */
+    u16     version;            /* TRACK_DIR_VERSION */
+    u16     num_sections;       /* Valid entries in sections[] */
+    TrackSectionEntry sections[NUM_TRACK_SECTIONS];
+} TrackDirectory;
+
+/* Per-track directory index (ROM, at TRACK_DIR_INDEX_ROM) */
+typedef struct TrackDirIndex {
+    u32     magic;              /* TRACK_DIR_INDEX_MAGIC */
+    u16     version;            /* TRACK_DIR_VERSION */
+    u16     num_tracks;         /* Valid entries in dir_rom_addr[] */
+    u32     dir_rom_addr[MAX_TRACKS];   /* TrackDirectory by track id, 0 = none */
+} TrackDirIndex;
+
+/* Section streaming state */
+typedef struct TrackStream {
+    TrackDirectory  dir;                /* Directory of track being streamed */
+    u32             dir_rom_addr;       /* ROM address of directory */
+    void            *section_data[NUM_TRACK_SECTIONS];  /* Resident data by type */
+    u32             section_size[NUM_TRACK_SECTIONS];   /* Resident size by type */
+    s8              order[NUM_TRACK_SECTIONS];  /* Directory index, critical first */
+    s8              cur;                /* Position in order[] being streamed */
+    u8              dma_busy;           /* PI DMA request in flight */
+    u8              active;             /* Stream has sections outstanding */
+    u8              *dest;              /* Buffer receiving current section */
+    u32             section_offset;     /* Bytes of current section received */
+    u32             chunk_size;         /* Size of in-flight DMA */
+    u32             bytes_total;        /* ROM bytes in all sections */
+    u32             bytes_done;         /* ROM bytes transferred so far */
+    u16             resident_mask;      /* Sections ready, by type bit */
+    u16             critical_mask;      /* Sections needed before racing */
+    u32             start_count;        /* osGetCount() at stream start */
+    u32             critical_count;     /* Cycles until critical sections ready */
+    u32             total_count;        /* Cycles until all sections ready */
+    u32             dma_requests;       /* PI DMA requests issued */
+} TrackStream;
+
 /* Track metadata */
 typedef struct TrackInfo {
     char    name[32];           /* Track display name */
@@ -250,6 +351,8 @@ typedef struct TrackManager {
     u8              load_progress;          /* Loading progress 0-100 */
     u8              pad;
 
+    TrackStream     stream;                 /* ROM section streaming */
+
 } TrackManager;
 
 /* Global track manager */
@@ -270,6 +373,25 @@ s32 track_load_stunt(s32 arena_id);
 void track_unload(void);
 s32 track_is_loaded(void);
 s32 track_get_load_progress(void);
+s32 track_stream_update(u32 byte_budget);
+void track_stream_frame(void);
+s32 track_section_is_resident(s32 section);
+void* track_get_section_data(s32 section, u32 *size);
+void track_get_load_bytes(u32 *done, u32 *total);
+
+#ifdef HOST_BUILD
+/* Loader benchmark results for one race track in a ROM image */
+typedef struct TrackLoadBenchStats {
+    s32     track_id;
+    u32     bytes;              /* ROM bytes in every section */
+    u32     dma_requests;       /* PI requests issued */
+    u32     critical_ns;        /* track_load, until critical sections are resident */
+    u32     total_ns;           /* ...plus the in-race pump until every section is */
+    u32     frames;             /* track_stream_frame calls after track_load */
+} TrackLoadBenchStats;
+
+s32 track_load_bench(const char *rom_path, TrackLoadBenchStats out[MAX_TRACKS]);
+#endif
 
 /* Track info access */
 TrackInfo* track_get_info(s32 track_id);
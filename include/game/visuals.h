@@ -16,13 +16,24 @@
 /* ======================= DEFINES ======================== */
 
 #define MAX_VISUALS         100     /* Max concurrent environmental visuals */
+#define ENV_MAX_TYPES       8       /* Environment update buckets (incl. overflow) */
+#define ENV_FAR_DIST        150.0f  /* Camera distance for throttled updates (ft) */
+#define ENV_SMOKE_EVERY     2       /* Far smoke advances every 2nd frame */
+#define ENV_SKID_EVERY      2       /* Far skid trails extend every 2nd frame */
+#define ENV_SPARK_EVERY     3       /* Far sparks flicker every 3rd frame */
 #define HULK_FRAME          7       /* Frame # in blast when car turns to hulk */
 #define BLAST_FRAMES        16      /* Number of frames in blast sequence */
 #define BLAST_HOLD          40      /* msecs to hold each frame of blast animation */
 #define SMOKE_FRAMES        16      /* Number of frames in smoke sequence */
 #define SMOKE_OBJS          (3 * SMOKE_FRAMES)  /* Number of smokes to keep predefined/tire */
+#define SMOKE_HOLD          40      /* msecs to hold each frame of smoke animation */
+#define SMOKE_INTERVAL      80      /* msecs between smoke puffs from one car */
 #define SKID_OBJS           100     /* Number of skids to keep predefined */
 #define SKID_DEVIATION      1.0f    /* Max deviation from straight skid allowed */
+#define NUM_QUADS           5       /* Body quads per car (4 corners + top) */
+#define QUAD_XLU_ALPHA      0x80    /* Quad alpha while the car is translucent */
+#define QUAD_VERTS          4       /* Vertices written per quad rebuild */
+#define QUAD_VTX_BYTES      (QUAD_VERTS * 16)   /* 16-byte N64 Vtx each */
 
 /* Visual control bits (used in Visual.data field) */
 #define VIS_BIT             0x10    /* Bit used in data field to indicate visibility */
@@ -91,6 +102,24 @@ struct NewSkid;
  */
 typedef void (*VisFunc)(struct Visual *v, s16 op);
 
+/**
+ * Environment batch update: every due visual of one type in one call
+ * @param vis Visuals to update
+ * @param count Number of visuals
+ */
+typedef void (*EnvBatchFunc)(struct Visual **vis, s32 count);
+
+/**
+ * Per-type environment update counts (last UpdateEnvirons)
+ */
+typedef struct EnvTypeStats {
+    VisFunc func;               /* Controller for this type */
+    s16     active;             /* Visuals of this type */
+    s16     updated;            /* Updated this frame */
+    s16     throttled;          /* Far, skipped this frame */
+    s16     pad;
+} EnvTypeStats;
+
 /**
  * Visual structure - Used for visual overlays of objects
  * Manages animated visual effects attached to cars
@@ -103,8 +132,24 @@ typedef struct Visual {
     u32     data;               /* Used to store arbitrary data */
     u32     timeStamp;          /* Used to set last time updated (IRQTIME) */
     VisFunc func;               /* Controller function */
+    u32     state;              /* Inputs the object was last rebuilt from */
+    u16     gen;                /* Bumped on every rebuild (0 = never) */
+    u8      dirty;              /* State changed, not rebuilt yet */
+    u8      pad;
 } Visual;
 
+/**
+ * Body quad rebuild counters for one frame
+ */
+typedef struct QuadStats {
+    u32     frames;
+    u32     updates;            /* AnimateQuad calls */
+    u32     rewrites;           /* Quads rebuilt */
+    u32     vtx_bytes;          /* Vertex bytes written by the rebuilds */
+    u32     reused;             /* Unchanged: last build kept */
+    u32     deferred;           /* Hidden: change left pending */
+} QuadStats;
+
 /**
  * Skid structure - Represents a completed skid mark on the ground
  * Managed in linked lists (gSkidFree and gSkidList)
@@ -299,6 +344,26 @@ void AddToEnvList(Visual *v);
  */
 void ReleaseEnviron(Visual *v, s32 unlink);
 
+/**
+ * SetEnvType - Configure batching/throttling for one controller
+ * @param func Controller function
+ * @param batch Batch update function, or NULL for func(v, 1) per visual
+ * @param every Update far visuals every Nth frame (1 = every frame)
+ */
+void SetEnvType(VisFunc func, EnvBatchFunc batch, s32 every);
+
+/**
+ * GetEnvStats - Per-type counts from the last UpdateEnvirons
+ * @param numTypes Output: number of entries
+ * @return Stats array (entry 0 = overflow bucket)
+ */
+EnvTypeStats *GetEnvStats(s32 *numTypes);
+
+/**
+ * GetQuadStats - Body quad rebuild counters for the last frame
+ */
+QuadStats *GetQuadStats(void);
+
 /* ---- Individual Visual Effects ---- */
 
 /**
@@ -379,6 +444,7 @@ void AnimateLSpark(Visual *v, s16 op);
 void AnimateRSpark(Visual *v, s16 op);
 void AnimateBSpark(Visual *v, s16 op);
 void AnimateSmoke(Visual *v, s16 op);
+void AnimateSkidTrail(Visual *v, s16 op);
 void AnimateTire(Visual *v, s16 op);
 void AnimateShadow(Visual *v, s16 op);
 void AnimateFrame(Visual *v, s16 op);
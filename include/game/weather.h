@@ -44,6 +44,12 @@
 #define MAX_PARTICLES           64      /* General particles */
 #define MAX_PUDDLES             16      /* Puddle reflections */
 #define MAX_LIGHTNING           4       /* Lightning flashes */
+#define WEATHER_MAX_VIEWS       4       /* Split-screen viewports */
+
+/* Camera-anchored rain volume (world units) */
+#define WEATHER_VOLUME_SIZE     400.0f  /* Box width/depth around camera */
+#define WEATHER_VOLUME_ABOVE    100.0f  /* Box top above camera */
+#define WEATHER_VOLUME_BELOW    50.0f   /* Box bottom below camera */
 
 /* Rain intensity levels */
 #define RAIN_NONE               0
@@ -72,6 +78,13 @@ typedef struct RainDrop {
     u8      pad[2];
 } RainDrop;
 
+/* Per-viewport rain volume */
+typedef struct WeatherVolume {
+    f32     min[3];             /* Box minimum corner (world space, follows the camera) */
+    s16     first;              /* First drop owned in rain[] */
+    s16     count;              /* Drops owned by this view */
+} WeatherVolume;
+
 /* General particle */
 typedef struct WeatherParticle {
     f32     pos[3];             /* Position */
@@ -178,6 +191,11 @@ typedef struct WeatherState {
     f32     rain_spawn_rate;    /* Drops per frame */
     f32     rain_spawn_accum;   /* Accumulator */
 
+    /* Camera-anchored rain volumes */
+    WeatherVolume volumes[WEATHER_MAX_VIEWS];
+    s32     num_views;          /* Viewports sharing the drop pool */
+    s32     rain_wraps;         /* Drops wrapped this frame */
+
     /* Particles */
     WeatherParticle particles[MAX_PARTICLES];
     s32     particle_count;
@@ -232,6 +250,9 @@ void weather_set_day_cycle(u8 enabled, f32 speed);
 void weather_set_rain(s32 intensity);
 void weather_spawn_rain(s32 count);
 void weather_clear_rain(void);
+void weather_set_views(s32 num_views);
+void weather_set_view_camera(s32 view, f32 *pos);
+void weather_fill_volumes(void);
 s32 weather_get_rain_intensity(void);
 
 /* Fog control */
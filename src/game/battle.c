@@ -23,6 +23,11 @@ extern u32 frame_counter;
 /* External math */
 extern f32 sqrtf(f32 x);
 
+#ifdef HOST_BUILD
+#include <string.h>
+#include <time.h>
+#endif
+
 /* Global battle state */
 BattleState gBattle;
 
@@ -140,6 +145,12 @@ void battle_reset(void) {
 
     gBattle.match_time = 0;
     gBattle.winner = -1;
+
+    /* Empty spatial hash */
+    gBattle.grid.num_ents = 0;
+    for (i = 0; i < BATTLE_GRID_BUCKETS; i++) {
+        gBattle.grid.head[i] = -1;
+    }
 }
 
 /**
@@ -221,6 +232,9 @@ void battle_update(void) {
             battle_update_mines();
             battle_update_pickups();
 
+            /* Bucket everything once, then run the checks against it */
+            battle_grid_build();
+
             /* Check all collisions */
             battle_check_projectile_hits();
             battle_check_mine_triggers();
@@ -236,6 +250,7 @@ void battle_update(void) {
             gBattle.match_time++;
             battle_update_players();
             battle_update_projectiles();
+            battle_grid_build();
             battle_check_projectile_hits();
             battle_check_win_condition();
             break;
@@ -912,6 +927,311 @@ void battle_trigger_mine(s32 index) {
     sound_play(SFX_CRASH_HEAVY);
 }
 
+/*
+ * ==========================================================================
+ * Spatial Hash
+ * ==========================================================================
+ *
+ * Every live player, projectile, mine and pickup is bucketed by its XZ cell
+ * once per frame. All proximity checks (and weapon targeting) query the hash
+ * instead of scanning every entity, and compare squared distances so no
+ * sqrtf is needed. Entries hold only kind/index; positions and liveness are
+ * read from gBattle at query time so mid-frame kills and pickups are seen.
+ */
+
+/**
+ * grid_cell - World coordinate to cell coordinate
+ */
+static s32 grid_cell(f32 v) {
+    s32 c = (s32)(v * (1.0f / BATTLE_GRID_CELL));
+
+    /* Truncation rounds toward zero; floor instead */
+    if (v < 0.0f && (f32)c * BATTLE_GRID_CELL != v) {
+        c--;
+    }
+    return c;
+}
+
+/**
+ * grid_bucket - Hash a cell into a bucket index
+ */
+static s32 grid_bucket(s32 cx, s32 cz) {
+    return (s32)(((u32)cx * 73856093u) ^ ((u32)cz * 19349663u)) & (BATTLE_GRID_BUCKETS - 1);
+}
+
+/**
+ * grid_ent_pos - Current position of a hashed entity
+ *
+ * @return Position, or NULL if the entity is no longer live
+ */
+static f32 *grid_ent_pos(s32 kind, s32 index) {
+    switch (kind) {
+        case BATTLE_ENT_PLAYER:
+            if (!gBattle.players[index].alive) {
+                return NULL;
+            }
+            return car_array[index].dr_pos;
+
+        case BATTLE_ENT_PROJECTILE:
+            if (!gBattle.projectiles[index].active) {
+                return NULL;
+            }
+            return gBattle.projectiles[index].pos;
+
+        case BATTLE_ENT_MINE:
+            if (!gBattle.mines[index].active) {
+                return NULL;
+            }
+            return gBattle.mines[index].pos;
+
+        case BATTLE_ENT_PICKUP:
+            if (!gBattle.pickups[index].active) {
+                return NULL;
+            }
+            return gBattle.pickups[index].pos;
+    }
+    return NULL;
+}
+
+/**
+ * grid_insert - Add one entity to the hash
+ */
+static void grid_insert(s32 kind, s32 index) {
+    BattleGrid *grid = &gBattle.grid;
+    BattleGridEnt *ent;
+    f32 *pos;
+    s32 bucket;
+
+    pos = grid_ent_pos(kind, index);
+    if (pos == NULL || grid->num_ents >= BATTLE_GRID_MAX_ENTS) {
+        return;
+    }
+
+    ent = &grid->ents[grid->num_ents];
+    ent->kind = (u8)kind;
+    ent->index = (u8)index;
+    ent->cell_x = (s16)grid_cell(pos[0]);
+    ent->cell_z = (s16)grid_cell(pos[2]);
+
+    bucket = grid_bucket(ent->cell_x, ent->cell_z);
+    ent->next = grid->head[bucket];
+    grid->head[bucket] = (s16)grid->num_ents;
+    grid->num_ents++;
+}
+
+/**
+ * battle_grid_build - Rebuild the spatial hash from current positions
+ *
+ * Called once per frame after movement, before the collision checks.
+ */
+void battle_grid_build(void) {
+    BattleGrid *grid = &gBattle.grid;
+    s32 i;
+
+    for (i = 0; i < BATTLE_GRID_BUCKETS; i++) {
+        grid->head[i] = -1;
+    }
+    grid->num_ents = 0;
+    grid->build_frame = frame_counter;
+    grid->queries = 0;
+    grid->candidates = 0;
+    grid->hits = 0;
+
+    for (i = 0; i < BATTLE_MAX_PLAYERS; i++) {
+        grid_insert(BATTLE_ENT_PLAYER, i);
+    }
+    for (i = 0; i < BATTLE_MAX_PROJECTILES; i++) {
+        grid_insert(BATTLE_ENT_PROJECTILE, i);
+    }
+    for (i = 0; i < BATTLE_MAX_MINES * BATTLE_MAX_PLAYERS; i++) {
+        grid_insert(BATTLE_ENT_MINE, i);
+    }
+    for (i = 0; i < BATTLE_MAX_PICKUPS; i++) {
+        grid_insert(BATTLE_ENT_PICKUP, i);
+    }
+}
+
+/**
+ * grid_scan_bucket - Collect hits from one bucket's chain
+ *
+ * Only entities whose cell lies in [cx0, cx1] x [cz0, cz1] are considered,
+ * which rejects hash aliases from cells outside the query.
+ *
+ * @return Updated hit count
+ */
+static s32 grid_scan_bucket(BattleGrid *grid, s32 bucket,
+                            s32 cx0, s32 cx1, s32 cz0, s32 cz1,
+                            f32 pos[3], f32 radius_sq, s32 kind_mask, s32 exclude_player,
+                            BattleGridHit *hits, s32 count, s32 max_hits) {
+    BattleGridEnt *ent;
+    s32 e;
+    f32 dx, dz, dist_sq;
+    f32 *epos;
+
+    for (e = grid->head[bucket]; e >= 0; e = ent->next) {
+        ent = &grid->ents[e];
+
+        /* Skip hash aliases from other cells and unwanted kinds */
+        if (ent->cell_x < cx0 || ent->cell_x > cx1 ||
+            ent->cell_z < cz0 || ent->cell_z > cz1) {
+            continue;
+        }
+        if (!(kind_mask & (1 << ent->kind))) {
+            continue;
+        }
+        if (ent->kind == BATTLE_ENT_PLAYER && ent->index == exclude_player) {
+            continue;
+        }
+
+        epos = grid_ent_pos(ent->kind, ent->index);
+        if (epos == NULL) {
+            continue;
+        }
+
+        grid->candidates++;
+        dx = epos[0] - pos[0];
+        dz = epos[2] - pos[2];
+        dist_sq = dx*dx + dz*dz;
+
+        if (dist_sq < radius_sq && count < max_hits) {
+            hits[count].kind = ent->kind;
+            hits[count].index = ent->index;
+            hits[count].dist_sq = dist_sq;
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * battle_grid_query_radius - Find live entities within an XZ radius
+ *
+ * If the hash has not been rebuilt this frame (e.g. targeting during the
+ * player update), the search is widened by one cell so entities that moved
+ * since the build are still found. A radius spanning at least as many
+ * cells as there are buckets (weapon targeting) walks each bucket once
+ * instead of revisiting aliased buckets cell by cell.
+ *
+ * @param pos Query position
+ * @param radius Search radius
+ * @param kind_mask Bitmask of (1 << BATTLE_ENT_*) kinds to return
+ * @param exclude_player Player index to skip (-1 for none)
+ * @param hits Output array
+ * @param max_hits Capacity of hits
+ * @return Number of hits written
+ */
+s32 battle_grid_query_radius(f32 pos[3], f32 radius, s32 kind_mask, s32 exclude_player,
+                             BattleGridHit *hits, s32 max_hits) {
+    BattleGrid *grid = &gBattle.grid;
+    s32 cx0, cx1, cz0, cz1, cx, cz;
+    s32 wx, wz, b, count;
+    f32 radius_sq;
+
+    grid->queries++;
+    radius_sq = radius * radius;
+    count = 0;
+
+    cx0 = grid_cell(pos[0] - radius);
+    cx1 = grid_cell(pos[0] + radius);
+    cz0 = grid_cell(pos[2] - radius);
+    cz1 = grid_cell(pos[2] + radius);
+    if (grid->build_frame != frame_counter) {
+        cx0--; cx1++;
+        cz0--; cz1++;
+    }
+
+    wx = cx1 - cx0 + 1;
+    wz = cz1 - cz0 + 1;
+    if (wx >= BATTLE_GRID_BUCKETS || wz >= BATTLE_GRID_BUCKETS ||
+        wx * wz >= BATTLE_GRID_BUCKETS) {
+        for (b = 0; b < BATTLE_GRID_BUCKETS; b++) {
+            count = grid_scan_bucket(grid, b, cx0, cx1, cz0, cz1, pos, radius_sq,
+                                     kind_mask, exclude_player, hits, count, max_hits);
+        }
+    } else {
+        for (cz = cz0; cz <= cz1; cz++) {
+            for (cx = cx0; cx <= cx1; cx++) {
+                count = grid_scan_bucket(grid, grid_bucket(cx, cz), cx, cx, cz, cz, pos,
+                                         radius_sq, kind_mask, exclude_player,
+                                         hits, count, max_hits);
+            }
+        }
+    }
+
+    grid->hits += count;
+    return count;
+}
+
+/**
+ * battle_grid_nearest - Find the nearest live entity of one kind
+ *
+ * @param pos Query position
+ * @param max_range Maximum XZ distance (exclusive)
+ * @param kind BATTLE_ENT_* kind
+ * @param exclude_player Player index to skip (-1 for none)
+ * @param dist_sq Output squared distance (may be NULL)
+ * @return Entity index, or -1 if none in range
+ */
+s32 battle_grid_nearest(f32 pos[3], f32 max_range, s32 kind, s32 exclude_player, f32 *dist_sq) {
+    BattleGridHit hits[BATTLE_GRID_MAX_HITS];
+    s32 count, i, best;
+
+    count = battle_grid_query_radius(pos, max_range, 1 << kind, exclude_player,
+                                     hits, BATTLE_GRID_MAX_HITS);
+    if (count == 0) {
+        return -1;
+    }
+
+    /* Ties go to the lower index, matching the old linear scans */
+    best = 0;
+    for (i = 1; i < count; i++) {
+        if (hits[i].dist_sq < hits[best].dist_sq ||
+            (hits[i].dist_sq == hits[best].dist_sq && hits[i].index < hits[best].index)) {
+            best = i;
+        }
+    }
+
+    if (dist_sq != NULL) {
+        *dist_sq = hits[best].dist_sq;
+    }
+    return hits[best].index;
+}
+
+/**
+ * grid_first_player - Lowest-indexed live player within radius
+ *
+ * Collision checks resolve in player order, so the lowest index wins
+ * when several players overlap the same entity.
+ *
+ * @param use_y Also require the 3D distance to be within radius
+ */
+static s32 grid_first_player(f32 pos[3], f32 radius, s32 exclude_player, s32 use_y) {
+    BattleGridHit hits[BATTLE_MAX_PLAYERS];
+    s32 count, i, player, best;
+    f32 dy;
+
+    count = battle_grid_query_radius(pos, radius, 1 << BATTLE_ENT_PLAYER, exclude_player,
+                                     hits, BATTLE_MAX_PLAYERS);
+    best = -1;
+
+    for (i = 0; i < count; i++) {
+        player = hits[i].index;
+
+        if (use_y) {
+            dy = car_array[player].dr_pos[1] - pos[1];
+            if (hits[i].dist_sq + dy*dy >= radius * radius) {
+                continue;
+            }
+        }
+
+        if (best < 0 || player < best) {
+            best = player;
+        }
+    }
+
+    return best;
+}
+
 /*
  * ==========================================================================
  * Collision Detection Functions
@@ -924,7 +1244,6 @@ void battle_trigger_mine(s32 index) {
 void battle_check_projectile_hits(void) {
     s32 i, j;
     BattleProjectile *proj;
-    f32 dx, dy, dz, dist;
 
     for (i = 0; i < BATTLE_MAX_PROJECTILES; i++) {
         proj = &gBattle.projectiles[i];
@@ -933,22 +1252,10 @@ void battle_check_projectile_hits(void) {
             continue;
         }
 
-        for (j = 0; j < BATTLE_MAX_PLAYERS; j++) {
-            if (j == proj->owner || !gBattle.players[j].alive) {
-                continue;
-            }
-
-            /* Distance check */
-            dx = car_array[j].dr_pos[0] - proj->pos[0];
-            dy = car_array[j].dr_pos[1] - proj->pos[1];
-            dz = car_array[j].dr_pos[2] - proj->pos[2];
-            dist = sqrtf(dx*dx + dy*dy + dz*dz);
-
-            if (dist < PROJECTILE_HIT_RADIUS) {
-                battle_damage_player(j, sWeaponProps[proj->type].damage, proj->owner);
-                battle_destroy_projectile(i);
-                break;
-            }
+        j = grid_first_player(proj->pos, PROJECTILE_HIT_RADIUS, proj->owner, 1);
+        if (j >= 0) {
+            battle_damage_player(j, sWeaponProps[proj->type].damage, proj->owner);
+            battle_destroy_projectile(i);
         }
     }
 }
@@ -957,9 +1264,8 @@ void battle_check_projectile_hits(void) {
  * battle_check_mine_triggers - Check if mines should explode
  */
 void battle_check_mine_triggers(void) {
-    s32 i, j;
+    s32 i;
     BattleMine *mine;
-    f32 dx, dz, dist;
 
     for (i = 0; i < BATTLE_MAX_MINES * BATTLE_MAX_PLAYERS; i++) {
         mine = &gBattle.mines[i];
@@ -968,19 +1274,8 @@ void battle_check_mine_triggers(void) {
             continue;
         }
 
-        for (j = 0; j < BATTLE_MAX_PLAYERS; j++) {
-            if (!gBattle.players[j].alive) {
-                continue;
-            }
-
-            dx = car_array[j].dr_pos[0] - mine->pos[0];
-            dz = car_array[j].dr_pos[2] - mine->pos[2];
-            dist = sqrtf(dx*dx + dz*dz);
-
-            if (dist < MINE_TRIGGER_RADIUS) {
-                battle_trigger_mine(i);
-                break;
-            }
+        if (grid_first_player(mine->pos, MINE_TRIGGER_RADIUS, -1, 0) >= 0) {
+            battle_trigger_mine(i);
         }
     }
 }
@@ -991,7 +1286,6 @@ void battle_check_mine_triggers(void) {
 void battle_check_pickup_collection(void) {
     s32 i, j;
     BattlePickup *pickup;
-    f32 dx, dz, dist;
 
     for (i = 0; i < BATTLE_MAX_PICKUPS; i++) {
         pickup = &gBattle.pickups[i];
@@ -1000,19 +1294,9 @@ void battle_check_pickup_collection(void) {
             continue;
         }
 
-        for (j = 0; j < BATTLE_MAX_PLAYERS; j++) {
-            if (!gBattle.players[j].alive) {
-                continue;
-            }
-
-            dx = car_array[j].dr_pos[0] - pickup->pos[0];
-            dz = car_array[j].dr_pos[2] - pickup->pos[2];
-            dist = sqrtf(dx*dx + dz*dz);
-
-            if (dist < PICKUP_COLLECT_RADIUS) {
-                battle_collect_pickup(j, i);
-                break;
-            }
+        j = grid_first_player(pickup->pos, PICKUP_COLLECT_RADIUS, -1, 0);
+        if (j >= 0) {
+            battle_collect_pickup(j, i);
         }
     }
 }
@@ -1325,6 +1609,226 @@ void battle_draw_results(void) {
     /* TODO: Draw final scores, winner announcement */
 }
 
+#ifdef HOST_BUILD
+/*
+ * ==========================================================================
+ * Host Benchmark
+ * ==========================================================================
+ */
+
+static u32 sBenchSeed;
+
+/**
+ * bench_rand - Uniform value in [-range, range)
+ */
+static f32 bench_rand(f32 range) {
+    sBenchSeed = sBenchSeed * 1103515245u + 12345u;
+    return ((f32)((sBenchSeed >> 8) & 0xFFFF) / 32768.0f - 1.0f) * range;
+}
+
+static s64 bench_ns(struct timespec *t0, struct timespec *t1) {
+    return (s64)(t1->tv_sec - t0->tv_sec) * 1000000000 + (t1->tv_nsec - t0->tv_nsec);
+}
+
+/**
+ * bench_near_player - Any live player within radius (brute force)
+ *
+ * @param use_y Also require the 3D distance to be within radius
+ */
+static s32 bench_near_player(f32 pos[3], f32 radius, s32 exclude_player, s32 use_y,
+                             u32 *tests) {
+    f32 dx, dy, dz, d;
+    s32 j;
+
+    for (j = 0; j < BATTLE_MAX_PLAYERS; j++) {
+        if (j == exclude_player || !gBattle.players[j].alive) {
+            continue;
+        }
+        (*tests)++;
+        dx = car_array[j].dr_pos[0] - pos[0];
+        dz = car_array[j].dr_pos[2] - pos[2];
+        d = dx*dx + dz*dz;
+        if (use_y) {
+            dy = car_array[j].dr_pos[1] - pos[1];
+            d += dy*dy;
+        }
+        if (d < radius * radius) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * bench_live - Live projectiles, mines and pickups
+ */
+static s32 bench_live(void) {
+    s32 i, n = 0;
+
+    for (i = 0; i < BATTLE_MAX_PROJECTILES; i++) {
+        n += gBattle.projectiles[i].active;
+    }
+    for (i = 0; i < BATTLE_MAX_MINES * BATTLE_MAX_PLAYERS; i++) {
+        n += gBattle.mines[i].active;
+    }
+    for (i = 0; i < BATTLE_MAX_PICKUPS; i++) {
+        n += gBattle.pickups[i].active;
+    }
+    return n;
+}
+
+/**
+ * battle_check_bench - Time one frame's collision checks (host)
+ *
+ * Each frame scatters the players over a 256 unit arena, fires the
+ * projectiles around random players, lays armed mines and fills every
+ * pickup, then runs the frame's checks twice: a brute-force pass testing
+ * each entity against every player, and battle_grid_build plus the four
+ * battle_check_* passes. Players are shielded so hits never kill or
+ * respawn anyone. Replaces the battle state.
+ *
+ * Counts are clamped to the tables; build battle.c with larger
+ * BATTLE_MAX_PLAYERS / BATTLE_MAX_PROJECTILES / BATTLE_MAX_MINES to
+ * bench bigger loads (8 players, 64 projectiles, 32 mines: 8, 64, 4).
+ *
+ * @param players Live players
+ * @param projectiles Live projectiles
+ * @param mines Armed mines
+ * @param frames Frames to run
+ * @param out Results
+ */
+void battle_check_bench(s32 players, s32 projectiles, s32 mines, s32 frames,
+                        BattleBenchStats *out) {
+    struct timespec t0, t1, t2;
+    BattlePlayer *p;
+    BattleProjectile *proj;
+    BattleMine *mine;
+    BattlePickup *pickup;
+    s32 f, i, j, expect, before;
+    u32 grid_tests;
+    s64 ns[3];
+
+    if (players < 1) {
+        players = 1;
+    } else if (players > BATTLE_MAX_PLAYERS) {
+        players = BATTLE_MAX_PLAYERS;
+    }
+    if (projectiles > BATTLE_MAX_PROJECTILES) {
+        projectiles = BATTLE_MAX_PROJECTILES;
+    }
+    if (mines > BATTLE_MAX_MINES * BATTLE_MAX_PLAYERS) {
+        mines = BATTLE_MAX_MINES * BATTLE_MAX_PLAYERS;
+    }
+
+    memset(out, 0, sizeof(*out));
+    memset(&gBattle, 0, sizeof(gBattle));
+    gBattle.state = BATTLE_STATE_ACTIVE;
+    gBattle.num_players = (u8)players;
+    sBenchSeed = 2049;
+    ns[0] = ns[1] = ns[2] = 0;
+    grid_tests = 0;
+
+    for (f = 0; f < frames; f++) {
+        for (i = 0; i < players; i++) {
+            p = &gBattle.players[i];
+            p->active = 1;
+            p->alive = 1;
+            p->health = BATTLE_MAX_HEALTH;
+            p->shield_timer = 1;
+            car_array[i].dr_pos[0] = bench_rand(128.0f);
+            car_array[i].dr_pos[1] = bench_rand(2.0f);
+            car_array[i].dr_pos[2] = bench_rand(128.0f);
+            car_array[i].mph = 0.0f;
+        }
+
+        gBattle.num_projectiles = projectiles;
+        for (i = 0; i < projectiles; i++) {
+            proj = &gBattle.projectiles[i];
+            j = (s32)(sBenchSeed >> 16) % players;
+            proj->active = 1;
+            proj->type = WEAPON_MISSILE;
+            proj->owner = (u8)((j + 1) % players);
+            proj->pos[0] = car_array[j].dr_pos[0] + bench_rand(12.0f);
+            proj->pos[1] = car_array[j].dr_pos[1] + bench_rand(2.0f);
+            proj->pos[2] = car_array[j].dr_pos[2] + bench_rand(12.0f);
+        }
+
+        gBattle.num_mines = mines;
+        for (i = 0; i < mines; i++) {
+            mine = &gBattle.mines[i];
+            mine->active = 1;
+            mine->armed = 1;
+            mine->owner = (u8)(i % players);
+            mine->pos[0] = bench_rand(128.0f);
+            mine->pos[1] = 0.0f;
+            mine->pos[2] = bench_rand(128.0f);
+        }
+
+        for (i = 0; i < BATTLE_MAX_PICKUPS; i++) {
+            pickup = &gBattle.pickups[i];
+            pickup->active = 1;
+            pickup->type = PICKUP_ARMOR;
+            pickup->pos[0] = bench_rand(128.0f);
+            pickup->pos[1] = 0.0f;
+            pickup->pos[2] = bench_rand(128.0f);
+        }
+
+        /* Brute force: what the checks should consume this frame */
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        expect = 0;
+        for (i = 0; i < projectiles; i++) {
+            proj = &gBattle.projectiles[i];
+            expect += bench_near_player(proj->pos, PROJECTILE_HIT_RADIUS, proj->owner, 1,
+                                        &out->brute_tests);
+        }
+        for (i = 0; i < mines; i++) {
+            expect += bench_near_player(gBattle.mines[i].pos, MINE_TRIGGER_RADIUS, -1, 0,
+                                        &out->brute_tests);
+        }
+        for (i = 0; i < BATTLE_MAX_PICKUPS; i++) {
+            expect += bench_near_player(gBattle.pickups[i].pos, PICKUP_COLLECT_RADIUS, -1, 0,
+                                        &out->brute_tests);
+        }
+        out->brute_tests += (u32)(players * (players - 1) / 2);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns[0] += bench_ns(&t0, &t1);
+
+        before = bench_live();
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        battle_grid_build();
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        battle_check_projectile_hits();
+        battle_check_mine_triggers();
+        battle_check_pickup_collection();
+        battle_check_player_collisions();
+        clock_gettime(CLOCK_MONOTONIC, &t2);
+        ns[1] += bench_ns(&t0, &t1);
+        ns[2] += bench_ns(&t1, &t2);
+
+        grid_tests += gBattle.grid.candidates;
+        out->hits += (u32)(before - bench_live());
+        if (before - bench_live() != expect) {
+            out->mismatches++;
+        }
+    }
+
+    out->frames = (u32)frames;
+    out->players = players;
+    out->projectiles = projectiles;
+    out->mines = mines;
+    out->pickups = BATTLE_MAX_PICKUPS;
+    if (frames > 0) {
+        out->brute_ns = (u32)(ns[0] / frames);
+        out->build_ns = (u32)(ns[1] / frames);
+        out->check_ns = (u32)(ns[2] / frames);
+        out->brute_tests /= (u32)frames;
+        out->grid_tests = grid_tests / (u32)frames;
+        out->hits /= (u32)frames;
+    }
+}
+#endif /* HOST_BUILD */
+
 #else /* !NON_MATCHING */
 
 /*
@@ -1364,6 +1868,10 @@ void battle_check_projectile_hits(void) {}
 void battle_check_mine_triggers(void) {}
 void battle_check_pickup_collection(void) {}
 void battle_check_player_collisions(void) {}
+void battle_grid_build(void) {}
+s32 battle_grid_query_radius(f32 pos[3], f32 radius, s32 kind_mask, s32 exclude_player,
+                             BattleGridHit *hits, s32 max_hits) { return 0; }
+s32 battle_grid_nearest(f32 pos[3], f32 max_range, s32 kind, s32 exclude_player, f32 *dist_sq) { return -1; }
 s32 battle_is_active(void) { return 0; }
 s32 battle_player_alive(s32 player) { return 0; }
 s32 battle_get_leader(void) { return 0; }
@@ -555,10 +555,32 @@ void boost_add_charge(s32 player) {
 
 /**
  * Load boost pads from track data
+ *
+ * @param track_data Boost pad section
+ * @param size Section size in bytes; a count claiming more records than
+ *             fit is cut back to the records present
  */
-void boost_load_pads(void *track_data) {
-    /* Track data format TBD - clear for now */
+void boost_load_pads(void *track_data, u32 size) {
+    BoostPadRecord *rec;
+    s32 count;
+    s32 i;
+
     boost_clear_pads();
+    if (track_data == NULL || size < sizeof(s32)) {
+        return;
+    }
+
+    /* Section layout: u32 count followed by count records */
+    count = *(s32 *)track_data;
+    rec = (BoostPadRecord *)((u8 *)track_data + sizeof(s32));
+    if ((u32)count > (size - sizeof(s32)) / sizeof(BoostPadRecord)) {
+        count = (s32)((size - sizeof(s32)) / sizeof(BoostPadRecord));
+    }
+
+    for (i = 0; i < count && i < MAX_BOOST_PADS; i++) {
+        boost_add_pad(rec[i].pos, rec[i].width, rec[i].length,
+                      rec[i].rotation, rec[i].multiplier);
+    }
 }
 
 /**
@@ -15,6 +15,8 @@
 #include "types.h"
 #include "game/camera.h"
 #include "game/structs.h"
+#include "game/car.h"
+#include "game/multiplayer.h"
 
 /* External declarations */
 extern u8 gstate;
@@ -28,6 +30,9 @@ extern f32 sqrtf(f32 x);
 extern f32 sinf(f32 x);
 extern f32 cosf(f32 x);
 
+/* Road segment index (road.c) */
+extern s32 road_get_car_direction(s32 car_index, f32 pos[3], f32 dir[3]);
+
 /* Global camera state */
 CameraData gCamera;
 f32 gCamPos[3];
@@ -40,6 +45,13 @@ static f32 cur_acc[3];               /* Acceleration offset for camera shake */
 static f32 old_vec0;                 /* Previous frame velocity for smoothing */
 static s32 view3_switch;             /* View 3 state */
 
+#ifdef NON_MATCHING
+/* Split screen: players 2-4's cameras (player 1's is gCamera) */
+static CameraData sViewCameras[MP_MAX_PLAYERS];
+static u8 sViewCameraLive[MP_MAX_PLAYERS];
+static void camera_update_views(void);
+#endif
+
 /* Arcade constants (from camera.c) */
 static const f32 acc_elasticity = 0.85f;    /* Lateral/longitudinal smoothing */
 static const f32 acc_elasticity2 = 0.35f;   /* Vertical smoothing (bouncier) */
@@ -161,20 +173,11 @@ void camera_set_mode(s32 mode) {
 }
 
 /**
- * camera_update - Per-frame camera update
- * Based on arcade: camera.c:UpdateCamera()
+ * camera_update_mode - Move gCamera for its view mode
+ *
+ * @param target Car the camera follows
  */
-void camera_update(void) {
-    s32 target = gCamera.target_car;
-
-    if (target < 0 || target >= num_active_cars) {
-        target = this_car;
-    }
-
-    /* Check for view change input */
-    camera_check_view_change();
-
-    /* Update based on current view mode */
+static void camera_update_mode(s32 target) {
     switch (gCamera.view) {
         case CAM_VIEW_WORM:
         case CAM_VIEW_CHASE:
@@ -197,6 +200,28 @@ void camera_update(void) {
             camera_update_chase(target);
             break;
     }
+}
+
+/**
+ * camera_update - Per-frame camera update
+ * Based on arcade: camera.c:UpdateCamera()
+ */
+void camera_update(void) {
+    s32 target = gCamera.target_car;
+
+    if (target < 0 || target >= num_active_cars) {
+        target = this_car;
+    }
+
+    /* Check for view change input */
+    camera_check_view_change();
+
+    /* Update based on current view mode */
+    camera_update_mode(target);
+
+#ifdef NON_MATCHING
+    camera_update_views();
+#endif
 
     /* Copy to global camera position */
     gCamPos[0] = gCamera.pos[0];
@@ -206,6 +231,88 @@ void camera_update(void) {
     gCamera.view_time++;
 }
 
+#ifdef NON_MATCHING
+/**
+ * camera_update_views - Update players 2-4's cameras in split screen
+ *
+ * Each camera is swapped through gCamera, with the hood shake kept in
+ * its acc[], so every view mode works unchanged. A camera joining starts
+ * as a copy of player 1's, moved onto its own car.
+ */
+static void camera_update_views(void) {
+    CameraData first;
+    f32 firstAcc[3];
+    MPPlayer *p;
+    s32 v, i, target;
+
+    if (!mp_is_split_screen()) {
+        for (v = 1; v < MP_MAX_PLAYERS; v++) {
+            sViewCameraLive[v] = 0;
+        }
+        return;
+    }
+
+    first = gCamera;
+    for (i = 0; i < 3; i++) {
+        firstAcc[i] = cur_acc[i];
+    }
+
+    for (v = 1; v < MP_MAX_PLAYERS; v++) {
+        p = &gMultiplayer.players[v];
+        if (!p->viewport.active) {
+            sViewCameraLive[v] = 0;
+            continue;
+        }
+        target = p->car_index;
+        if (target >= num_active_cars) {
+            continue;
+        }
+
+        if (!sViewCameraLive[v]) {
+            sViewCameras[v] = first;
+            for (i = 0; i < 3; i++) {
+                sViewCameras[v].pos[i] = car_array[target].dr_pos[i] + first.offset[i];
+                sViewCameras[v].acc[i] = 0.0f;
+            }
+            sViewCameras[v].view_time = 0;
+            sViewCameraLive[v] = 1;
+        }
+
+        gCamera = sViewCameras[v];
+        gCamera.target_car = target;
+        for (i = 0; i < 3; i++) {
+            cur_acc[i] = gCamera.acc[i];
+        }
+        camera_update_mode(target);
+        for (i = 0; i < 3; i++) {
+            gCamera.acc[i] = cur_acc[i];
+        }
+        gCamera.view_time++;
+        sViewCameras[v] = gCamera;
+    }
+
+    gCamera = first;
+    for (i = 0; i < 3; i++) {
+        cur_acc[i] = firstAcc[i];
+    }
+}
+
+/**
+ * camera_get_view - Camera for a split-screen viewport
+ * @param view Viewport (player) index; 0 is gCamera
+ * @return Camera, or NULL if that player has no camera this frame
+ */
+CameraData *camera_get_view(s32 view) {
+    if (view == 0) {
+        return &gCamera;
+    }
+    if (view < 0 || view >= MP_MAX_PLAYERS || !sViewCameraLive[view]) {
+        return NULL;
+    }
+    return &sViewCameras[view];
+}
+#endif
+
 /**
  * camera_check_view_change - Check for view change button press
  * Based on arcade: camera.c:CheckCameraView()
@@ -235,15 +342,24 @@ void camera_update_chase(s32 car_index) {
     f32 camera_pos[3];
     f32 dx, dy, dz;
     f32 elastic;
+    f32 *pos;
 
     car = &car_array[car_index];
     elastic = gCamera.elasticity;
 
+    /* Follow the transform the car is drawn with */
+    pos = car->dr_pos;
+#ifdef NON_MATCHING
+    if (car_get_display(car_index) != NULL) {
+        pos = car_get_display(car_index)->pos;
+    }
+#endif
+
     /* Calculate target camera position based on car position and offset */
     /* In arcade, this uses the car's orientation matrix to transform offset */
-    target_pos[0] = car->dr_pos[0] + gCamera.offset[0];
-    target_pos[1] = car->dr_pos[1] + gCamera.offset[1];
-    target_pos[2] = car->dr_pos[2] + gCamera.offset[2];
+    target_pos[0] = pos[0] + gCamera.offset[0];
+    target_pos[1] = pos[1] + gCamera.offset[1];
+    target_pos[2] = pos[2] + gCamera.offset[2];
 
     /* Apply elasticity (camera lag) */
     dx = target_pos[0] - gCamera.pos[0];
@@ -255,14 +371,14 @@ void camera_update_chase(s32 car_index) {
     gCamera.pos[2] += dz * (1.0f - elastic);
 
     /* Camera always looks at car position */
-    gCamera.target[0] = car->dr_pos[0];
-    gCamera.target[1] = car->dr_pos[1] + 2.0f;  /* Slightly above car */
-    gCamera.target[2] = car->dr_pos[2];
+    gCamera.target[0] = pos[0];
+    gCamera.target[1] = pos[1] + 2.0f;  /* Slightly above car */
+    gCamera.target[2] = pos[2];
 
     /* Update last car position */
-    last_car_pos[0] = car->dr_pos[0];
-    last_car_pos[1] = car->dr_pos[1];
-    last_car_pos[2] = car->dr_pos[2];
+    last_car_pos[0] = pos[0];
+    last_car_pos[1] = pos[1];
+    last_car_pos[2] = pos[2];
 }
 
 /**
@@ -772,7 +888,7 @@ void init_maxpath_cam(void) {
 void maxpath_cam(s16 mode, f32 pos[3], f32 uvs[3][3]) {
     static f32 cam_pos[3], delta[3];
     static s16 count;
-    f32 res[3], new_pos[3];
+    f32 res[3], new_pos[3], dir[3];
     s32 i;
 
     if (mode == 0) {  /* Initialize */
@@ -780,11 +896,17 @@ void maxpath_cam(s16 mode, f32 pos[3], f32 uvs[3][3]) {
     } else {
         if (count == 0) {
             count = 2;
-            /* Would get position from maxpath here */
             for (i = 0; i < 3; i++) {
                 cam_pos[i] = pos[i];
                 new_pos[i] = pos[i];
             }
+
+            /* Move ahead along the road (world x, y, z are display z, x, -y) */
+            if (road_get_car_direction(this_car, car_array[this_car].RWR, dir) >= 0) {
+                new_pos[0] += dir[1] * 40.0f;
+                new_pos[1] -= dir[2] * 40.0f;
+                new_pos[2] += dir[0] * 40.0f;
+            }
             cam_pos[1] += 10.0f;
             new_pos[1] += 10.0f;
 
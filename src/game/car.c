@@ -7,6 +7,11 @@
 
 #include "game/car.h"
 #include "game/math.h"
+#include "PR/os_thread.h"
+#include "PR/os_message.h"
+#include "game/physics.h"
+#include "game/structs.h"
+#include "game/timer.h"
 
 /* ========================================================================
  * TORQUE CURVES
@@ -977,6 +982,93 @@ s32 CheckAutoShift(s32 car_index, f32 angvel, s32 current_gear) {
 static s16 sModelRun = 0;
 static s32 sLastMTime = 0;
 
+#ifdef NON_MATCHING
+/*
+ * Model/render pipeline. The model runs at a fixed PHYSICS_HZ on its own
+ * thread and publishes a double-buffered snapshot: while the game and
+ * render threads consume frame N's snapshot, the model thread fills the
+ * back buffer with frame N+1. Each car keeps its transform from before
+ * and after the last substep. car_array gets the latest model state, which
+ * simulation reads; the render-only sCarDisplay gets the two blended by
+ * frame_time_get_alpha().
+ *
+ * While a batch is in flight the model thread owns model[]. What it needs
+ * from the game side (which cars run, the local player's slot) is copied
+ * into the target snapshot's inputs before the kick, while the model
+ * thread is idle; drone controls are generated on the game thread then
+ * too, from the car_array state the game side owns.
+ */
+typedef struct ModelInput {
+    s16     in_game;            /* Step this car */
+    s16     we_control;         /* Drone driven by this node */
+} ModelInput;
+
+typedef struct ModelSnapCar {
+    f32     prev_pos[3];
+    f32     prev_uvs[3][3];
+    f32     cur_pos[3];
+    f32     cur_uvs[3][3];
+    f32     vel[3];             /* World velocity (ft/sec) */
+    f32     tire_pos[4][3];     /* Tire centres after the last substep */
+    f32     mph;                /* Speedometer input for the HUD */
+    s16     rpm;                /* Tach/engine sound input */
+    s16     valid;              /* cur_* captured at least once */
+} ModelSnapCar;
+
+typedef struct ModelSnapshot {
+    u32             steps;      /* Model substeps completed when taken */
+    s32             player;     /* Local player's slot for this batch */
+    ModelInput      in[MAX_LINKS];  /* Inputs the batch ran on */
+    ModelSnapCar    car[MAX_LINKS];
+} ModelSnapshot;
+
+#define MODEL_THREAD_ID     9
+/*
+ * Audio is 3, the game thread 5, render 7. The idle thread spins at 2, so
+ * anything at 2 or below never runs. 3 is the only level below the game
+ * thread that does not preempt audio: equal priorities never preempt, so
+ * a woken audio thread waits at most for the current model batch.
+ */
+#define MODEL_THREAD_PRI    3
+#define MODEL_STACK_SIZE    0x1000
+#define FPS_TO_MPH          (3600.0f / 5280.0f)
+
+static ModelSnapshot sModelSnap[2];
+static s32 sModelSnapFront;             /* Snapshot the game side reads */
+static ModelSnapCar sModelWork[MAX_LINKS];  /* Model thread's running state */
+static CarDisplay sCarDisplay[MAX_LINKS];   /* Interpolated, render only */
+static u32 sModelSteps;                 /* Substeps run since init */
+
+static OSThread sModelThread;
+static u64 sModelThreadStack[MODEL_STACK_SIZE / sizeof(u64)];
+static OSMesgQueue sModelGoQueue;
+static OSMesgQueue sModelDoneQueue;
+static OSMesg sModelGoBuf[1];
+static OSMesg sModelDoneBuf[1];
+static s32 sModelThreadStarted;
+static s32 sModelThreaded;              /* Pipeline enabled */
+static s32 sModelInFlight;              /* Kick sent, done not yet received */
+
+static ModelPipeStats sModelPipeStats;
+static u32 sModelLastFrameCount;
+
+extern u32 osGetCount(void);
+extern s32 gThisNode;
+extern void MaxPathControls(s32 car_index);
+extern f32 replay_start(f32 x, f32 z);      /* Full ground query (game.c) */
+extern void ground_cache_begin_frame(void); /* ground.c */
+extern void shadow_set_tires(s16 slot, f32 tirePos[4][3], f32 airdist[4]);
+
+static void model_gather_inputs(ModelSnapshot *snap);
+static void model_run_steps(s32 steps, ModelSnapshot *snap);
+static void model_pipe_sync(void);
+static void model_pipe_kick(void);
+static void model_pipe_time_frame(void);
+static void car_interp_capture(s32 slot);
+static void car_interp_apply(s32 slot, f32 alpha);
+static void car_publish_tires(s32 slot);
+#endif
+
 /**
  * Initialize car model for race start or resurrection
  * mode: Initialize (0) = race start, Do_it (1) = respawn
@@ -997,12 +1089,32 @@ void Init_MDrive(s16 mode, s16 drone_index) {
  * Handles controls, physics, and model synchronization
  */
 void Update_MDrive(void) {
+#ifdef NON_MATCHING
+    /* Work out how many fixed model substeps this render frame owes */
+    frame_time_update();
+    model_pipe_time_frame();
+
+    /* Collect the model's last batch before touching its inputs */
+    model_pipe_sync();
+#endif
+
     /* Read control inputs */
     ReadGasAndBrake();
 
     /* Check resurrection state */
     check_if_finished_resurrecting();
 
+#ifdef NON_MATCHING
+    /* Start the next batch; it runs while this frame renders */
+    if (sModelThreaded) {
+        model_gather_inputs(&sModelSnap[sModelSnapFront ^ 1]);
+        model_pipe_kick();
+    } else {
+        model_gather_inputs(&sModelSnap[sModelSnapFront]);
+        model_iteration();
+    }
+#endif
+
     /* Update communication with model */
     multicomm();
 
@@ -1034,6 +1146,22 @@ void init_cars(void) {
  */
 void init_model_task(void) {
     sLastMTime = 0;
+
+#ifdef NON_MATCHING
+    {
+        s32 i;
+
+        model_pipe_sync();
+        for (i = 0; i < MAX_LINKS; i++) {
+            sModelWork[i].valid = 0;
+            sModelSnap[0].car[i].valid = 0;
+            sModelSnap[1].car[i].valid = 0;
+        }
+        sModelSteps = 0;
+        frame_time_init();
+        model_pipe_enable(1);
+    }
+#endif
 }
 
 /**
@@ -1045,7 +1173,221 @@ void model_iteration(void) {
     }
 
 #ifdef NON_MATCHING
-    /* TODO: update_player_model, update_drone_models */
+    /* Inline (unpipelined) model: results are visible this frame */
+    model_run_steps(frame_time_physics_steps(), &sModelSnap[sModelSnapFront]);
+#endif
+}
+
+#ifdef NON_MATCHING
+/**
+ * Copy the game side's model inputs into a snapshot (model thread idle)
+ *
+ * Drone controls are generated here, once per frame, rather than inside
+ * the batch: MaxPathControls reads car_array, which the game thread
+ * rewrites while the batch runs.
+ */
+static void model_gather_inputs(ModelSnapshot *snap) {
+    CarPhysics *m;
+    s32 slot;
+
+    snap->player = gThisNode;
+    for (slot = 0; slot < MAX_LINKS; slot++) {
+        m = &model[slot];
+        snap->in[slot].in_game = m->in_game;
+        snap->in[slot].we_control = m->we_control;
+        if (slot != gThisNode && m->in_game && m->we_control) {
+            MaxPathControls(slot);
+        }
+    }
+}
+
+/**
+ * Run a batch of fixed model substeps and publish them to a snapshot
+ *
+ * @param steps Substeps owed (zero, one or several depending on render rate)
+ * @param snap Snapshot to fill
+ */
+static void model_run_steps(s32 steps, ModelSnapshot *snap) {
+    ModelSnapCar *sc;
+    CarPhysics *m;
+    s32 step, slot, i;
+
+    if (sModelRun == 0) {
+        return;
+    }
+
+    for (step = 0; step < steps; step++) {
+        sModelSteps++;
+        sLastMTime = (s32)(sModelSteps * ONE_SEC / PHYSICS_HZ);
+
+        /* Player first, then the drones this node drives (the arcade's
+         * update_player_model/update_drone_models, on the snapshot) */
+        if (snap->player >= 0 && snap->player < MAX_LINKS &&
+            snap->in[snap->player].in_game) {
+            update_model(snap->player, sLastMTime);
+        }
+        for (slot = 0; slot < MAX_LINKS; slot++) {
+            if (slot != snap->player && snap->in[slot].in_game &&
+                snap->in[slot].we_control) {
+                update_model(slot, sLastMTime);
+            }
+        }
+
+        for (slot = 0; slot < MAX_LINKS; slot++) {
+            car_interp_capture(slot);
+        }
+    }
+
+    snap->steps = sModelSteps;
+    for (slot = 0; slot < MAX_LINKS; slot++) {
+        sc = &snap->car[slot];
+        m = &model[slot];
+        *sc = sModelWork[slot];
+        sc->vel[0] = m->RWV[0];
+        sc->vel[1] = m->RWV[1];
+        sc->vel[2] = m->RWV[2];
+        for (i = 0; i < 4; i++) {
+            body_to_rw(m->TIRER[i], sc->tire_pos[i], &m->UV);
+            sc->tire_pos[i][0] += m->RWR[0];
+            sc->tire_pos[i][1] += m->RWR[1];
+            sc->tire_pos[i][2] += m->RWR[2];
+        }
+        sc->mph = m->magvel * FPS_TO_MPH;
+        sc->rpm = (s16)m->rpm;
+    }
+}
+
+/**
+ * Model thread - one batch of substeps per kick from the game thread
+ */
+static void model_thread_proc(void *arg) {
+    OSMesg msg;
+
+    for (;;) {
+        osRecvMesg(&sModelGoQueue, &msg, OS_MESG_BLOCK);
+        model_run_steps((s32)(intptr_t)msg, &sModelSnap[sModelSnapFront ^ 1]);
+        osSendMesg(&sModelDoneQueue, NULL, OS_MESG_BLOCK);
+    }
+}
+
+/**
+ * Wait for the outstanding batch and flip it to the front
+ */
+static void model_pipe_sync(void) {
+    u32 start, wait;
+
+    if (!sModelInFlight) {
+        return;
+    }
+
+    start = osGetCount();
+    osRecvMesg(&sModelDoneQueue, NULL, OS_MESG_BLOCK);
+    wait = osGetCount() - start;
+
+    sModelInFlight = 0;
+    sModelSnapFront ^= 1;
+
+    sModelPipeStats.sync_wait_last = wait;
+    if (wait > sModelPipeStats.sync_wait_max) {
+        sModelPipeStats.sync_wait_max = wait;
+    }
+}
+
+/**
+ * Hand this frame's substeps to the model thread
+ */
+static void model_pipe_kick(void) {
+    osSendMesg(&sModelGoQueue, (OSMesg)(intptr_t)frame_time_physics_steps(), OS_MESG_BLOCK);
+    sModelInFlight = 1;
+}
+
+/**
+ * Track Update_MDrive() interval mean and variance (1/16 EWMA)
+ */
+static void model_pipe_time_frame(void) {
+    u32 now = osGetCount();
+    f32 interval, diff;
+
+    if (sModelPipeStats.frames != 0) {
+        interval = (f32)(now - sModelLastFrameCount);
+        if (sModelPipeStats.frames == 1) {
+            sModelPipeStats.interval_mean = interval;
+        }
+        diff = interval - sModelPipeStats.interval_mean;
+        sModelPipeStats.interval_mean += diff * (1.0f / 16.0f);
+        sModelPipeStats.interval_var += (diff * diff - sModelPipeStats.interval_var) * (1.0f / 16.0f);
+    }
+    sModelLastFrameCount = now;
+    sModelPipeStats.frames++;
+}
+#endif
+
+/**
+ * Switch between the pipelined model thread and inline model updates
+ *
+ * @param enable Nonzero to run the model on its own thread
+ */
+void model_pipe_enable(s32 enable) {
+#ifdef NON_MATCHING
+    model_pipe_sync();
+
+    if (enable && !sModelThreadStarted) {
+        osCreateMesgQueue(&sModelGoQueue, sModelGoBuf, 1);
+        osCreateMesgQueue(&sModelDoneQueue, sModelDoneBuf, 1);
+        osCreateThread(&sModelThread, MODEL_THREAD_ID, model_thread_proc, NULL,
+                       (u8 *)sModelThreadStack + MODEL_STACK_SIZE, MODEL_THREAD_PRI);
+        osStartThread(&sModelThread);
+        sModelThreadStarted = 1;
+    }
+
+    sModelThreaded = enable ? 1 : 0;
+    sModelPipeStats.threaded = sModelThreaded;
+    sModelPipeStats.sync_wait_max = 0;
+    sModelPipeStats.frames = 0;
+    sModelPipeStats.interval_mean = 0.0f;
+    sModelPipeStats.interval_var = 0.0f;
+#endif
+}
+
+#if defined(HOST_BUILD) && defined(NON_MATCHING)
+/**
+ * Measure frame interval jitter inline and pipelined (host)
+ *
+ * Runs the same frame loop twice, model inline and then on its thread.
+ * render stands in for the frame's wait on the RCP and should block, not
+ * spin. Call from a thread at the game thread's priority so the model
+ * thread only gets the CPU in those waits. Cars to step must already be
+ * in_game.
+ *
+ * @param frames Frames per run
+ * @param render Stand-in render work, called once per frame
+ * @param out Stats per run: [0] inline, [1] pipelined
+ */
+void model_pipe_bench(s32 frames, void (*render)(void), ModelPipeStats out[2]) {
+    s32 run, i;
+
+    sModelRun = 1;
+    for (run = 0; run < 2; run++) {
+        frame_time_init();
+        model_pipe_enable(run);
+        for (i = 0; i < frames; i++) {
+            Update_MDrive();
+            render();
+        }
+        model_pipe_sync();
+        out[run] = sModelPipeStats;
+    }
+}
+#endif
+
+/**
+ * Get model pipeline statistics (frame interval jitter, sync waits)
+ */
+ModelPipeStats *model_pipe_get_stats(void) {
+#ifdef NON_MATCHING
+    return &sModelPipeStats;
+#else
+    return NULL;
 #endif
 }
 
@@ -1084,34 +1426,154 @@ void communication(void) {
  */
 void update_game_data(void) {
 #ifdef NON_MATCHING
-    /* TODO: Dead reckon all cars, copy to game_car */
+    s32 slot;
+    f32 alpha;
+
+    /* TODO: Dead reckon linked cars */
+
+    /* Latest model state for the game, blended transform for rendering */
+    alpha = frame_time_get_alpha();
+    ground_cache_begin_frame();
+    for (slot = 0; slot < MAX_LINKS; slot++) {
+        car_interp_apply(slot, alpha);
+        car_publish_tires(slot);
+    }
 #endif
 }
 
+#ifdef NON_MATCHING
 /**
- * Update player's car model
+ * Record a car's model transform after a substep
  */
-void update_player_model(s32 curtime) {
-#ifdef NON_MATCHING
-    /* TODO: sym() call, steering force */
-#endif
+static void car_interp_capture(s32 slot) {
+    ModelSnapCar *ci = &sModelWork[slot];
+    CarPhysics *m = &model[slot];
+    s32 i, j;
+
+    for (i = 0; i < 3; i++) {
+        ci->prev_pos[i] = ci->valid ? ci->cur_pos[i] : m->RWR[i];
+        ci->cur_pos[i] = m->RWR[i];
+        for (j = 0; j < 3; j++) {
+            ci->prev_uvs[i][j] = ci->valid ? ci->cur_uvs[i][j] : m->UV.fpuvs[i][j];
+            ci->cur_uvs[i][j] = m->UV.fpuvs[i][j];
+        }
+    }
+    ci->valid = 1;
+}
+
+/**
+ * Copy a car's front-snapshot state into car_array and blend its last two
+ * model transforms into the render-only display transform
+ *
+ * Orientation rows are lerped and renormalized; one substep of rotation
+ * is small enough that this stays visually orthonormal.
+ */
+static void car_interp_apply(s32 slot, f32 alpha) {
+    ModelSnapCar *ci = &sModelSnap[sModelSnapFront].car[slot];
+    CarData *car = &car_array[slot];
+    CarDisplay *d = &sCarDisplay[slot];
+    f32 len;
+    s32 i, j;
+
+    if (!ci->valid) {
+        return;
+    }
+
+    for (i = 0; i < 3; i++) {
+        car->dr_pos[i] = ci->cur_pos[i];
+        car->dr_vel[i] = ci->vel[i];
+        d->pos[i] = ci->prev_pos[i] + (ci->cur_pos[i] - ci->prev_pos[i]) * alpha;
+    }
+    car->mph = ci->mph;
+    car->rpm = ci->rpm;
+    for (i = 0; i < 4; i++) {
+        car->dr_tirepos[i][0] = ci->tire_pos[i][0];
+        car->dr_tirepos[i][1] = ci->tire_pos[i][1];
+        car->dr_tirepos[i][2] = ci->tire_pos[i][2];
+    }
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            car->dr_uvs[i][j] = ci->cur_uvs[i][j];
+            d->uvs[i][j] = ci->prev_uvs[i][j] +
+                           (ci->cur_uvs[i][j] - ci->prev_uvs[i][j]) * alpha;
+        }
+        len = d->uvs[i][0] * d->uvs[i][0] +
+              d->uvs[i][1] * d->uvs[i][1] +
+              d->uvs[i][2] * d->uvs[i][2];
+        if (len > 0.0001f) {
+            len = 1.0f / sqrtf(len);
+            d->uvs[i][0] *= len;
+            d->uvs[i][1] *= len;
+            d->uvs[i][2] *= len;
+        }
+    }
+}
+
+/**
+ * Resolve a car's tire contacts against the ground and hand them to the
+ * shadow, which also publishes them to the ground cache
+ *
+ * Runs once per frame on the game thread, after car_interp_apply, so the
+ * contacts match the dr_tirepos the game reads this frame. airdist is the
+ * tire centre's height over the full ground query at the same (x, z), so
+ * the cached grid agrees with every later uncached query.
+ */
+static void car_publish_tires(s32 slot) {
+    CarData *car = &car_array[slot];
+    f32 airdist[4];
+    s32 i;
+
+    if (!sModelSnap[sModelSnapFront].car[slot].valid || !model[slot].in_game) {
+        return;
+    }
+
+    for (i = 0; i < 4; i++) {
+        airdist[i] = car->dr_tirepos[i][1] -
+                     replay_start(car->dr_tirepos[i][0], car->dr_tirepos[i][2]);
+    }
+    shadow_set_tires((s16)slot, car->dr_tirepos, airdist);
 }
+#endif
 
 /**
- * Update drone car models
+ * Get a car's render transform
+ *
+ * Non-matching builds return the transform blended between model
+ * substeps; matching builds have none, and the caller uses dr_pos/dr_uvs.
  */
-void update_drone_models(s32 curtime) {
+CarDisplay *car_get_display(s32 slot) {
 #ifdef NON_MATCHING
-    /* TODO: MaxPathControls, sym() for drones */
+    if (slot < 0 || slot >= MAX_LINKS || !sModelSnap[sModelSnapFront].car[slot].valid) {
+        return NULL;
+    }
+    return &sCarDisplay[slot];
+#else
+    return NULL;
 #endif
 }
 
+/**
+ * Get a car's appearance bits (damage, hulk, translucency)
+ */
+u32 car_get_appearance(s32 slot) {
+    if (slot < 0 || slot >= MAX_LINKS) {
+        return 0;
+    }
+    return car_array[slot].appearance;
+}
+
 /**
  * Update single car model
  */
 void update_model(s32 slot, s32 curtime) {
 #ifdef NON_MATCHING
-    /* TODO: Resurrection check, sym() call */
+    /* TODO: Resurrection check */
+    if (slot < 0 || slot >= MAX_LINKS || !model[slot].in_game) {
+        return;
+    }
+    /* One fixed DT_PHYSICS step; sym() advances thetime itself */
+    physics_sym(&model[slot]);
 #endif
 }
 
@@ -0,0 +1,705 @@
+/**
+ * cull.c - Per-viewport frustum culling
+ *
+ * Planes come from gFrustumPlanes (render.c), normals pointing into the
+ * frustum, so a point p is inside plane i when dot(n, p) + d >= 0.
+ *
+ * Box tests use the sign of each normal component to pick the corner
+ * furthest along the normal (p-vertex) and the one nearest (n-vertex):
+ * p-vertex behind the plane rejects the box; n-vertex in front means the
+ * box is fully inside that plane and children need not test it again.
+ * The BVH walk carries that as a 6-bit plane mask.
+ */
+
+#include "types.h"
+#include "game/render.h"
+#include "game/cull.h"
+
+#ifdef NON_MATCHING
+
+extern void *memset(void *s, s32 c, u32 n);
+
+typedef struct CullView {
+    f32     planes[6][4];
+    u8      psel[6][3];         /* 1 = take max for p-vertex on this axis */
+    f32     lod_scale;          /* Pixels per unit of radius at distance 1 */
+    const void *camera;         /* Camera the view was built from */
+    s32     valid;
+} CullView;
+
+/* BVH node: bounds[0] = min, bounds[1] = max */
+typedef struct CullNode {
+    f32     bounds[2][3];
+    s16     left;               /* Child indices, -1 for leaves */
+    s16     right;
+    s16     first;              /* Objects under this node are */
+    s16     span;               /* sCullIndex[first, first + span) */
+} CullNode;
+
+#define CULL_MAX_NODES      (CULL_MAX_STATIC * 2)
+#define CULL_STACK_DEPTH    32
+
+static CullView sCullViews[CULL_MAX_VIEWS];
+static s32 sCullView;
+
+static CullNode sCullNodes[CULL_MAX_NODES];
+static s32 sCullNodeCount;
+static s16 sCullIndex[CULL_MAX_STATIC];
+static f32 sCullCenter[CULL_MAX_STATIC][3];
+static f32 sCullRadius[CULL_MAX_STATIC];
+static s32 sCullCount;
+
+/*
+ * Projected radius (pixels) below which each class drops to LOD 1, 2, 3.
+ * At full screen these reproduce the old distance tables (car radius 8:
+ * 20/50/100 ft; radius-5 props: 100/300/600; car entities: 50/150 ft,
+ * no level 3); a half-height split viewport reaches each level at half
+ * the distance.
+ */
+static const f32 sLodPixels[LOD_NUM_CLASSES][LOD_LEVELS - 1] = {
+    { 57.0f, 23.0f, 11.4f },    /* LOD_CLASS_CAR */
+    { 7.2f, 2.4f, 1.2f },       /* LOD_CLASS_MBOX */
+    { 12.0f, 5.0f, 2.0f },      /* LOD_CLASS_ZOID */
+    { 22.9f, 7.6f, 0.0f },      /* LOD_CLASS_CAR_ENT */
+};
+
+static f32 sLodBias = 1.0f;
+
+static CullStats sCullStats;    /* Frame in progress */
+static CullStats sCullLast;     /* Last completed frame */
+
+/*
+ * ==========================================================================
+ * Viewports
+ * ==========================================================================
+ */
+
+/**
+ * cull_frame_begin - Publish last frame's counters and start a new frame
+ */
+void cull_frame_begin(void) {
+    u32 frames = sCullLast.frames + 1;
+
+    sCullLast = sCullStats;
+    sCullLast.frames = frames;
+    memset(&sCullStats, 0, sizeof(sCullStats));
+}
+
+/**
+ * cull_view_begin - Select the viewport the next camera update belongs to
+ * @param view Viewport index (0 to CULL_MAX_VIEWS - 1)
+ */
+void cull_view_begin(s32 view) {
+    if (view >= 0 && view < CULL_MAX_VIEWS) {
+        sCullView = view;
+    }
+}
+
+/**
+ * cull_view_bind - Record which camera drives a viewport
+ *
+ * Lets callers that hold a camera rather than a view index (entity
+ * visibility) find that camera's frustum. A camera bound to another
+ * viewport is moved to this one.
+ *
+ * @param camera Camera the viewport is built from (NULL to unbind)
+ */
+void cull_view_bind(s32 view, const void *camera) {
+    s32 v;
+
+    if (view < 0 || view >= CULL_MAX_VIEWS) {
+        return;
+    }
+    for (v = 0; v < CULL_MAX_VIEWS; v++) {
+        if (camera != NULL && sCullViews[v].camera == camera) {
+            sCullViews[v].camera = NULL;
+        }
+    }
+    sCullViews[view].camera = camera;
+}
+
+/**
+ * cull_view_find - Viewport a camera is bound to
+ * @return View index, or -1 if the camera drives no viewport with a frustum
+ */
+s32 cull_view_find(const void *camera) {
+    s32 v;
+
+    if (camera == NULL) {
+        return -1;
+    }
+    for (v = 0; v < CULL_MAX_VIEWS; v++) {
+        if (sCullViews[v].camera == camera && sCullViews[v].valid) {
+            return v;
+        }
+    }
+    return -1;
+}
+
+/**
+ * cull_view_update - Snapshot gFrustumPlanes into the current viewport
+ *
+ * Called by render_update_frustum whenever the planes are rebuilt, so
+ * every viewport keeps its own frustum and LOD scale.
+ *
+ * @param pixels_per_unit Viewport height / (2 tan(fovy / 2))
+ */
+void cull_view_update(f32 pixels_per_unit) {
+    CullView *cv = &sCullViews[sCullView];
+    s32 i, k;
+
+    for (i = 0; i < 6; i++) {
+        for (k = 0; k < 4; k++) {
+            cv->planes[i][k] = gFrustumPlanes[i][k];
+        }
+        for (k = 0; k < 3; k++) {
+            cv->psel[i][k] = gFrustumPlanes[i][k] >= 0.0f;
+        }
+    }
+    cv->lod_scale = pixels_per_unit;
+    cv->valid = 1;
+}
+
+/**
+ * cull_view_current - Viewport the camera was last set for
+ * @return View index, or -1 if no frustum has been built yet
+ */
+s32 cull_view_current(void) {
+    return sCullViews[sCullView].valid ? sCullView : -1;
+}
+
+/*
+ * ==========================================================================
+ * Tests
+ * ==========================================================================
+ */
+
+/**
+ * Sphere against the planes in mask
+ * @return 1 if visible, 0 if culled
+ */
+static s32 cull_sphere_mask(CullView *cv, f32 *c, f32 r, s32 mask) {
+    f32 (*p)[4] = cv->planes;
+    s32 i;
+
+    for (i = 0; i < 6; i++) {
+        if (!(mask & (1 << i))) {
+            continue;
+        }
+        sCullStats.plane_tests++;
+        if (p[i][0] * c[0] + p[i][1] * c[1] + p[i][2] * c[2] + p[i][3] < -r) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Box against the planes in mask
+ * @param mask In: planes to test. Out: planes the box straddles.
+ * @return 0 if outside, 1 if not
+ */
+static s32 cull_box_mask(CullView *cv, f32 (*b)[3], s32 *mask) {
+    f32 (*p)[4] = cv->planes;
+    u8 *s;
+    s32 i, m = *mask;
+
+    for (i = 0; i < 6; i++) {
+        if (!(m & (1 << i))) {
+            continue;
+        }
+        s = cv->psel[i];
+        sCullStats.plane_tests++;
+
+        /* Furthest corner along the normal still behind: outside */
+        if (p[i][0] * b[s[0]][0] + p[i][1] * b[s[1]][1] +
+            p[i][2] * b[s[2]][2] + p[i][3] < 0.0f) {
+            return 0;
+        }
+        /* Nearest corner in front: fully inside this plane */
+        if (p[i][0] * b[s[0] ^ 1][0] + p[i][1] * b[s[1] ^ 1][1] +
+            p[i][2] * b[s[2] ^ 1][2] + p[i][3] >= 0.0f) {
+            m &= ~(1 << i);
+        }
+    }
+    *mask = m;
+    return 1;
+}
+
+/**
+ * cull_sphere - Test a sphere against one viewport's frustum
+ * @return 1 if visible, 0 if culled (visible if the view has no frustum)
+ */
+s32 cull_sphere(s32 view, f32 center[3], f32 radius) {
+    s32 vis;
+
+    if (view < 0 || view >= CULL_MAX_VIEWS || !sCullViews[view].valid) {
+        return 1;
+    }
+
+    sCullStats.tested++;
+    vis = cull_sphere_mask(&sCullViews[view], center, radius, CULL_ALL_PLANES);
+    if (!vis) {
+        sCullStats.culled++;
+    }
+    return vis;
+}
+
+/**
+ * cull_box - Test an axis-aligned box against one viewport's frustum
+ * @return 1 if visible, 0 if culled
+ */
+s32 cull_box(s32 view, f32 min[3], f32 max[3]) {
+    f32 b[2][3];
+    s32 mask = CULL_ALL_PLANES;
+    s32 k;
+
+    if (view < 0 || view >= CULL_MAX_VIEWS || !sCullViews[view].valid) {
+        return 1;
+    }
+
+    for (k = 0; k < 3; k++) {
+        b[0][k] = min[k];
+        b[1][k] = max[k];
+    }
+
+    sCullStats.tested++;
+    if (!cull_box_mask(&sCullViews[view], b, &mask)) {
+        sCullStats.culled++;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * cull_spheres - Test a batch of spheres against one viewport
+ * @param visible Out: 1 per visible sphere, 0 per culled
+ * @return Number visible
+ */
+s32 cull_spheres(s32 view, f32 (*centers)[3], f32 *radii, s32 count, u8 *visible) {
+    CullView *cv;
+    s32 i, n = 0;
+
+    if (view < 0 || view >= CULL_MAX_VIEWS || !sCullViews[view].valid) {
+        for (i = 0; i < count; i++) {
+            visible[i] = 1;
+        }
+        return count;
+    }
+
+    cv = &sCullViews[view];
+    for (i = 0; i < count; i++) {
+        visible[i] = (u8)cull_sphere_mask(cv, centers[i], radii[i], CULL_ALL_PLANES);
+        n += visible[i];
+    }
+    sCullStats.tested += count;
+    sCullStats.culled += count - n;
+    return n;
+}
+
+/*
+ * ==========================================================================
+ * Static object hierarchy
+ * ==========================================================================
+ */
+
+/**
+ * Recursively split sCullIndex[first, first + count) at the median of
+ * the longest centroid axis
+ * @return Node index
+ */
+static s32 cull_bvh_split(s32 first, s32 count) {
+    CullNode *node;
+    f32 cmin[3], cmax[3];
+    f32 *c, r, key;
+    s32 i, j, k, axis, idx, mid;
+
+    idx = sCullNodeCount++;
+    node = &sCullNodes[idx];
+
+    for (k = 0; k < 3; k++) {
+        node->bounds[0][k] = cmin[k] = 1e30f;
+        node->bounds[1][k] = cmax[k] = -1e30f;
+    }
+    for (i = first; i < first + count; i++) {
+        c = sCullCenter[sCullIndex[i]];
+        r = sCullRadius[sCullIndex[i]];
+        for (k = 0; k < 3; k++) {
+            if (c[k] - r < node->bounds[0][k]) node->bounds[0][k] = c[k] - r;
+            if (c[k] + r > node->bounds[1][k]) node->bounds[1][k] = c[k] + r;
+            if (c[k] < cmin[k]) cmin[k] = c[k];
+            if (c[k] > cmax[k]) cmax[k] = c[k];
+        }
+    }
+
+    node->first = (s16)first;
+    node->span = (s16)count;
+    node->left = node->right = -1;
+    if (count <= CULL_BVH_LEAF) {
+        return idx;
+    }
+
+    axis = 0;
+    for (k = 1; k < 3; k++) {
+        if (cmax[k] - cmin[k] > cmax[axis] - cmin[axis]) {
+            axis = k;
+        }
+    }
+
+    /* Insertion sort on the split axis; built once per track load */
+    for (i = first + 1; i < first + count; i++) {
+        s16 v = sCullIndex[i];
+        key = sCullCenter[v][axis];
+        for (j = i - 1; j >= first && sCullCenter[sCullIndex[j]][axis] > key; j--) {
+            sCullIndex[j + 1] = sCullIndex[j];
+        }
+        sCullIndex[j + 1] = v;
+    }
+
+    mid = count / 2;
+    node->left = (s16)cull_bvh_split(first, mid);
+    node = &sCullNodes[idx];
+    node->right = (s16)cull_bvh_split(first + mid, count - mid);
+    return idx;
+}
+
+/**
+ * cull_bvh_build - Build the hierarchy over static track objects
+ *
+ * Call once after the track's objects are placed. Object i of the input
+ * is reported as visible[i] by cull_bvh_run.
+ *
+ * @param centers Bounding sphere centers
+ * @param radii Bounding sphere radii
+ * @param count Objects (clamped to CULL_MAX_STATIC)
+ * @return Nodes built
+ */
+s32 cull_bvh_build(f32 (*centers)[3], f32 *radii, s32 count) {
+    s32 i, k;
+
+    if (count > CULL_MAX_STATIC) {
+        count = CULL_MAX_STATIC;
+    }
+
+    sCullCount = count;
+    sCullNodeCount = 0;
+    for (i = 0; i < count; i++) {
+        for (k = 0; k < 3; k++) {
+            sCullCenter[i][k] = centers[i][k];
+        }
+        sCullRadius[i] = radii[i];
+        sCullIndex[i] = (s16)i;
+    }
+
+    if (count > 0) {
+        cull_bvh_split(0, count);
+    }
+    return sCullNodeCount;
+}
+
+/**
+ * cull_bvh_run - Cull every static object for one viewport
+ *
+ * @param view Viewport index
+ * @param visible Out: one byte per object, 1 = visible
+ * @return Number visible
+ */
+s32 cull_bvh_run(s32 view, u8 *visible) {
+    s16 stack_node[CULL_STACK_DEPTH];
+    u8 stack_mask[CULL_STACK_DEPTH];
+    CullView *cv;
+    CullNode *node;
+    s32 sp, mask, i, obj, n = 0;
+
+    if (sCullCount == 0) {
+        return 0;
+    }
+    if (view < 0 || view >= CULL_MAX_VIEWS || !sCullViews[view].valid) {
+        for (i = 0; i < sCullCount; i++) {
+            visible[i] = 1;
+        }
+        return sCullCount;
+    }
+
+    cv = &sCullViews[view];
+    memset(visible, 0, sCullCount);
+
+    sp = 0;
+    stack_node[sp] = 0;
+    stack_mask[sp] = CULL_ALL_PLANES;
+    sp++;
+
+    while (sp > 0) {
+        sp--;
+        node = &sCullNodes[stack_node[sp]];
+        mask = stack_mask[sp];
+
+        sCullStats.nodes_visited++;
+        if (!cull_box_mask(cv, node->bounds, &mask)) {
+            sCullStats.nodes_rejected++;
+            continue;
+        }
+
+        if (mask == 0) {
+            /* Fully inside: accept the whole subtree without testing */
+            sCullStats.nodes_accepted++;
+            for (i = node->first; i < node->first + node->span; i++) {
+                visible[sCullIndex[i]] = 1;
+            }
+            continue;
+        }
+
+        if (node->left < 0) {
+            for (i = node->first; i < node->first + node->span; i++) {
+                obj = sCullIndex[i];
+                visible[obj] = (u8)cull_sphere_mask(cv, sCullCenter[obj], sCullRadius[obj], mask);
+            }
+        } else {
+            /* Depth is ~log2(objects / leaf size), far below the stack */
+            stack_node[sp] = node->right;
+            stack_mask[sp] = (u8)mask;
+            sp++;
+            stack_node[sp] = node->left;
+            stack_mask[sp] = (u8)mask;
+            sp++;
+        }
+    }
+
+    for (i = 0; i < sCullCount; i++) {
+        n += visible[i];
+    }
+    sCullStats.tested += sCullCount;
+    sCullStats.culled += sCullCount - n;
+    return n;
+}
+
+/*
+ * ==========================================================================
+ * Several viewports at once
+ * ==========================================================================
+ */
+
+/**
+ * cull_bvh_run_views - Cull every static object for several viewports
+ *
+ * One walk of the hierarchy serves all viewports: each stack entry
+ * carries the viewports still undecided for its subtree with their
+ * plane masks (6 bits per view), plus the viewports that already accept
+ * it whole. A subtree is dropped once no viewport is left undecided.
+ *
+ * @param view_mask Bit per viewport to test
+ * @param masks Out: one byte per object, bit per viewport that sees it
+ * @return Objects visible in at least one viewport
+ */
+s32 cull_bvh_run_views(s32 view_mask, u8 *masks) {
+    s16 stack_node[CULL_STACK_DEPTH];
+    u32 stack_planes[CULL_STACK_DEPTH];
+    u8 stack_live[CULL_STACK_DEPTH];
+    u8 stack_inside[CULL_STACK_DEPTH];
+    CullNode *node;
+    u32 planes;
+    s32 sp, live, inside, pmask, m, v, i, obj, n = 0;
+
+    if (sCullCount == 0) {
+        return 0;
+    }
+
+    /* Views without a frustum see everything */
+    inside = 0;
+    planes = 0;
+    for (v = 0; v < CULL_MAX_VIEWS; v++) {
+        if (!(view_mask & (1 << v))) {
+            continue;
+        }
+        if (sCullViews[v].valid) {
+            planes |= (u32)CULL_ALL_PLANES << (v * 6);
+        } else {
+            inside |= 1 << v;
+        }
+    }
+    live = view_mask & ~inside & ((1 << CULL_MAX_VIEWS) - 1);
+
+    memset(masks, inside, sCullCount);
+    if (live == 0) {
+        return sCullCount;
+    }
+
+    sp = 0;
+    stack_node[sp] = 0;
+    stack_planes[sp] = planes;
+    stack_live[sp] = (u8)live;
+    stack_inside[sp] = (u8)inside;
+    sp++;
+
+    while (sp > 0) {
+        sp--;
+        node = &sCullNodes[stack_node[sp]];
+        planes = stack_planes[sp];
+        live = stack_live[sp];
+        inside = stack_inside[sp];
+
+        sCullStats.nodes_visited++;
+        for (v = 0; v < CULL_MAX_VIEWS; v++) {
+            if (!(live & (1 << v))) {
+                continue;
+            }
+            pmask = (planes >> (v * 6)) & CULL_ALL_PLANES;
+            if (!cull_box_mask(&sCullViews[v], node->bounds, &pmask)) {
+                live &= ~(1 << v);
+            } else if (pmask == 0) {
+                live &= ~(1 << v);
+                inside |= 1 << v;
+            }
+            planes = (planes & ~((u32)CULL_ALL_PLANES << (v * 6))) |
+                     ((u32)pmask << (v * 6));
+        }
+
+        if (live == 0) {
+            if (inside == 0) {
+                sCullStats.nodes_rejected++;
+                continue;
+            }
+            /* Decided for every viewport: no further tests below here */
+            sCullStats.nodes_accepted++;
+            for (i = node->first; i < node->first + node->span; i++) {
+                masks[sCullIndex[i]] = (u8)inside;
+            }
+            continue;
+        }
+
+        if (node->left < 0) {
+            for (i = node->first; i < node->first + node->span; i++) {
+                obj = sCullIndex[i];
+                m = inside;
+                for (v = 0; v < CULL_MAX_VIEWS; v++) {
+                    if ((live & (1 << v)) &&
+                        cull_sphere_mask(&sCullViews[v], sCullCenter[obj], sCullRadius[obj],
+                                         (planes >> (v * 6)) & CULL_ALL_PLANES)) {
+                        m |= 1 << v;
+                    }
+                }
+                masks[obj] = (u8)m;
+            }
+        } else {
+            stack_node[sp] = node->right;
+            stack_planes[sp] = planes;
+            stack_live[sp] = (u8)live;
+            stack_inside[sp] = (u8)inside;
+            sp++;
+            stack_node[sp] = node->left;
+            stack_planes[sp] = planes;
+            stack_live[sp] = (u8)live;
+            stack_inside[sp] = (u8)inside;
+            sp++;
+        }
+    }
+
+    for (i = 0; i < sCullCount; i++) {
+        n += masks[i] != 0;
+    }
+    sCullStats.tested += sCullCount;
+    sCullStats.culled += sCullCount - n;
+    return n;
+}
+
+/*
+ * ==========================================================================
+ * Screen-space LOD
+ * ==========================================================================
+ */
+
+/**
+ * Level for a projected size against thresholds scaled by k/16
+ */
+static s32 lod_level_for(const f32 *thr, f32 pixels, s32 k16) {
+    s32 lvl = 0;
+
+    while (lvl < LOD_LEVELS - 1 && pixels < thr[lvl] * (f32)k16 * (1.0f / 16.0f)) {
+        lvl++;
+    }
+    return lvl;
+}
+
+/**
+ * lod_select - Pick a detail level from projected screen size
+ *
+ * Moving coarser requires the size to fall below threshold x (1 - band),
+ * moving finer requires it to rise above threshold x (1 + band), so an
+ * object hovering at a boundary keeps its current level.
+ *
+ * @param view Viewport (from cull_view_current; -1 uses a 240-line default)
+ * @param cls LOD_CLASS_*
+ * @param radius Bounding radius
+ * @param distance Distance from the camera
+ * @param current Current level, or -1 for no hysteresis
+ * @return Level 0 (full) to LOD_LEVELS - 1
+ */
+s32 lod_select(s32 view, s32 cls, f32 radius, f32 distance, s32 current) {
+    const f32 *thr;
+    f32 scale, pixels;
+    s32 coarser, finer, lvl;
+
+    if (cls < 0 || cls >= LOD_NUM_CLASSES) {
+        cls = LOD_CLASS_ZOID;
+    }
+    thr = sLodPixels[cls];
+
+    if (view >= 0 && view < CULL_MAX_VIEWS && sCullViews[view].valid) {
+        scale = sCullViews[view].lod_scale;
+    } else {
+        scale = 143.0f;         /* 240 / (2 tan(40 degrees)) */
+    }
+
+    if (distance <= radius) {
+        lvl = 0;
+    } else {
+        pixels = radius / distance * scale * sLodBias;
+
+        if (current < 0 || current >= LOD_LEVELS) {
+            lvl = lod_level_for(thr, pixels, 16);
+        } else {
+            coarser = lod_level_for(thr, pixels, 16 - LOD_HYST_16THS);
+            finer = lod_level_for(thr, pixels, 16 + LOD_HYST_16THS);
+            if (coarser > current) {
+                lvl = coarser;
+            } else if (finer < current) {
+                lvl = finer;
+            } else {
+                lvl = current;
+                if (lod_level_for(thr, pixels, 16) != current) {
+                    sCullStats.lod_held++;
+                }
+            }
+        }
+    }
+
+    sCullStats.lod_selects++;
+    sCullStats.lod_level[lvl]++;
+    if (current >= 0 && lvl != current) {
+        sCullStats.lod_switches++;
+    }
+    return lvl;
+}
+
+/**
+ * lod_set_bias - Scale every projected size (1.0 = neutral, < 1 coarser)
+ */
+void lod_set_bias(f32 bias) {
+    if (bias < 0.125f) {
+        bias = 0.125f;
+    }
+    sLodBias = bias;
+}
+
+f32 lod_get_bias(void) {
+    return sLodBias;
+}
+
+/**
+ * cull_get_stats - Counters for the last completed frame
+ */
+CullStats *cull_get_stats(void) {
+    return &sCullLast;
+}
+
+#endif /* NON_MATCHING */
@@ -36,6 +36,9 @@ extern f32 atan2f(f32 y, f32 x);
 extern f32 sinf(f32 x);
 extern f32 cosf(f32 x);
 
+/* Road segment index (road.c) */
+extern f32 road_get_car_width(s32 car_index, f32 pos[3]);
+
 /* External car input handlers */
 extern void lookat_get(void *car, f32 steerInput);
 extern void camera_get_pos(void *car, f32 throttle, f32 brake);
@@ -876,7 +879,8 @@ void drone_avoid_walls(s32 car_index) {
 
     ctl = &drone_ctl[car_index];
 
-    track_half_width = 20.0f;
+    /* Width of the road under the car (40 ft off the index) */
+    track_half_width = road_get_car_width(car_index, car_array[car_index].RWR) * 0.5f;
     edge_margin = 5.0f;
 
     if (ctl->yrel > track_half_width - edge_margin) {
@@ -8,6 +8,7 @@
 #include "types.h"
 #include "game/structs.h"
 #include "PR/os.h"
+#include "game/cull.h"
 
 /* Math function declarations (avoid system math.h for IDO compatibility) */
 extern f64 sin(f64);
@@ -493,6 +494,20 @@ extern void countdown_handler(void);          /* countdown_start - Countdown tim
 extern void drone_deactivate(void);           /* drone_deactivate - Deactivate drones */
 extern void render_scene(s32 track, f32 angle, s32 x, s32 y); /* render_scene - Viewport/camera setup */
 extern void sound_race_start(s32 countdown);  /* sound.c */
+extern void snd_cmd_drain(void);              /* sound.c */
+extern void snd_voice_update(void);           /* sound.c */
+extern Gfx *gfx_arena_begin_frame(s32 num_views); /* gfx.c */
+extern u32 gfx_arena_end_frame(Gfx *end);     /* gfx.c */
+extern void gfx_arena_retire(void);           /* gfx.c */
+extern s32 mp_get_num_players(void);          /* multiplayer.c */
+extern void mtx_arena_begin_frame(void);      /* matrix.c */
+extern void texcache_frame(void);             /* texcache.c */
+extern void *texcache_get(s32 id);            /* texcache.c */
+extern s32 ground_cache_query(f32 x, f32 z, f32 *y); /* ground.c */
+extern void render_frame_start(void);         /* render.c */
+extern void render_frame_end(void);           /* render.c */
+
+#define CAR_LOD_RADIUS  8.0f    /* Car bounding radius for screen-space LOD (ft) */
 
 /* Forward declarations for functions defined in this file */
 s32 track_lod_select(f32 distance);  /* LOD distance calculator */
@@ -699,6 +714,10 @@ extern void game_exit(void);
 extern void game_unpause(void);
 extern void data_copy(void *dst, void *src, s32 size);
 extern s32 entity_cull_check(void *entity);
+#ifdef NON_MATCHING
+extern struct CameraData *camera_get_view(s32 view);   /* camera.c */
+static s32 entity_cull_views(void *entity);
+#endif
 extern void gfx_set_mode(s32 mode);
 extern void model_lod(void *model, s32 lod);
 
@@ -8891,8 +8910,13 @@ void entity_tick_update(void *entity, void *data) {
 
     /* Visibility check */
     if (updateFlags & 0x10) {
+#ifdef NON_MATCHING
+        /* Visible if any local player's viewport sees it */
+        culled = entity_cull_views(entity);
+#else
         camera = (void *)0x8015B000;
         culled = entity_cull_check(entity, camera);
+#endif
         if (culled) {
             *flags &= ~0x200;  /* Not visible */
         } else {
@@ -9518,8 +9542,12 @@ void entity_tick_main(void *entity, s32 mode) {
 
         case 4:  /* Visibility update */
             {
+#ifdef NON_MATCHING
+                s32 culled = entity_cull_views(entity);
+#else
                 void *camera = (void *)0x8015B000;
                 s32 culled = entity_cull_check(entity, camera);
+#endif
                 if (culled) {
                     *entityFlags &= ~0x200;
                 } else {
@@ -10251,6 +10279,24 @@ void entity_lod_select(void *entity, f32 distance) {
     modelIndex = (s32 *)((u8 *)entity + 0xF4);
     baseModel = *((s32 *)((u8 *)entity + 0xF8));
 
+#ifdef NON_MATCHING
+    {
+        /* Projected size in the current viewport, with hysteresis */
+        f32 radius = *((f32 *)((u8 *)entity + 0x5C));
+
+        if (radius < 1.0f) {
+            radius = 5.0f;
+        }
+        entityType = *((s32 *)((u8 *)entity + 0x08));
+        *lodLevel = lod_select(cull_view_current(),
+                               entityType == 1 ? LOD_CLASS_CAR_ENT : LOD_CLASS_MBOX,
+                               entityType == 1 ? CAR_LOD_RADIUS : radius,
+                               distance, *lodLevel);
+        *modelIndex = baseModel + *lodLevel;
+        return;
+    }
+#endif
+
     /* LOD distance thresholds */
     lodDist0 = 100.0f;   /* High detail */
     lodDist1 = 300.0f;   /* Medium detail */
@@ -10303,6 +10349,9 @@ s32 entity_cull_check(void *entity, void *camera) {
     f32 nearPlane, farPlane;
     f32 coneAngle;
     f32 radiusMargin;
+#ifdef NON_MATCHING
+    s32 view;
+#endif
 
     if (entity == NULL || camera == NULL) {
         return 1;  /* Cull if invalid */
@@ -10318,6 +10367,14 @@ s32 entity_cull_check(void *entity, void *camera) {
         entityRadius = 5.0f;
     }
 
+#ifdef NON_MATCHING
+    /* Six-plane sphere test against the frustum this camera drives */
+    view = cull_view_find(camera);
+    if (view >= 0) {
+        return !cull_sphere(view, entityPos, entityRadius);
+    }
+#endif
+
     /* Calculate vector from camera to entity */
     dx = entityPos[0] - cameraPos[0];
     dy = entityPos[1] - cameraPos[1];
@@ -10362,6 +10419,30 @@ s32 entity_cull_check(void *entity, void *camera) {
     return 0;  /* Visible */
 }
 
+#ifdef NON_MATCHING
+/*
+ * entity_cull_views - Entity cull check for every local player
+ * Culled only if no player's camera (each bound to its viewport by
+ * render_scene) sees the entity.
+ */
+static s32 entity_cull_views(void *entity) {
+    void *camera;
+    s32 v, n;
+
+    n = mp_get_num_players();
+    if (n < 1) {
+        n = 1;
+    }
+    for (v = 0; v < n; v++) {
+        camera = camera_get_view(v);
+        if (camera != NULL && !entity_cull_check(entity, camera)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+#endif
+
 /*
 
  * entity_render_transform (1216 bytes)
@@ -11288,6 +11369,11 @@ void car_lod_select(void *car, f32 distance) {
     currentLod = (s32 *)((u8 *)car + 0x180);
     lodModels = (void **)((u8 *)car + 0x184);
 
+#ifdef NON_MATCHING
+    /* Projected size in the current viewport, with hysteresis */
+    newLod = lod_select(cull_view_current(), LOD_CLASS_CAR, CAR_LOD_RADIUS,
+                        distance, *currentLod);
+#else
     /* LOD distance thresholds */
     lodDistances[0] = 20.0f;   /* High detail */
     lodDistances[1] = 50.0f;   /* Medium detail */
@@ -11304,6 +11390,7 @@ void car_lod_select(void *car, f32 distance) {
     } else {
         newLod = 3;
     }
+#endif
 
     /* Only switch if LOD actually changed and model exists */
     if (newLod != *currentLod && lodModels[newLod] != NULL) {
@@ -15410,7 +15497,13 @@ void camera_track_target(void *camera, void *target) {
     }
 
     /* Ground collision for camera */
+#ifdef NON_MATCHING
+    /* Chase cam usually sits over the target car's ground grid */
+    if (ground_cache_query(camPos[0], camPos[2], &groundHeight) ||
+        track_surface_query(camPos, NULL, &groundHeight) != 0) {
+#else
     if (track_surface_query(camPos, NULL, &groundHeight) != 0) {
+#endif
         if (camPos[1] < groundHeight + 2.0f) {
             camPos[1] = groundHeight + 2.0f;
         }
@@ -22819,6 +22912,12 @@ void audio_frame_update(void) {
     audioState = (s32 *)0x80130000;
     channelStates = (s32 *)0x80160000;
 
+#ifdef NON_MATCHING
+    /* Apply the game thread's queued SOUND()/snd* commands */
+    snd_cmd_drain();
+    snd_voice_update();
+#endif
+
     /* Check if audio enabled */
     if (audioState[0] == 0) {
         return;
@@ -38953,7 +39052,15 @@ void track_texture_load(s32 textureId) {
         return;
     }
 
+#ifdef NON_MATCHING
+    /* Streamed textures come from the residency cache */
+    texData = texcache_get(textureId);
+    if (texData == NULL) {
+        texData = texture_data_array[textureId];
+    }
+#else
     texData = texture_data_array[textureId];
+#endif
     if (texData == NULL) {
         return;
     }
@@ -39552,6 +39659,18 @@ void frame_start(void) {
 
     frame_counter++;
 
+#ifdef NON_MATCHING
+    /* Build into the arena buffer the RDP is not reading */
+    dl = gfx_arena_begin_frame(mp_get_num_players());
+    if (dl != NULL) {
+        gfx_dl_base = dl;
+    }
+    cull_frame_begin();
+    mtx_arena_begin_frame();
+    texcache_frame();
+    render_frame_start();
+#endif
+
     /* Reset display list to base */
     dl = gfx_dl_base;
 
@@ -39584,6 +39703,11 @@ void frame_end(void) {
     /* Note: gfx_dl_ptr, gfx_task declared globally */
     Gfx *dl;
 
+#ifdef NON_MATCHING
+    /* Call any viewport draws still queued from the frame list */
+    render_frame_end();
+#endif
+
     dl = *gfx_dl_ptr;
 
     /* End display list */
@@ -39592,6 +39716,10 @@ void frame_end(void) {
 
     *gfx_dl_ptr = dl;
 
+#ifdef NON_MATCHING
+    gfx_arena_end_frame(dl);
+#endif
+
     /* Flush display list */
     display_list_flush();
 
@@ -39612,6 +39740,11 @@ void vsync_wait(void) {
     osRecvMesg(&vi_message_queue, &msg, OS_MESG_BLOCK);
 }
 
+#ifdef NON_MATCHING
+/* A submitted frame whose completion has not been collected yet */
+static s32 sGfxTaskPending;
+#endif
+
 /*
 
  * display_list_flush - Submit display list to RSP/RDP
@@ -39622,6 +39755,19 @@ void display_list_flush(void) {
     extern Gfx **gfx_dl_ptr;  /* Display list pointer */
     OSTask *task = &gfx_task;
 
+#ifdef NON_MATCHING
+    /*
+     * The RSP takes one task at a time: collect the previous frame here,
+     * just before this one is submitted, and hand its arena buffer back.
+     * The RDP draws frame N while the CPU builds frame N+1.
+     */
+    if (sGfxTaskPending) {
+        osRecvMesg(&dma_message_queue, NULL, OS_MESG_BLOCK);
+        gfx_arena_retire();
+        sGfxTaskPending = 0;
+    }
+#endif
+
     /* Configure task */
     task->t.type = M_GFXTASK;
     task->t.flags = 0;
@@ -39642,8 +39788,13 @@ void display_list_flush(void) {
     /* Start RSP task */
     osSpTaskStart(task);
 
+#ifdef NON_MATCHING
+    /* Completion is collected by the next flush */
+    sGfxTaskPending = 1;
+#else
     /* Wait for completion */
     osRecvMesg(&dma_message_queue, NULL, OS_MESG_BLOCK);
+#endif
 }
 
 /* Forward declaration for debug stats */
@@ -3,15 +3,28 @@
  * @brief Graphics display list management
  *
  * Decompiled from asm/us/5610.s
+ *
+ * NON_MATCHING builds replace the single unchecked bump allocator with a
+ * double-buffered arena: the CPU builds frame N+1 in one buffer while the
+ * RDP consumes frame N from the other. Each buffer starts with the frame's
+ * own display list (written linearly by frame_start and the code after
+ * it), followed by one slice per split-screen viewport that the frame
+ * list branches into. gfx_alloc_dl keeps its interface but
+ * now allocates from the current viewport's slice, refuses requests that
+ * would run past it, and reports pressure through a hook so the renderer
+ * can shed detail. High-water marks are kept per split-screen mode.
  */
 
 #include "types.h"
+#include "game/render.h"
 
 /* External data - display list pointers */
 extern Gfx *gDisplayListHead;  /* D_800354C4 */
 extern Gfx *gDisplayListEnd;   /* D_800354CC */
 extern u32 gDisplayListSize;   /* D_800354C8 */
 
+#ifndef NON_MATCHING
+
 /**
  * Initialize display list buffer
  * @param start Pointer to start of display list buffer
@@ -36,3 +49,290 @@ Gfx *gfx_alloc_dl(u32 size) {
 
     return result;
 }
+
+#else /* NON_MATCHING */
+
+extern void *memset(void *s, s32 c, u32 n);
+
+typedef struct GfxArena {
+    Gfx     *buf[2];
+    u32     capacity;                   /* Per buffer, in commands */
+    s32     cur;                        /* Buffer being built */
+    s32     busy[2];                    /* Submitted, RDP not done yet */
+    u32     main_cap;                   /* Frame list region at the base */
+    s32     num_views;
+    s32     view;                       /* Slice gfx_alloc_dl targets */
+    Gfx     *view_base[GFX_MAX_VIEWS];
+    u32     view_cap[GFX_MAX_VIEWS];
+    u32     view_used[GFX_MAX_VIEWS];
+    u8      view_flagged[GFX_MAX_VIEWS];  /* Hook already fired this frame */
+} GfxArena;
+
+static GfxArena sGfxArena;
+static GfxArenaStats sGfxArenaStats[GFX_MAX_VIEWS];
+static GfxArenaFunc sGfxArenaFunc;
+
+/**
+ * Initialize display list buffer
+ *
+ * Makes [start, end) the current slice. Also used by the arena to switch
+ * slices, so the bounds always describe where gfx_alloc_dl may write.
+ *
+ * @param start Pointer to start of display list buffer
+ * @param end Pointer to end of display list buffer
+ */
+void gfx_init_dl(Gfx *start, Gfx *end) {
+    gDisplayListHead = start;
+    gDisplayListEnd = end;
+    gDisplayListSize = 0;
+}
+
+/**
+ * Fire the pressure hook once per viewport per frame
+ */
+static void gfx_arena_flag(s32 view, u32 used, u32 capacity, s32 overflowed) {
+    GfxArenaStats *st = &sGfxArenaStats[sGfxArena.num_views - 1];
+
+    if (overflowed) {
+        st->overflows++;
+    } else {
+        st->warnings++;
+    }
+
+    if (sGfxArena.view_flagged[view] > overflowed) {
+        return;
+    }
+    sGfxArena.view_flagged[view] = (u8)(overflowed + 1);
+
+    if (sGfxArenaFunc != NULL) {
+        sGfxArenaFunc(view, used, capacity, overflowed);
+    }
+}
+
+/**
+ * Allocate space in display list
+ * @param size Number of Gfx commands to allocate
+ * @return Pointer to allocated display list space, or NULL if the
+ *         current slice cannot hold it
+ */
+Gfx *gfx_alloc_dl(u32 size) {
+    Gfx *result;
+    u32 capacity;
+
+    capacity = (u32)(gDisplayListEnd - gDisplayListHead);
+
+    if (size > capacity - gDisplayListSize) {
+        if (sGfxArena.num_views > 0) {
+            sGfxArenaStats[sGfxArena.num_views - 1].overflow_cmds += size;
+            gfx_arena_flag(sGfxArena.view, gDisplayListSize, capacity, 1);
+        }
+        return NULL;
+    }
+
+    result = gDisplayListHead + gDisplayListSize;
+    gDisplayListSize += size;
+
+    if (sGfxArena.num_views > 0) {
+        sGfxArena.view_used[sGfxArena.view] = gDisplayListSize;
+        if (gDisplayListSize > (capacity >> 3) * GFX_ARENA_WARN_8THS &&
+            gDisplayListSize - size <= (capacity >> 3) * GFX_ARENA_WARN_8THS) {
+            gfx_arena_flag(sGfxArena.view, gDisplayListSize, capacity, 0);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Commands gfx_alloc_dl can still hand out from the current slice
+ */
+u32 gfx_dl_free(void) {
+    return (u32)(gDisplayListEnd - gDisplayListHead) - gDisplayListSize;
+}
+
+/**
+ * Reserve frame list commands ahead of a dl++ write
+ *
+ * The frame list is written in place, so writers that add to it after
+ * frame_start check first. GFX_FRAME_TAIL commands stay back for
+ * frame_end. A refusal counts as an overflow of viewport 0.
+ *
+ * @param cur Current frame list write pointer
+ * @param size Commands about to be written
+ * @return 1 if they fit, 0 if not
+ */
+s32 gfx_frame_reserve(Gfx *cur, u32 size) {
+    u32 used;
+
+    if (sGfxArena.num_views == 0) {
+        return 1;
+    }
+
+    used = (u32)(cur - sGfxArena.buf[sGfxArena.cur]);
+    if (used + size + GFX_FRAME_TAIL > sGfxArena.main_cap) {
+        sGfxArenaStats[sGfxArena.num_views - 1].overflow_cmds += size;
+        gfx_arena_flag(0, used, sGfxArena.main_cap, 1);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Set up the double-buffered arena
+ * @param buf0 First frame buffer
+ * @param buf1 Second frame buffer
+ * @param count Capacity of each buffer in Gfx commands
+ */
+void gfx_arena_init(Gfx *buf0, Gfx *buf1, u32 count) {
+    sGfxArena.buf[0] = buf0;
+    sGfxArena.buf[1] = buf1;
+    sGfxArena.capacity = count;
+    sGfxArena.cur = 1;
+    sGfxArena.busy[0] = 0;
+    sGfxArena.busy[1] = 0;
+    sGfxArena.num_views = 0;
+    sGfxArena.view = 0;
+
+    memset(sGfxArenaStats, 0, sizeof(sGfxArenaStats));
+}
+
+/**
+ * Flip to the other buffer, reserve its frame list and split the rest
+ * evenly per viewport
+ *
+ * The caller owns the RDP sync: if the buffer is still marked busy the
+ * frame is counted as a stall, since building into it would race the RDP.
+ *
+ * @param num_views Viewports this frame (1-4)
+ * @return Base of the frame list, or NULL before gfx_arena_init
+ */
+Gfx *gfx_arena_begin_frame(s32 num_views) {
+    Gfx *base;
+    u32 main, slice;
+    s32 i;
+
+    if (sGfxArena.capacity == 0) {
+        return NULL;
+    }
+    if (num_views < 1) {
+        num_views = 1;
+    } else if (num_views > GFX_MAX_VIEWS) {
+        num_views = GFX_MAX_VIEWS;
+    }
+
+    sGfxArena.cur ^= 1;
+    if (sGfxArena.busy[sGfxArena.cur]) {
+        sGfxArenaStats[num_views - 1].stalls++;
+    }
+
+    base = sGfxArena.buf[sGfxArena.cur];
+    main = (sGfxArena.capacity >> 3) * GFX_ARENA_MAIN_8THS;
+    slice = (sGfxArena.capacity - main) / (u32)num_views;
+
+    sGfxArena.main_cap = main;
+    sGfxArena.num_views = num_views;
+    for (i = 0; i < num_views; i++) {
+        sGfxArena.view_base[i] = base + main + slice * (u32)i;
+        sGfxArena.view_cap[i] = slice;
+        sGfxArena.view_used[i] = 0;
+        sGfxArena.view_flagged[i] = 0;
+    }
+    /* Last slice takes the rounding remainder */
+    sGfxArena.view_cap[num_views - 1] = sGfxArena.capacity - main -
+                                        slice * (u32)(num_views - 1);
+
+    gfx_arena_set_view(0);
+    return base;
+}
+
+/**
+ * Direct gfx_alloc_dl at one viewport's slice
+ * @param view Viewport index (0 to num_views - 1)
+ */
+void gfx_arena_set_view(s32 view) {
+    Gfx *base;
+
+    if (view < 0 || view >= sGfxArena.num_views) {
+        return;
+    }
+
+    sGfxArena.view = view;
+    base = sGfxArena.view_base[view];
+    gfx_init_dl(base, base + sGfxArena.view_cap[view]);
+    gDisplayListSize = sGfxArena.view_used[view];
+}
+
+/**
+ * Close the frame, record telemetry and mark its buffer busy
+ *
+ * The frame list is written with dl++ rather than gfx_alloc_dl, so its
+ * overruns can only be caught after the fact from the final pointer.
+ *
+ * @param end Final frame list write pointer, or NULL
+ * @return Commands used this frame
+ */
+u32 gfx_arena_end_frame(Gfx *end) {
+    GfxArenaStats *st;
+    u32 used, total;
+    s32 i;
+
+    if (sGfxArena.num_views == 0) {
+        return 0;
+    }
+    st = &sGfxArenaStats[sGfxArena.num_views - 1];
+
+    total = 0;
+    for (i = 0; i < sGfxArena.num_views; i++) {
+        used = sGfxArena.view_used[i];
+        st->last_view[i] = used;
+        if (used > st->hwm_view[i]) {
+            st->hwm_view[i] = used;
+        }
+        total += used;
+    }
+
+    if (end != NULL) {
+        used = (u32)(end - sGfxArena.buf[sGfxArena.cur]);
+        if (used > sGfxArena.main_cap) {
+            gfx_arena_flag(0, used, sGfxArena.main_cap, 1);
+        }
+        total += used;
+    }
+    if (total > st->hwm_total) {
+        st->hwm_total = total;
+    }
+    st->frames++;
+
+    sGfxArena.busy[sGfxArena.cur] = 1;
+    return total;
+}
+
+/**
+ * RDP finished the oldest submitted buffer
+ */
+void gfx_arena_retire(void) {
+    if (sGfxArena.busy[sGfxArena.cur ^ 1]) {
+        sGfxArena.busy[sGfxArena.cur ^ 1] = 0;
+    } else {
+        sGfxArena.busy[sGfxArena.cur] = 0;
+    }
+}
+
+void gfx_arena_set_callback(GfxArenaFunc func) {
+    sGfxArenaFunc = func;
+}
+
+/**
+ * Telemetry for one split-screen mode
+ * @param num_views Viewports (1-4)
+ */
+GfxArenaStats *gfx_arena_get_stats(s32 num_views) {
+    if (num_views < 1) {
+        num_views = 1;
+    } else if (num_views > GFX_MAX_VIEWS) {
+        num_views = GFX_MAX_VIEWS;
+    }
+    return &sGfxArenaStats[num_views - 1];
+}
+
+#endif /* NON_MATCHING */
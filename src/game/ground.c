@@ -0,0 +1,218 @@
+/**
+ * ground.c - Per-car ground height cache
+ *
+ * Contacts are in display coordinates (Y up): x, ground height, z.
+ * The plane fit is least squares about the contact centroid,
+ *   y = cy + b (x - cx) + c (z - cz)
+ * so four wheels on a flat or banked road reproduce the road exactly and
+ * the residual check catches anything that is not one surface.
+ *
+ * Grid vertex (i, j) sits at (x0 + i * step, z0 + j * step); a query
+ * bilinearly interpolates the four vertices of its cell. The filled
+ * mask marks vertices that hold a height for the patch's frame.
+ */
+
+#include "types.h"
+#include "game/ground.h"
+
+#ifdef NON_MATCHING
+
+extern f32 replay_start(f32 x, f32 z);      /* Full ground query (game.c) */
+
+#define GROUND_STEP     (2.0f * GROUND_HALF_EXTENT / (f32)(GROUND_GRID - 1))
+
+typedef struct GroundPatch {
+    f32     x0, z0;             /* Grid minimum corner */
+    f32     y[GROUND_GRID][GROUND_GRID];
+    u16     filled;             /* Bit i * GROUND_GRID + j */
+    u16     pad;
+    u32     frame;              /* sGroundFrame when published */
+} GroundPatch;
+
+static GroundPatch sGroundPatches[GROUND_MAX_CARS];
+static u32 sGroundFrame = 1;
+static GroundStats sGroundStats;
+
+/**
+ * ground_cache_begin_frame - Invalidate every car's grid
+ *
+ * Called from update_game_data just before the cars publish their tire
+ * contacts, so the grids stay valid for the whole rendered frame.
+ */
+void ground_cache_begin_frame(void) {
+    sGroundFrame++;
+    sGroundStats.frames++;
+}
+
+/**
+ * ground_fit_plane - Least-squares plane through the contacts
+ * @return 1 if every contact is within GROUND_PLANAR_TOL of the plane
+ */
+static s32 ground_fit_plane(f32 contacts[4][3], f32 *cx, f32 *cy, f32 *cz,
+                            f32 *b, f32 *c) {
+    f32 sxx, sxz, szz, sxy, szy;
+    f32 dx, dy, dz, det, r;
+    s32 i;
+
+    *cx = (contacts[0][0] + contacts[1][0] + contacts[2][0] + contacts[3][0]) * 0.25f;
+    *cy = (contacts[0][1] + contacts[1][1] + contacts[2][1] + contacts[3][1]) * 0.25f;
+    *cz = (contacts[0][2] + contacts[1][2] + contacts[2][2] + contacts[3][2]) * 0.25f;
+
+    sxx = sxz = szz = sxy = szy = 0.0f;
+    for (i = 0; i < 4; i++) {
+        dx = contacts[i][0] - *cx;
+        dy = contacts[i][1] - *cy;
+        dz = contacts[i][2] - *cz;
+        sxx += dx * dx;
+        sxz += dx * dz;
+        szz += dz * dz;
+        sxy += dx * dy;
+        szy += dz * dy;
+    }
+
+    /* Contacts on a line (or a point) do not define a plane */
+    det = sxx * szz - sxz * sxz;
+    if (det < 1.0e-4f * (sxx + szz) * (sxx + szz) || det <= 0.0f) {
+        return 0;
+    }
+
+    *b = (sxy * szz - szy * sxz) / det;
+    *c = (szy * sxx - sxy * sxz) / det;
+
+    for (i = 0; i < 4; i++) {
+        r = contacts[i][1] - (*cy + *b * (contacts[i][0] - *cx) +
+                              *c * (contacts[i][2] - *cz));
+        if (r > GROUND_PLANAR_TOL || r < -GROUND_PLANAR_TOL) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * ground_cache_set_car - Publish a car's tire contacts for this frame
+ * @param slot Car slot (0 to GROUND_MAX_CARS - 1)
+ * @param contacts Ground point under each tire (x, y, z)
+ */
+void ground_cache_set_car(s32 slot, f32 contacts[4][3]) {
+    GroundPatch *patch;
+    f32 cx, cy, cz, b, c;
+    f32 row, dz;
+    s32 i, j;
+
+    if (slot < 0 || slot >= GROUND_MAX_CARS) {
+        return;
+    }
+    patch = &sGroundPatches[slot];
+
+    sGroundStats.patches++;
+
+    if (!ground_fit_plane(contacts, &cx, &cy, &cz, &b, &c)) {
+        /* Centre on the contacts anyway; vertices fill on demand */
+        patch->x0 = cx - GROUND_HALF_EXTENT;
+        patch->z0 = cz - GROUND_HALF_EXTENT;
+        patch->filled = 0;
+        patch->frame = sGroundFrame;
+        return;
+    }
+
+    patch->x0 = cx - GROUND_HALF_EXTENT;
+    patch->z0 = cz - GROUND_HALF_EXTENT;
+    for (j = 0; j < GROUND_GRID; j++) {
+        dz = patch->z0 + (f32)j * GROUND_STEP - cz;
+        row = cy + c * dz;
+        for (i = 0; i < GROUND_GRID; i++) {
+            patch->y[i][j] = row + b * (patch->x0 + (f32)i * GROUND_STEP - cx);
+        }
+    }
+    patch->filled = (u16)((1U << (GROUND_GRID * GROUND_GRID)) - 1);
+    patch->frame = sGroundFrame;
+
+    sGroundStats.planar++;
+}
+
+/**
+ * ground_patch_vertex - Height at a grid vertex, filling it if needed
+ */
+static f32 ground_patch_vertex(GroundPatch *patch, s32 i, s32 j) {
+    u16 bit = (u16)(1U << (i * GROUND_GRID + j));
+
+    if (!(patch->filled & bit)) {
+        patch->y[i][j] = replay_start(patch->x0 + (f32)i * GROUND_STEP,
+                                      patch->z0 + (f32)j * GROUND_STEP);
+        patch->filled |= bit;
+        sGroundStats.fills++;
+    }
+    return patch->y[i][j];
+}
+
+/**
+ * ground_cache_query - Ground height from a car grid
+ * @param x X coordinate
+ * @param z Z coordinate
+ * @param y Output: ground height
+ * @return 1 if a car published this frame covers (x, z), else 0
+ */
+s32 ground_cache_query(f32 x, f32 z, f32 *y) {
+    GroundPatch *patch;
+    f32 u, v, fu, fv, y0, y1;
+    s32 slot, i, j;
+
+    sGroundStats.queries++;
+
+    for (slot = 0; slot < GROUND_MAX_CARS; slot++) {
+        patch = &sGroundPatches[slot];
+        if (patch->frame != sGroundFrame) {
+            continue;
+        }
+
+        u = (x - patch->x0) * (1.0f / GROUND_STEP);
+        v = (z - patch->z0) * (1.0f / GROUND_STEP);
+        if (u < 0.0f || v < 0.0f ||
+            u > (f32)(GROUND_GRID - 1) || v > (f32)(GROUND_GRID - 1)) {
+            continue;
+        }
+
+        /* Far edge belongs to the last cell */
+        i = (s32)u;
+        j = (s32)v;
+        if (i > GROUND_GRID - 2) i = GROUND_GRID - 2;
+        if (j > GROUND_GRID - 2) j = GROUND_GRID - 2;
+        fu = u - (f32)i;
+        fv = v - (f32)j;
+
+        y0 = ground_patch_vertex(patch, i, j);
+        y0 += (ground_patch_vertex(patch, i + 1, j) - y0) * fu;
+        y1 = ground_patch_vertex(patch, i, j + 1);
+        y1 += (ground_patch_vertex(patch, i + 1, j + 1) - y1) * fu;
+        *y = y0 + (y1 - y0) * fv;
+
+        sGroundStats.hits++;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * ground_get_y - Ground height, cached near cars, full query elsewhere
+ * @param x X coordinate
+ * @param z Z coordinate
+ * @return Ground Y height
+ */
+f32 ground_get_y(f32 x, f32 z) {
+    f32 y;
+
+    if (ground_cache_query(x, z, &y)) {
+        return y;
+    }
+
+    sGroundStats.fallbacks++;
+    return replay_start(x, z);
+}
+
+GroundStats *ground_get_stats(void) {
+    return &sGroundStats;
+}
+
+#endif /* NON_MATCHING */
@@ -17,6 +17,8 @@
 #include "types.h"
 #include "PR/os_thread.h"
 #include "PR/os_message.h"
+#include "PR/os_sctrace.h"
+#include "PR/os_sched.h"
 #include "game/game.h"
 
 /*===========================================================================*/
@@ -40,6 +42,9 @@ extern void osScSetVideoMode(s32 a0, s32 a1);
 extern void *osScGetFrameCount(void);
 extern void osScCreateThread(void *a0, void *a1, s32 a2, void *a3, s32 a4);
 extern void osScStartRetrace(void *a0, void *a1, void *a2);
+
+/* Render detail pressure hook (render.c) */
+extern void render_frame_pressure(s32 level, u32 predicted, u32 budget);
 /* osJamMesg now declared in PR/os_message.h */
 
 /*===========================================================================*/
@@ -95,8 +100,13 @@ s16 last_track_loaded;      /* Last track loaded, -1 = none */
 extern void game_late_init(void);       /* 0x800EEA7C */
 extern void sound_init(void);           /* 0x800A4934 */
 extern void audio_start(void);          /* 0x800A48C8 */
+extern void render_init(void);          /* render.c */
+extern void init_model_task(void);      /* car.c - model thread and timing */
+extern void Update_MDrive(void);        /* car.c - per-frame model handoff */
 extern void game_frame_update(void);    /* 0x800EE5DC - per-frame game logic */
 extern void game_loop(void);            /* 0x800FD464 - main game loop */
+extern void sndUpdate(void);            /* sound.c - per-frame sound queue */
+extern void audio_frame_update(void);   /* game.c - per-frame audio work */
 
 /*===========================================================================*/
 /*                            FORWARD DECLARATIONS                           */
@@ -214,6 +224,14 @@ static void thread1_entry(void *arg) {
     osCreateScheduler(0x96, gViModeTable, gViModeLan1, 0xC8);
     osScSetVideoMode(0, 0);
 
+    /* Start the scheduler timeline (dump with osScTraceExport) */
+    SC_TRACE_ENABLE(1);
+
+#ifdef NON_MATCHING
+    /* Shed render detail before the RDP misses a retrace */
+    osScSetPressureCallback(render_frame_pressure);
+#endif
+
     /* Create game_init thread (thread 6) */
     osCreateThread(gInitThread, 6, game_init_thread, arg,
                    gInitThreadStack + 0x960, 4);
@@ -293,6 +311,13 @@ static void game_init_thread(void *arg) {
     /* Late initialization (arcade: part of init() sequence) */
     game_late_init();
     sound_init();
+#ifdef NON_MATCHING
+    /* Display list arena, texture cache and render state */
+    render_init();
+
+    /* Model thread (arcade init(): init_model_task) */
+    init_model_task();
+#endif
 
     /* Create main game thread (thread 7) */
     osCreateThread(gGameThread, 7, (void *)game_thread_entry, arg,
@@ -319,7 +344,9 @@ static void game_init_thread(void *arg) {
 
     /* Main loop - runs per-frame game logic */
     for (;;) {
+        SC_TRACE_MARK_BEGIN(SC_MARK_GAME_FRAME);
         game_frame_update();
+        SC_TRACE_MARK_END(SC_MARK_GAME_FRAME);
     }
 }
 
@@ -338,7 +365,20 @@ static void game_thread_entry(void *arg) {
 
     /* Main rendering loop (arcade: game_loop()) */
     for (;;) {
+        SC_TRACE_MARK_BEGIN(SC_MARK_GAME_LOOP);
+#ifdef NON_MATCHING
+        /* Collect the model batch and hand car state to this frame */
+        Update_MDrive();
+#endif
         game_loop();
+        SC_TRACE_MARK_END(SC_MARK_GAME_LOOP);
+#ifdef NON_MATCHING
+        /* Publish the frame's staged sound commands. audio_thread_proc has
+         * no loop in this tree yet, so the audio frame (ring drain and voice
+         * re-rank) runs here until it does. */
+        sndUpdate();
+        audio_frame_update();
+#endif
     }
 }
 
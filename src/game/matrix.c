@@ -10,6 +10,7 @@
  */
 
 #include "types.h"
+#include "game/matrix.h"
 
 /**
  * N64 matrix format (64 bytes):
@@ -133,3 +134,225 @@ void guMtxIdent(u16 *mtx) {
     guMtxIdentF(temp);
     guMtxF2L(temp, mtx);
 }
+
+#ifdef NON_MATCHING
+
+/*
+ * ==========================================================================
+ * Batch conversion and matrix arena
+ * ==========================================================================
+ *
+ * Mtx layout: words 0-7 hold the integer halves of element pairs
+ * (row-major, first element in the high half), words 8-15 the fraction
+ * halves in the same order.
+ */
+
+#ifdef HOST_BUILD
+
+#include <string.h>
+
+typedef f32 v16f32 __attribute__((vector_size(64)));
+typedef s32 v16s32 __attribute__((vector_size(64)));
+typedef u32 v8u32 __attribute__((vector_size(32)));
+
+/**
+ * Convert one matrix with all 16 lanes at once
+ */
+static void mtx_f2l_one(const f32 *src, u32 *dst) {
+    v16f32 f;
+    v16s32 x;
+    v8u32 ev, od, hi, lo;
+
+    memcpy(&f, src, sizeof(f));
+    x = __builtin_convertvector(f * 65536.0f, v16s32);
+
+    ev = (v8u32)__builtin_shufflevector(x, x, 0, 2, 4, 6, 8, 10, 12, 14);
+    od = (v8u32)__builtin_shufflevector(x, x, 1, 3, 5, 7, 9, 11, 13, 15);
+    hi = (ev & 0xFFFF0000u) | (od >> 16);
+    lo = (ev << 16) | (od & 0xFFFFu);
+
+    memcpy(dst, &hi, sizeof(hi));
+    memcpy(dst + 8, &lo, sizeof(lo));
+}
+
+#else
+
+extern void *memcpy(void *dst, const void *src, u32 n);
+
+#define MTX_F2L_PAIR(k)                                             \
+    a = (s32)(src[(k) * 2] * 65536.0f);                             \
+    b = (s32)(src[(k) * 2 + 1] * 65536.0f);                         \
+    dst[k] = ((u32)a & 0xFFFF0000) | ((u32)b >> 16);                \
+    dst[(k) + 8] = ((u32)a << 16) | ((u32)b & 0xFFFF)
+
+/**
+ * Convert one matrix, fully unrolled so the FPU conversions pipeline
+ */
+static void mtx_f2l_one(const f32 *src, u32 *dst) {
+    s32 a, b;
+
+    MTX_F2L_PAIR(0);
+    MTX_F2L_PAIR(1);
+    MTX_F2L_PAIR(2);
+    MTX_F2L_PAIR(3);
+    MTX_F2L_PAIR(4);
+    MTX_F2L_PAIR(5);
+    MTX_F2L_PAIR(6);
+    MTX_F2L_PAIR(7);
+}
+
+#endif /* HOST_BUILD */
+
+static Mtx sMtxArena[2][MTX_ARENA_SIZE];
+static s32 sMtxArenaBuf;
+static s32 sMtxArenaUsed;
+
+static f32 sMtxCacheSrc[MTX_CACHE_SIZE][4][4];
+static Mtx sMtxCache[MTX_CACHE_SIZE];
+static u32 sMtxCacheUsed[MTX_CACHE_SIZE / 32];
+static u32 sMtxCacheDirty[MTX_CACHE_SIZE / 32];
+
+static MtxStats sMtxStats;
+
+/**
+ * Convert n float matrices to RSP fixed point
+ * @param src Float matrices
+ * @param dst Output Mtx array
+ * @param n Count
+ */
+void guMtxF2L_batch(const f32 (*src)[4][4], Mtx *dst, s32 n) {
+    s32 i;
+
+    for (i = 0; i < n; i++) {
+        mtx_f2l_one(&src[i][0][0], &dst[i][0][0]);
+    }
+    sMtxStats.batches++;
+}
+
+/**
+ * Start a frame: flip to the arena half the RSP is not reading
+ */
+void mtx_arena_begin_frame(void) {
+    if (sMtxStats.frames > 0) {
+        sMtxStats.dynamic_last = sMtxArenaUsed;
+        if ((u32)sMtxArenaUsed > sMtxStats.dynamic_hwm) {
+            sMtxStats.dynamic_hwm = sMtxArenaUsed;
+        }
+    }
+    sMtxStats.frames++;
+
+    sMtxArenaBuf ^= 1;
+    sMtxArenaUsed = 0;
+}
+
+/**
+ * Convert n dynamic matrices into this frame's arena
+ * @return Converted matrices (valid until the frame after next), or NULL
+ *         if the arena is full
+ */
+Mtx *mtx_arena_convert(const f32 (*src)[4][4], s32 n) {
+    Mtx *dst;
+
+    if (n <= 0 || sMtxArenaUsed + n > MTX_ARENA_SIZE) {
+        sMtxStats.overflows++;
+        return NULL;
+    }
+
+    dst = &sMtxArena[sMtxArenaBuf][sMtxArenaUsed];
+    sMtxArenaUsed += n;
+    guMtxF2L_batch(src, dst, n);
+    return dst;
+}
+
+/**
+ * Claim a static matrix slot
+ * @return Slot index, or -1 if the cache is full
+ */
+s32 mtx_cache_alloc(void) {
+    s32 i;
+
+    for (i = 0; i < MTX_CACHE_SIZE; i++) {
+        if (!(sMtxCacheUsed[i >> 5] & (1U << (i & 31)))) {
+            sMtxCacheUsed[i >> 5] |= 1U << (i & 31);
+            sMtxCacheDirty[i >> 5] &= ~(1U << (i & 31));
+            guMtxIdentF(sMtxCacheSrc[i]);
+            mtx_f2l_one(&sMtxCacheSrc[i][0][0], &sMtxCache[i][0][0]);
+            return i;
+        }
+    }
+    return -1;
+}
+
+void mtx_cache_free(s32 slot) {
+    if (slot >= 0 && slot < MTX_CACHE_SIZE) {
+        sMtxCacheUsed[slot >> 5] &= ~(1U << (slot & 31));
+        sMtxCacheDirty[slot >> 5] &= ~(1U << (slot & 31));
+    }
+}
+
+/**
+ * Update a static matrix; conversion is deferred until it is next used
+ *
+ * The slot's Mtx is rewritten in place, so only move static objects
+ * between frames (the RSP may still be reading last frame's copy).
+ */
+void mtx_cache_set(s32 slot, const f32 src[4][4]) {
+    if (slot < 0 || slot >= MTX_CACHE_SIZE) {
+        return;
+    }
+    memcpy(sMtxCacheSrc[slot], src, sizeof(sMtxCacheSrc[slot]));
+    sMtxCacheDirty[slot >> 5] |= 1U << (slot & 31);
+}
+
+/**
+ * Convert every dirty static matrix in contiguous batches
+ */
+void mtx_cache_flush(void) {
+    s32 w, i, start;
+    u32 dirty;
+
+    for (w = 0; w < MTX_CACHE_SIZE / 32; w++) {
+        dirty = sMtxCacheDirty[w];
+        i = 0;
+        while (dirty != 0) {
+            /* Skip clean slots, then take the run of dirty ones */
+            while (!(dirty & 1)) {
+                dirty >>= 1;
+                i++;
+            }
+            start = i;
+            while (dirty & 1) {
+                dirty >>= 1;
+                i++;
+            }
+            guMtxF2L_batch((const f32 (*)[4][4])sMtxCacheSrc[w * 32 + start],
+                           &sMtxCache[w * 32 + start], i - start);
+            sMtxStats.cache_converted += i - start;
+        }
+        sMtxCacheDirty[w] = 0;
+    }
+}
+
+/**
+ * Fetch a static matrix, converting it first only if it changed
+ */
+Mtx *mtx_cache_get(s32 slot) {
+    if (slot < 0 || slot >= MTX_CACHE_SIZE) {
+        return NULL;
+    }
+
+    if (sMtxCacheDirty[slot >> 5] & (1U << (slot & 31))) {
+        mtx_f2l_one(&sMtxCacheSrc[slot][0][0], &sMtxCache[slot][0][0]);
+        sMtxCacheDirty[slot >> 5] &= ~(1U << (slot & 31));
+        sMtxStats.cache_converted++;
+    } else {
+        sMtxStats.cache_hits++;
+    }
+    return &sMtxCache[slot];
+}
+
+MtxStats *mtx_get_stats(void) {
+    return &sMtxStats;
+}
+
+#endif /* NON_MATCHING */
@@ -187,6 +187,48 @@ void maxpath_load(s32 track_id) {
     /* Real implementation would load from ROM */
 }
 
+/**
+ * maxpath_load_data - Attach streamed maxpath data
+ *
+ * The track's maxpath section is a sequence of MaxPathHeader blocks,
+ * each followed by its num_points MaxPathPoint records. Pointers are
+ * taken in place; the data stays owned by the track loader.
+ *
+ * @param data Section data
+ * @param size Section size in bytes
+ */
+void maxpath_load_data(void *data, u32 size) {
+    u8 *ptr, *end;
+    MaxPathHeader *hdr;
+    u32 bytes;
+
+    ptr = (u8 *)data;
+    end = ptr + size;
+    gNumMPaths = 0;
+
+    while (gNumMPaths < MAX_MPATHS && ptr + sizeof(MaxPathHeader) <= end) {
+        hdr = (MaxPathHeader *)ptr;
+        if (hdr->num_points <= 0 || hdr->num_points > MAXMPATH) {
+            break;
+        }
+        bytes = sizeof(MaxPathHeader) + hdr->num_points * sizeof(MaxPathPoint);
+        if (ptr + bytes > end) {
+            break;
+        }
+
+        gMPathHeaders[gNumMPaths] = hdr;
+        gMPathTables[gNumMPaths] = (MaxPathPoint *)(ptr + sizeof(MaxPathHeader));
+        gMPathList[gNumMPaths] = gNumMPaths;
+        gNumMPaths++;
+        ptr += bytes;
+    }
+
+    if (gNumMPaths > 0) {
+        gMaxPath = gMPathHeaders[0];
+        gMPathPoints = gMPathTables[0];
+    }
+}
+
 /**
  * maxpath_init_car - Initialize maxpath control for one car
  *
@@ -809,6 +851,42 @@ s32 maxpath_get_lap(s32 car_index) {
     return gMPCtl[car_index].lap;
 }
 
+/**
+ * maxpath_get_section - Which part of the lap a car is in
+ *
+ * Splits the lap into equal runs of path points, counted from the
+ * lap start point.
+ *
+ * @param car_index Car index
+ * @param num_sections Number of sections per lap
+ * @return Section (0 to num_sections - 1), or -1 without an active path
+ */
+s32 maxpath_get_section(s32 car_index, s32 num_sections) {
+    MaxPathControl *ctl;
+    MaxPathHeader *header;
+    s32 offset;
+
+    if (car_index < 0 || car_index >= MAX_LINKS || num_sections <= 0) {
+        return -1;
+    }
+
+    ctl = &gMPCtl[car_index];
+    if (!ctl->active || ctl->path_index < 0 || ctl->path_index >= gNumMPaths) {
+        return -1;
+    }
+
+    header = gMPathHeaders[ctl->path_index];
+    if (header == NULL || header->num_in_lap <= 0) {
+        return -1;
+    }
+
+    offset = (ctl->current_point - header->lap_start) % header->num_in_lap;
+    if (offset < 0) {
+        offset += header->num_in_lap;
+    }
+    return offset * num_sections / header->num_in_lap;
+}
+
 /**
  * maxpath_start_record - Start recording a new path
  *
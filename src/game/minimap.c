@@ -6,7 +6,10 @@
 
 #include "game/minimap.h"
 
+#include "game/maxpath.h"
+
 /* External functions */
+extern f32 sqrtf(f32 x);
 extern f32 sinf(f32 x);
 extern f32 cosf(f32 x);
 extern f32 atan2f(f32 y, f32 x);
@@ -19,6 +22,10 @@ extern void *track_get_checkpoint(s32 index);
 extern f32 gCarPositions[8][3];
 extern f32 gCarRotations[8];
 
+/* Frame display list cursor */
+extern Gfx **gfx_dl_ptr;
+extern s32 gfx_frame_reserve(Gfx *cur, u32 size);  /* gfx.c */
+
 /* Global minimap state */
 MinimapState gMinimap;
 
@@ -60,6 +67,16 @@ static const s16 sPositionOffsets[NUM_MINIMAP_POSITIONS][2] = {
 #define SCREEN_WIDTH    320
 #define SCREEN_HEIGHT   240
 
+/* Douglas-Peucker tolerance per LOD, in full-size map pixels */
+static const f32 sOutlineTolerance[MINIMAP_NUM_LODS] = {
+    1.0f, 2.0f, 4.0f
+};
+
+/* Outline build scratch */
+static f32 sOutlineSrc[MINIMAP_MAX_SRC_POINTS][2];
+static u8 sOutlineKeep[MINIMAP_MAX_SRC_POINTS];
+static s16 sOutlineStack[MINIMAP_MAX_SRC_POINTS][2];
+
 /* -------------------------------------------------------------------------- */
 /* Initialization                                                              */
 /* -------------------------------------------------------------------------- */
@@ -142,21 +159,205 @@ void minimap_unload_track(void) {
 }
 
 /**
- * Generate map from checkpoint positions
+ * Squared distance from point p to segment a-b
+ */
+static f32 minimap_seg_dist_sq(f32 *p, f32 *a, f32 *b) {
+    f32 abx, aby, apx, apy, len_sq, t;
+
+    abx = b[0] - a[0];
+    aby = b[1] - a[1];
+    apx = p[0] - a[0];
+    apy = p[1] - a[1];
+    len_sq = abx * abx + aby * aby;
+
+    if (len_sq > 0.0f) {
+        t = (apx * abx + apy * aby) / len_sq;
+        if (t < 0.0f) {
+            t = 0.0f;
+        } else if (t > 1.0f) {
+            t = 1.0f;
+        }
+        apx -= t * abx;
+        apy -= t * aby;
+    }
+
+    return apx * apx + apy * apy;
+}
+
+/**
+ * Douglas-Peucker simplification of the source outline
+ *
+ * Uses an explicit span stack instead of recursion.
+ *
+ * @param count Source point count
+ * @param tol Tolerance in map pixels
+ * @return Number of points kept
+ */
+static s32 minimap_simplify(s32 count, f32 tol) {
+    s32 sp, first, last, i, far_i, kept;
+    f32 d, far_d, tol_sq;
+
+    for (i = 0; i < count; i++) {
+        sOutlineKeep[i] = 0;
+    }
+    sOutlineKeep[0] = 1;
+    sOutlineKeep[count - 1] = 1;
+
+    tol_sq = tol * tol;
+    sp = 0;
+    sOutlineStack[sp][0] = 0;
+    sOutlineStack[sp][1] = (s16)(count - 1);
+    sp++;
+
+    while (sp > 0) {
+        sp--;
+        first = sOutlineStack[sp][0];
+        last = sOutlineStack[sp][1];
+
+        far_i = -1;
+        far_d = tol_sq;
+        for (i = first + 1; i < last; i++) {
+            d = minimap_seg_dist_sq(sOutlineSrc[i], sOutlineSrc[first], sOutlineSrc[last]);
+            if (d > far_d) {
+                far_d = d;
+                far_i = i;
+            }
+        }
+
+        if (far_i >= 0) {
+            sOutlineKeep[far_i] = 1;
+            sOutlineStack[sp][0] = (s16)first;
+            sOutlineStack[sp][1] = (s16)far_i;
+            sp++;
+            sOutlineStack[sp][0] = (s16)far_i;
+            sOutlineStack[sp][1] = (s16)last;
+            sp++;
+        }
+    }
+
+    kept = 0;
+    for (i = 0; i < count; i++) {
+        kept += sOutlineKeep[i];
+    }
+    return kept;
+}
+
+/**
+ * Generate map outline from the track centerline
+ *
+ * Samples the primary maxpath (or the checkpoints when no path is
+ * loaded), projects it once into full-size map pixels and simplifies
+ * it into MINIMAP_NUM_LODS outlines. minimap_draw_track only offsets
+ * and scales these; it never touches the full-resolution path.
  */
 void minimap_generate_from_checkpoints(void) {
-    /* Would build map outline from checkpoint data */
-    /* For now, use placeholder bounds */
+    static TrackMap sDefaultMap;
+    TrackMap *map;
+    MapOutlineLod *lod;
+    MaxPathPoint *path;
+    f32 *pos;
+    f32 sx, sz, tol;
+    s32 num, step, count, lod_i, i, n;
 
     if (gMinimap.track_map == NULL) {
-        static TrackMap sDefaultMap;
         gMinimap.track_map = &sDefaultMap;
     }
+    map = gMinimap.track_map;
+
+    map->min_x = -1000.0f;
+    map->max_x = 1000.0f;
+    map->min_z = -1000.0f;
+    map->max_z = 1000.0f;
+    for (lod_i = 0; lod_i < MINIMAP_NUM_LODS; lod_i++) {
+        map->lods[lod_i].count = 0;
+    }
+
+    /* Gather centerline points in world XZ */
+    count = 0;
+    if (gNumMPaths > 0 && gMPathTables[0] != NULL && gMPathHeaders[0] != NULL) {
+        path = gMPathTables[0];
+        num = gMPathHeaders[0]->num_points;
+        step = (num + MINIMAP_MAX_SRC_POINTS - 2) / (MINIMAP_MAX_SRC_POINTS - 1);
+        if (step < 1) {
+            step = 1;
+        }
+        for (i = 0; i < num && count < MINIMAP_MAX_SRC_POINTS - 1; i += step) {
+            sOutlineSrc[count][0] = path[i].pos[0];
+            sOutlineSrc[count][1] = path[i].pos[2];
+            count++;
+        }
+    } else {
+        num = track_get_num_checkpoints();
+        for (i = 0; i < num && count < MINIMAP_MAX_SRC_POINTS - 1; i++) {
+            pos = (f32 *)track_get_checkpoint(i);
+            sOutlineSrc[count][0] = pos[0];
+            sOutlineSrc[count][1] = pos[2];
+            count++;
+        }
+    }
+
+    /* Both the path and the checkpoints form a lap; close the loop */
+    if (count > 0) {
+        sOutlineSrc[count][0] = sOutlineSrc[0][0];
+        sOutlineSrc[count][1] = sOutlineSrc[0][1];
+        count++;
+    }
+
+    if (count < 2) {
+        return;
+    }
 
-    gMinimap.track_map->min_x = -1000.0f;
-    gMinimap.track_map->max_x = 1000.0f;
-    gMinimap.track_map->min_z = -1000.0f;
-    gMinimap.track_map->max_z = 1000.0f;
+    /* Bounds */
+    map->min_x = map->max_x = sOutlineSrc[0][0];
+    map->min_z = map->max_z = sOutlineSrc[0][1];
+    for (i = 1; i < count; i++) {
+        if (sOutlineSrc[i][0] < map->min_x) map->min_x = sOutlineSrc[i][0];
+        if (sOutlineSrc[i][0] > map->max_x) map->max_x = sOutlineSrc[i][0];
+        if (sOutlineSrc[i][1] < map->min_z) map->min_z = sOutlineSrc[i][1];
+        if (sOutlineSrc[i][1] > map->max_z) map->max_z = sOutlineSrc[i][1];
+    }
+
+    /* Project once into full-size map pixels (same mapping as world_to_screen) */
+    sx = map->max_x - map->min_x;
+    sz = map->max_z - map->min_z;
+    sx = (sx > 0.0f) ? (f32)MINIMAP_SIZE_FULL / sx : 0.0f;
+    sz = (sz > 0.0f) ? (f32)MINIMAP_SIZE_FULL / sz : 0.0f;
+    for (i = 0; i < count; i++) {
+        sOutlineSrc[i][0] = (sOutlineSrc[i][0] - map->min_x) * sx;
+        sOutlineSrc[i][1] = (sOutlineSrc[i][1] - map->min_z) * sz;
+    }
+
+    /* Simplify each LOD, widening the tolerance until it fits */
+    for (lod_i = 0; lod_i < MINIMAP_NUM_LODS; lod_i++) {
+        lod = &map->lods[lod_i];
+        tol = sOutlineTolerance[lod_i];
+        while (minimap_simplify(count, tol) > MINIMAP_MAX_LOD_POINTS) {
+            tol *= 2.0f;
+        }
+
+        n = 0;
+        for (i = 0; i < count; i++) {
+            if (sOutlineKeep[i]) {
+                lod->pts[n][0] = (s16)(sOutlineSrc[i][0] * (1 << MINIMAP_OUTLINE_SHIFT));
+                lod->pts[n][1] = (s16)(sOutlineSrc[i][1] * (1 << MINIMAP_OUTLINE_SHIFT));
+                n++;
+            }
+        }
+        lod->count = n;
+    }
+}
+
+/**
+ * Pick outline LOD for the current minimap size
+ */
+s32 minimap_select_lod(void) {
+    if (gMinimap.width >= MINIMAP_SIZE_FULL) {
+        return 0;
+    }
+    if (gMinimap.width >= MINIMAP_SIZE_MEDIUM) {
+        return 1;
+    }
+    return 2;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -575,8 +776,189 @@ void minimap_draw(void) {
     minimap_draw_markers();
 }
 
+/**
+ * Emit one FILLRECT covering pixels x0..x1, y0..y1, clipped to the map window
+ */
+static Gfx *minimap_emit_rect(Gfx *g, s32 x0, s32 y0, s32 x1, s32 y1) {
+    s32 t;
+
+    if (x0 > x1) {
+        t = x0; x0 = x1; x1 = t;
+    }
+    if (y0 > y1) {
+        t = y0; y0 = y1; y1 = t;
+    }
+    x1++;                               /* Lower-right edge is exclusive */
+    y1++;
+    if (x0 < gMinimap.screen_x) x0 = gMinimap.screen_x;
+    if (y0 < gMinimap.screen_y) y0 = gMinimap.screen_y;
+    if (x1 > gMinimap.screen_x + gMinimap.width) x1 = gMinimap.screen_x + gMinimap.width;
+    if (y1 > gMinimap.screen_y + gMinimap.height) y1 = gMinimap.screen_y + gMinimap.height;
+    if (x0 >= x1 || y0 >= y1) {
+        return g;
+    }
+
+    g->words.w0 = 0xF6000000 | ((u32)(x1 << 2) << 12) | (u32)(y1 << 2);
+    g->words.w1 = ((u32)(x0 << 2) << 12) | (u32)(y0 << 2);
+    return g + 1;                       /* G_FILLRECT */
+}
+
+/**
+ * Rasterize one outline segment as runs along its major axis
+ *
+ * Each run of pixels sharing a minor coordinate becomes one rectangle,
+ * so a segment costs (minor extent + 1) commands rather than one per pixel.
+ */
+static Gfx *minimap_emit_segment(Gfx *g, s32 x0, s32 y0, s32 x1, s32 y1) {
+    s32 dx, dy, sx, sy, major, minor, err, k;
+    s32 x, y, rx, ry;
+
+    dx = x1 - x0;
+    dy = y1 - y0;
+    sx = (dx < 0) ? -1 : 1;
+    sy = (dy < 0) ? -1 : 1;
+    dx *= sx;
+    dy *= sy;
+    major = (dx > dy) ? dx : dy;
+    minor = (dx > dy) ? dy : dx;
+
+    x = rx = x0;
+    y = ry = y0;
+    err = major / 2;
+    for (k = 0; k < major; k++) {
+        err -= minor;
+        if (err < 0) {
+            /* Minor axis steps after this pixel; close the run */
+            g = minimap_emit_rect(g, rx, ry, x, y);
+            err += major;
+            x += sx;
+            y += sy;
+            rx = x;
+            ry = y;
+        } else if (dx > dy) {
+            x += sx;
+        } else {
+            y += sy;
+        }
+    }
+    return minimap_emit_rect(g, rx, ry, x, y);
+}
+
+/**
+ * Most commands minimap_emit_segment writes for a segment: one per run,
+ * and a segment has (minor extent + 1) runs
+ */
+static s32 minimap_segment_cmds(s32 x0, s32 y0, s32 x1, s32 y1) {
+    s32 dx, dy;
+
+    dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+    dy = (y1 > y0) ? y1 - y0 : y0 - y1;
+    return ((dx > dy) ? dy : dx) + 1;
+}
+
+/**
+ * Emit the screen-space outline batch into the frame display list
+ *
+ * The tree has no 2D line microcode path, so the outline is drawn as
+ * RDP-only fill rectangles: no vertices or matrices are loaded and the
+ * 3D projection is left alone. The batch is sized before anything is
+ * written; if the frame list cannot take all of it the outline is skipped
+ * for the frame.
+ */
+static void minimap_emit_outline(void) {
+    Gfx *g;
+    u32 cmds;
+    s32 i;
+
+    if (gMinimap.batch_count < 2) {
+        return;
+    }
+
+    cmds = 5;                           /* Sync and render state */
+    for (i = 0; i < gMinimap.batch_count - 1; i++) {
+        cmds += minimap_segment_cmds(gMinimap.batch[i][0], gMinimap.batch[i][1],
+                                     gMinimap.batch[i + 1][0], gMinimap.batch[i + 1][1]);
+    }
+
+    g = *gfx_dl_ptr;
+    if (!gfx_frame_reserve(g, cmds)) {
+        return;
+    }
+
+    g->words.w0 = 0xE7000000;           /* G_RDPPIPESYNC */
+    g->words.w1 = 0;
+    g++;
+    g->words.w0 = 0xE3000A01;           /* G_SETOTHERMODE_H: G_CYC_1CYCLE */
+    g->words.w1 = 0;
+    g++;
+    g->words.w0 = 0xFCFFFFFF;           /* G_SETCOMBINE: G_CC_PRIMITIVE */
+    g->words.w1 = 0xFFFDF6FB;
+    g++;
+    g->words.w0 = 0xE200001C;           /* G_SETOTHERMODE_L: G_RM_OPA_SURF */
+    g->words.w1 = 0x0F0A4000;
+    g++;
+    g->words.w0 = 0xFA000000;           /* G_SETPRIMCOLOR */
+    g->words.w1 = ((u32)gMinimap.track_color[0] << 24) |
+                  ((u32)gMinimap.track_color[1] << 16) |
+                  ((u32)gMinimap.track_color[2] << 8) |
+                  (u32)gMinimap.track_color[3];
+    g++;
+
+    for (i = 0; i < gMinimap.batch_count - 1; i++) {
+        g = minimap_emit_segment(g, gMinimap.batch[i][0], gMinimap.batch[i][1],
+                                 gMinimap.batch[i + 1][0], gMinimap.batch[i + 1][1]);
+    }
+    *gfx_dl_ptr = g;
+}
+
 void minimap_draw_track(void) {
-    /* Would draw track outline using line primitives */
+    MapOutlineLod *lod;
+    TrackMap *map;
+    f32 inv, cx, cz, nx, nz, sin_r, cos_r;
+    s32 scale_x, scale_z;
+    s32 i;
+
+    gMinimap.batch_count = 0;
+    map = gMinimap.track_map;
+    if (map == NULL) {
+        return;
+    }
+
+    lod = &map->lods[minimap_select_lod()];
+
+    if (gMinimap.mode == MINIMAP_MODE_ROTATING) {
+        /* Same transform as minimap_world_to_screen, but only over the
+         * simplified points */
+        inv = 1.0f / (f32)(MINIMAP_SIZE_FULL << MINIMAP_OUTLINE_SHIFT);
+        cx = (map->max_x > map->min_x) ?
+            (gMinimap.center_x - map->min_x) / (map->max_x - map->min_x) : 0.5f;
+        cz = (map->max_z > map->min_z) ?
+            (gMinimap.center_z - map->min_z) / (map->max_z - map->min_z) : 0.5f;
+        sin_r = sinf(gMinimap.rotation * 3.14159f / 180.0f);
+        cos_r = cosf(gMinimap.rotation * 3.14159f / 180.0f);
+
+        for (i = 0; i < lod->count; i++) {
+            nx = ((f32)lod->pts[i][0] * inv - cx) * gMinimap.zoom;
+            nz = ((f32)lod->pts[i][1] * inv - cz) * gMinimap.zoom;
+            gMinimap.batch[i][0] = gMinimap.screen_x +
+                (s16)((nx * cos_r - nz * sin_r + 0.5f) * gMinimap.width);
+            gMinimap.batch[i][1] = gMinimap.screen_y +
+                (s16)((nx * sin_r + nz * cos_r + 0.5f) * gMinimap.height);
+        }
+    } else {
+        /* Scale from full-size map space with integer math */
+        scale_x = ((s32)gMinimap.width << 16) / MINIMAP_SIZE_FULL;
+        scale_z = ((s32)gMinimap.height << 16) / MINIMAP_SIZE_FULL;
+        for (i = 0; i < lod->count; i++) {
+            gMinimap.batch[i][0] = gMinimap.screen_x +
+                (s16)((lod->pts[i][0] * scale_x) >> (16 + MINIMAP_OUTLINE_SHIFT));
+            gMinimap.batch[i][1] = gMinimap.screen_y +
+                (s16)((lod->pts[i][1] * scale_z) >> (16 + MINIMAP_OUTLINE_SHIFT));
+        }
+    }
+    gMinimap.batch_count = lod->count;
+
+    minimap_emit_outline();
 }
 
 void minimap_draw_markers(void) {
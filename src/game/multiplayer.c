@@ -6,6 +6,7 @@
  */
 
 #include "game/multiplayer.h"
+#include "PR/os_sched.h"
 
 /* External controller functions */
 extern s32 osContGetQuery(void *status);
@@ -13,8 +14,12 @@ extern s32 input_get_button_press(s32 controller, u16 button);
 extern s32 input_is_connected(s32 controller);
 
 /* External graphics functions */
-extern void gfx_set_viewport(s32 x, s32 y, s32 w, s32 h);
-extern void gfx_set_scissor(s32 x, s32 y, s32 w, s32 h);
+extern void render_set_viewport(s32 x, s32 y, s32 width, s32 height);
+
+/* External weather functions */
+extern void weather_set_views(s32 num_views);
+extern void weather_set_view_camera(s32 view, f32 *pos);
+extern f32 gCamPos[3];
 
 /* Button constants */
 #define BUTTON_START    0x1000
@@ -184,6 +189,11 @@ void mp_end_session(void) {
     gMultiplayer.active = 0;
     gMultiplayer.num_players = 0;
     gMultiplayer.in_race = 0;
+
+#ifdef NON_MATCHING
+    /* Back to one full-screen view at 60 fps */
+    osScSetFrameBudget(OS_SC_BUDGET_60HZ);
+#endif
 }
 
 /**
@@ -533,6 +543,14 @@ void mp_setup_viewports(void) {
         gMultiplayer.num_viewports = MP_MAX_PLAYERS;
     }
 
+    /* Rain volumes share one drop pool across viewports */
+    weather_set_views(gMultiplayer.num_viewports);
+
+#ifdef NON_MATCHING
+    /* Split screen runs at 30 fps: the RDP has two fields per frame */
+    osScSetFrameBudget(mp_is_split_screen() ? OS_SC_BUDGET_30HZ : OS_SC_BUDGET_60HZ);
+#endif
+
     /* Apply layouts */
     for (i = 0; i < MP_MAX_PLAYERS; i++) {
         player = &gMultiplayer.players[i];
@@ -580,8 +598,8 @@ void mp_set_viewport(s32 player) {
         return;
     }
 
-    gfx_set_viewport(vp->x, vp->y, vp->width, vp->height);
-    gfx_set_scissor(vp->x, vp->y, vp->width, vp->height);
+    /* Scissored to the same rectangle when its draws are flushed */
+    render_set_viewport(vp->x, vp->y, vp->width, vp->height);
 }
 
 /**
@@ -607,17 +625,29 @@ void mp_get_viewport_rect(s32 player, s16 *x, s16 *y, s16 *w, s16 *h) {
 
 /**
  * Apply viewport for rendering
+ *
+ * Called by render_scene once the player's camera is current: the
+ * player's split-screen rectangle (full screen outside split screen),
+ * and that view's rain volume anchored to the camera.
  */
 void mp_apply_viewport(s32 player) {
-    mp_set_viewport(player);
+    Viewport *vp;
+
+    vp = mp_get_viewport(player);
+    if (mp_is_split_screen() && vp != NULL && vp->active) {
+        mp_set_viewport(player);
+    } else {
+        mp_reset_viewport();
+    }
+
+    weather_set_view_camera(player, gCamPos);
 }
 
 /**
  * Reset to full screen viewport
  */
 void mp_reset_viewport(void) {
-    gfx_set_viewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
-    gfx_set_scissor(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    render_set_viewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -5,6 +5,9 @@
  */
 
 #include "game/particles.h"
+#ifdef NON_MATCHING
+#include "game/ground.h"
+#endif
 
 /* External functions */
 extern f32 sinf(f32 x);
@@ -860,8 +863,15 @@ void particles_pickup_effect(f32 *pos, s32 pickup_type) {
 /* -------------------------------------------------------------------------- */
 
 s32 particles_check_ground(Particle *p, f32 *ground_height, f32 *normal) {
+#ifdef NON_MATCHING
+    /* Near a car, use the ground its tires resolved this frame */
+    if (!ground_cache_query(p->pos[0], p->pos[2], ground_height)) {
+        *ground_height = 0.0f;
+    }
+#else
     /* Simple ground plane at y=0 */
     *ground_height = 0.0f;
+#endif
     normal[0] = 0.0f;
     normal[1] = 1.0f;
     normal[2] = 0.0f;
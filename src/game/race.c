@@ -18,6 +18,7 @@ extern s32 this_car;
 
 /* External functions */
 extern f32 sqrtf(f32 x);
+extern void track_stream_frame(void);
 
 /* Global race state */
 RaceState gRace;
@@ -116,6 +117,9 @@ void race_configure(RaceConfig *config) {
  * race_update - Per-frame race update
  */
 void race_update(void) {
+    /* Cosmetic track sections keep streaming after the race starts */
+    track_stream_frame();
+
     if (!(gRace.race_flags & RACE_FLAG_STARTED)) {
         return;
     }
@@ -21,6 +21,15 @@
 #include "types.h"
 #include "game/render.h"
 #include "game/gstate.h"
+#include "game/cull.h"
+#include "game/matrix.h"
+#include "game/texcache.h"
+#include "game/camera.h"
+#include "game/multiplayer.h"
+
+#ifdef HOST_BUILD
+#include <pthread.h>
+#endif
 
 /* ======================= EXTERNAL DECLARATIONS ======================== */
 
@@ -35,6 +44,11 @@ extern f32 sqrtf(f32 x);
 extern void *memset(void *s, s32 c, u32 n);
 extern void *memcpy(void *dst, const void *src, u32 n);
 
+/* Quality knobs driven by frame-time pressure */
+extern Gfx **gfx_dl_ptr;                  /* Frame display list cursor */
+extern void effects_set_density(u8 percent);
+extern void shadow_set_quality(s32 quality);
+
 /* ======================= GLOBAL VARIABLES ======================== */
 
 /* Current render state */
@@ -58,6 +72,87 @@ s32 gObjList[600];  /* MAX_TRK_OBJS from arcade */
 
 /* ======================= STATIC VARIABLES ======================== */
 
+/*
+ * Sorted draw queue. render_object builds each draw's matrix and a
+ * 32-bit key; render_draw_flush radix-sorts the keys and emits the
+ * draws, skipping combine/render mode/texture commands that repeat the
+ * state left by the previous draw.
+ *
+ * Opaque keys:      1:xlu=0 | 3:layer | 4:material | 8:texture | 16:depth
+ * Translucent keys: 1:xlu=1 | 3:layer | 16:~depth | 4:material | 8:texture
+ *
+ * Opaque draws group by state and go front to back within it (cheaper
+ * Z rejects); translucent ones come last, back to front, with state only
+ * as a tie-break.
+ *
+ * Each draw belongs to one viewport. A final stable pass on the viewport
+ * makes each viewport's draws one contiguous run in key order, and each
+ * run becomes an independent emit job for that viewport's DL slice.
+ */
+typedef struct RenderDraw {
+    Mtx     *mtx;               /* NULL until the flush converts mtx_index */
+    Gfx     *dl;
+    u32     tex_addr;           /* Resolved at flush: table or texture cache */
+    s16     texture;
+    u8      material;
+    u8      view;               /* Viewport (display list slice) */
+    s16     mtx_index;          /* sMtxQueue entry, while mtx is NULL */
+    s16     pad;
+} RenderDraw;
+
+/* One viewport's share of a flush */
+typedef struct RenderEmitJob {
+    RenderDraw      *draws;
+    const u16       *order;     /* Sorted draw indices for this viewport */
+    u16             *cmd_end;   /* Count pass: commands up to each draw */
+    Gfx             *dl;        /* NULL = count only */
+    s32             view;
+    s32             count;
+    s32             cmds;
+    RenderSortStats stats;
+} RenderEmitJob;
+
+#define DRAW_KEY_XLU        0x80000000
+#define DRAW_TEX_NONE       0xFF
+
+static RenderDraw sDraws[RENDER_MAX_DRAWS];
+static u32 sDrawKeys[2][RENDER_MAX_DRAWS];
+static u16 sDrawOrder[2][RENDER_MAX_DRAWS];
+static s32 sDrawCount;
+static u16 sRadixCount[256];
+static u16 sDrawCmdEnd[RENDER_MAX_DRAWS];
+
+/* Per-frame object matrices, converted in one batch by render_draw_flush */
+static f32 sMtxQueue[RENDER_MAX_DRAWS][4][4];
+static s32 sMtxQueued;
+
+/* Camera position per viewport, captured with its frustum */
+static f32 sViewEye[CULL_MAX_VIEWS][3];
+
+/* Screen rectangle per viewport (x, y, width, height), scissored at flush */
+static s16 sViewRect[CULL_MAX_VIEWS][4];
+
+/* G_SETCOMBINE words and G_SETOTHERMODE_L render mode per material */
+static const u32 sMaterialCombine[RENDER_NUM_MATERIALS][2] = {
+    { 0xFCFFFFFF, 0xFFFE793C },     /* G_CC_SHADE */
+    { 0xFC121824, 0xFF33FFFF },     /* G_CC_MODULATERGBA */
+    { 0xFCFFFFFF, 0xFFFE793C },     /* G_CC_SHADE */
+    { 0xFC121824, 0xFF33FFFF },     /* G_CC_MODULATERGBA */
+};
+static const u32 sMaterialMode[RENDER_NUM_MATERIALS] = {
+    0x00552078,                     /* G_RM_AA_ZB_OPA_SURF(2) */
+    0x00552078,
+    0x005049D8,                     /* G_RM_AA_ZB_XLU_SURF(2) */
+    0x005049D8,
+};
+
+static const TextureInfo *sTexTable;
+static const s16 *sTexStream;           /* Track texture id per entry, or NULL */
+static s32 sTexCount;
+
+static RenderSortStats sSortStats;      /* Frame in progress */
+static RenderSortStats sSortLast;       /* Last completed frame */
+
 /* Matrix stack */
 static Mtx sMatrixStack[GFX_STACK_SIZE];
 static s32 sMatrixDepth;
@@ -66,6 +161,50 @@ static s32 sMatrixDepth;
 static RenderObject sRenderObjects[256];
 static s32 sRenderObjectCount;
 
+/*
+ * Bounded pool objects in the cull hierarchy (nothing moves them once
+ * placed); rebuilt when an object is (re)defined.
+ */
+static s16 sStaticObj[256];             /* Hierarchy object -> pool index */
+static f32 sStaticCenter[256][3];
+static f32 sStaticRadius[256];
+static u8 sStaticVisible[256];           /* Per hierarchy object: visible, or view bits */
+static u8 sObjectViews[256];            /* Per pool object: view bits (split screen) */
+static s32 sStaticCount;
+static s32 sStaticDirty = 1;
+
+/* Detail level: latched by the scheduler, applied by the game thread */
+#define RENDER_DETAIL_LEVELS    4
+static volatile s32 sPendingDetail;
+static s32 sDetailLevel;
+
+/* Per level: particle density %, shadow quality, fog distance and LOD bias in 16ths */
+static const u8 sDetailDensity[RENDER_DETAIL_LEVELS] = { 100, 75, 50, 25 };
+static const u8 sDetailShadows[RENDER_DETAIL_LEVELS] = { 0, 0, 1, 2 };
+static const u8 sDetailFog16[RENDER_DETAIL_LEVELS]   = { 16, 15, 13, 11 };
+static const u8 sDetailLod16[RENDER_DETAIL_LEVELS]   = { 16, 14, 11, 8 };
+
+/* Race view projection */
+#define RENDER_FOVY         80.0f
+#define RENDER_NEAR         1.0f
+#define RENDER_FAR          2000.0f
+
+/* Projection as last set; defaults match the old entity cone test */
+static f32 sProjTanHalfFovy = 0.8423f;     /* tan(40 degrees) */
+static f32 sProjAspect = 4.0f / 3.0f;
+static f32 sProjNear = 1.0f;
+static f32 sProjFar = 2000.0f;
+static f32 sViewHeight = 240.0f;
+
+/* Fog distances as requested, before detail scaling */
+static s32 sFogBaseNear = 900;
+static s32 sFogBaseFar = 1000;
+
+#ifdef NON_MATCHING
+/* Double-buffered display list arena (see gfx.c) */
+static Gfx sGfxPool[2][GFX_POOL_SIZE / sizeof(Gfx)];
+#endif
+
 /* ======================= STUB IMPLEMENTATIONS ======================== */
 
 #ifdef NON_MATCHING
@@ -88,8 +227,22 @@ void render_init(void) {
     sRenderObjectCount = 0;
     for (i = 0; i < 256; i++) {
         sRenderObjects[i].objnum = -1;
+        sRenderObjects[i].radius = 0.0f;
+        sRenderObjects[i].lod = 0;
+        sRenderObjects[i].dl = NULL;
+        sRenderObjects[i].lod_dl[0] = NULL;
+        sRenderObjects[i].lod_dl[1] = NULL;
+        sRenderObjects[i].lod_dl[2] = NULL;
+        sRenderObjects[i].texture = -1;
+        sRenderObjects[i].mtx_slot = -1;
     }
 
+    sStaticCount = 0;
+    sStaticDirty = 1;
+
+    /* Nothing streamed in yet */
+    texcache_init();
+
     /* Initialize camera to default */
     gCamPos[0] = 0.0f;
     gCamPos[1] = 10.0f;
@@ -113,6 +266,10 @@ void render_init(void) {
 
     /* Default geometry mode */
     gRenderState.geomMode = G_ZBUFFER | G_SHADE | G_SHADING_SMOOTH | G_CULL_BACK;
+
+    /* Display list arena, shedding detail when a viewport runs short */
+    gfx_arena_init(sGfxPool[0], sGfxPool[1], GFX_POOL_SIZE / sizeof(Gfx));
+    gfx_arena_set_callback(render_dl_pressure);
 }
 
 /**
@@ -121,12 +278,27 @@ void render_init(void) {
  * Resets display list and prepares for rendering.
  */
 void render_frame_start(void) {
+    u32 frames;
+
+    /* Pick up any quality change from the scheduler */
+    if (sPendingDetail != sDetailLevel) {
+        render_set_detail_level(sPendingDetail);
+    }
+
     /* Reset matrix stack */
     sMatrixDepth = 0;
 
     /* Reset render object count */
     sRenderObjectCount = 0;
 
+    /* Publish last frame's sort counters */
+    sDrawCount = 0;
+    sMtxQueued = 0;
+    frames = sSortLast.frames + 1;
+    sSortLast = sSortStats;
+    sSortLast.frames = frames;
+    memset(&sSortStats, 0, sizeof(sSortStats));
+
     /* Would initialize display list here */
     /* gRenderState.dlCurrent = gRenderState.dlHead; */
 }
@@ -134,11 +306,76 @@ void render_frame_start(void) {
 /**
  * render_frame_end - End current frame
  *
- * Finalizes display list and submits to RSP.
+ * Flushes draws queued after render_scene into the frame list;
+ * frame_end closes the list and submits it.
  */
 void render_frame_end(void) {
-    /* Would finalize display list and submit to RSP */
-    /* gSPEndDisplayList(gRenderState.dlCurrent++); */
+    render_draw_flush();
+}
+
+/**
+ * render_frame_pressure - Scheduler pressure callback
+ *
+ * Called on the scheduler thread when the predicted RDP time crosses a
+ * threshold, so it only latches the level for render_frame_start.
+ *
+ * @param level OS_SC_PRESSURE_* level (0 = full quality)
+ * @param predicted Predicted RDP frame time (ticks)
+ * @param budget Frame budget (ticks)
+ */
+void render_frame_pressure(s32 level, u32 predicted, u32 budget) {
+    if (level < 0) {
+        level = 0;
+    } else if (level >= RENDER_DETAIL_LEVELS) {
+        level = RENDER_DETAIL_LEVELS - 1;
+    }
+    sPendingDetail = level;
+}
+
+/**
+ * render_dl_pressure - Display list arena hook
+ *
+ * Called from gfx_alloc_dl when a viewport's slice nears full or refuses
+ * an allocation. Steps the latched detail level up one notch so the next
+ * frames emit less; the scheduler's pressure callback brings it back
+ * down once frames are calm.
+ *
+ * @param view Viewport index
+ * @param used Commands used in the slice
+ * @param capacity Slice capacity
+ * @param overflowed Nonzero if an allocation was refused
+ */
+void render_dl_pressure(s32 view, u32 used, u32 capacity, s32 overflowed) {
+    if (sPendingDetail < RENDER_DETAIL_LEVELS - 1 && sPendingDetail <= sDetailLevel) {
+        sPendingDetail = sDetailLevel + 1;
+    }
+}
+
+/**
+ * render_set_detail_level - Apply a quality level
+ *
+ * Sheds the cheapest-to-lose work first: particles at level 1,
+ * shadows of cars without a local viewport at level 2, all shadows at
+ * level 3, with fog distance pulled in and the LOD bias lowered a step
+ * at each level.
+ *
+ * @param level 0 (full) to RENDER_DETAIL_LEVELS - 1
+ */
+void render_set_detail_level(s32 level) {
+    if (level < 0) {
+        level = 0;
+    } else if (level >= RENDER_DETAIL_LEVELS) {
+        level = RENDER_DETAIL_LEVELS - 1;
+    }
+
+    sDetailLevel = level;
+    sPendingDetail = level;
+
+    effects_set_density(sDetailDensity[level]);
+    shadow_set_quality(sDetailShadows[level]);
+    lod_set_bias((f32)sDetailLod16[level] * (1.0f / 16.0f));
+    render_set_fog(sFogBaseNear, sFogBaseFar, gRenderState.fogColor[0],
+                   gRenderState.fogColor[1], gRenderState.fogColor[2]);
 }
 
 /**
@@ -150,6 +387,22 @@ void render_frame_end(void) {
  * @param height Viewport height
  */
 void render_set_viewport(s32 x, s32 y, s32 width, s32 height) {
+    s32 view;
+
+    /* LOD is chosen from projected size, which depends on viewport height */
+    if (height > 0) {
+        sViewHeight = (f32)height;
+        render_update_frustum();
+    }
+
+    view = cull_view_current();
+    if (view >= 0) {
+        sViewRect[view][0] = (s16)x;
+        sViewRect[view][1] = (s16)y;
+        sViewRect[view][2] = (s16)width;
+        sViewRect[view][3] = (s16)height;
+    }
+
     /* Would set up RSP viewport */
     /* Vp viewport;
      * viewport.vp.vscale[0] = width * 2;
@@ -169,10 +422,116 @@ void render_set_viewport(s32 x, s32 y, s32 width, s32 height) {
  * @param far Far clip plane
  */
 void render_set_projection(f32 fovy, f32 aspect, f32 near, f32 far) {
+    f32 half = fovy * (3.14159265f / 360.0f);
+
+    sProjTanHalfFovy = sinf(half) / cosf(half);
+    sProjAspect = aspect;
+    sProjNear = near;
+    sProjFar = far;
+    render_update_frustum();
+
     /* Would call guPerspective to build projection matrix */
     /* guPerspective(mtx, &perspNorm, fovy, aspect, near, far, 1.0f); */
 }
 
+/**
+ * render_set_plane - Store one inward-facing plane through a point
+ */
+static void render_set_plane(s32 i, f32 n[3], f32 p[3]) {
+    f32 len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+    if (len < 1e-6f) {
+        len = 1.0f;
+    }
+    gFrustumPlanes[i][0] = n[0] / len;
+    gFrustumPlanes[i][1] = n[1] / len;
+    gFrustumPlanes[i][2] = n[2] / len;
+    gFrustumPlanes[i][3] = -(gFrustumPlanes[i][0] * p[0] +
+                             gFrustumPlanes[i][1] * p[1] +
+                             gFrustumPlanes[i][2] * p[2]);
+}
+
+/**
+ * render_update_frustum - Rebuild gFrustumPlanes from camera + projection
+ *
+ * Works in world space from the camera basis, so no matrix inverse is
+ * needed. A point is inside when |x| <= z tan(h) and |y| <= z tan(v) in
+ * camera space; each side plane is right/up +- forward * tangent.
+ * Order: left, right, bottom, top, near, far. The result is also
+ * snapshotted for the current cull viewport.
+ */
+void render_update_frustum(void) {
+    f32 f[3], r[3], u[3], n[3], p[3];
+    f32 len, tv, th;
+    s32 i;
+
+    len = sqrtf(gCamDir[0] * gCamDir[0] + gCamDir[1] * gCamDir[1] + gCamDir[2] * gCamDir[2]);
+    if (len < 1e-6f) {
+        return;
+    }
+    for (i = 0; i < 3; i++) {
+        f[i] = gCamDir[i] / len;
+    }
+
+    /* right = forward x up, up' = right x forward */
+    r[0] = f[1] * gCamUp[2] - f[2] * gCamUp[1];
+    r[1] = f[2] * gCamUp[0] - f[0] * gCamUp[2];
+    r[2] = f[0] * gCamUp[1] - f[1] * gCamUp[0];
+    len = sqrtf(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    if (len < 1e-6f) {
+        return;
+    }
+    for (i = 0; i < 3; i++) {
+        r[i] /= len;
+    }
+    u[0] = r[1] * f[2] - r[2] * f[1];
+    u[1] = r[2] * f[0] - r[0] * f[2];
+    u[2] = r[0] * f[1] - r[1] * f[0];
+
+    tv = sProjTanHalfFovy;
+    th = tv * sProjAspect;
+
+    /* Left, right */
+    for (i = 0; i < 3; i++) {
+        n[i] = r[i] + f[i] * th;
+    }
+    render_set_plane(0, n, gCamPos);
+    for (i = 0; i < 3; i++) {
+        n[i] = -r[i] + f[i] * th;
+    }
+    render_set_plane(1, n, gCamPos);
+
+    /* Bottom, top */
+    for (i = 0; i < 3; i++) {
+        n[i] = u[i] + f[i] * tv;
+    }
+    render_set_plane(2, n, gCamPos);
+    for (i = 0; i < 3; i++) {
+        n[i] = -u[i] + f[i] * tv;
+    }
+    render_set_plane(3, n, gCamPos);
+
+    /* Near, far */
+    for (i = 0; i < 3; i++) {
+        p[i] = gCamPos[i] + f[i] * sProjNear;
+    }
+    render_set_plane(4, f, p);
+    for (i = 0; i < 3; i++) {
+        p[i] = gCamPos[i] + f[i] * sProjFar;
+        n[i] = -f[i];
+    }
+    render_set_plane(5, n, p);
+
+    cull_view_update(sViewHeight / (2.0f * tv));
+
+    i = cull_view_current();
+    if (i >= 0) {
+        sViewEye[i][0] = gCamPos[0];
+        sViewEye[i][1] = gCamPos[1];
+        sViewEye[i][2] = gCamPos[2];
+    }
+}
+
 /**
  * render_set_camera - Set view matrix from camera parameters
  *
@@ -190,6 +549,8 @@ void render_set_camera(f32 eye[3], f32 target[3], f32 up[3]) {
         gCamDir[i] = target[i] - eye[i];
     }
 
+    render_update_frustum();
+
     /* Would call guLookAt to build view matrix */
     /* guLookAt(mtx, eye[0], eye[1], eye[2],
      *          target[0], target[1], target[2],
@@ -207,8 +568,12 @@ void render_set_camera(f32 eye[3], f32 target[3], f32 up[3]) {
  * @param b Blue component
  */
 void render_set_fog(s32 near, s32 far, u8 r, u8 g, u8 b) {
-    gRenderState.fogNear = near;
-    gRenderState.fogFar = far;
+    sFogBaseNear = near;
+    sFogBaseFar = far;
+
+    /* Pull fog (and with it the draw distance) in under pressure */
+    gRenderState.fogNear = (near * sDetailFog16[sDetailLevel]) >> 4;
+    gRenderState.fogFar = (far * sDetailFog16[sDetailLevel]) >> 4;
     gRenderState.fogColor[0] = r;
     gRenderState.fogColor[1] = g;
     gRenderState.fogColor[2] = b;
@@ -218,6 +583,122 @@ void render_set_fog(s32 near, s32 far, u8 r, u8 g, u8 b) {
     /* gSPFogPosition(gRenderState.dlCurrent++, near, far); */
 }
 
+/**
+ * render_object_float - Object transform as a float matrix
+ *
+ * Scale, then orientation, then translation.
+ */
+static void render_object_float(RenderObject *obj, f32 mf[4][4]) {
+    s32 i;
+
+    for (i = 0; i < 3; i++) {
+        mf[i][0] = obj->orient[i][0] * obj->scale[i];
+        mf[i][1] = obj->orient[i][1] * obj->scale[i];
+        mf[i][2] = obj->orient[i][2] * obj->scale[i];
+        mf[i][3] = 0.0f;
+    }
+    mf[3][0] = obj->pos[0];
+    mf[3][1] = obj->pos[1];
+    mf[3][2] = obj->pos[2];
+    mf[3][3] = 1.0f;
+}
+
+/**
+ * render_object_matrix - Find or queue an object's transform
+ *
+ * Placed objects return their static cache slot (converted by
+ * mtx_cache_flush at the top of render_scene). Anything else has its
+ * float matrix queued; render_draw_flush converts the whole queue into
+ * the frame's matrix arena in one batch.
+ *
+ * @param index Output: queue entry when NULL is returned, -1 if full
+ * @return Cached RSP matrix, or NULL if queued or refused
+ */
+static Mtx *render_object_matrix(RenderObject *obj, s16 *index) {
+    if (obj->mtx_slot >= 0) {
+        *index = -1;
+        return mtx_cache_get(obj->mtx_slot);
+    }
+
+    if (sMtxQueued >= RENDER_MAX_DRAWS) {
+        *index = -1;
+        return NULL;
+    }
+    render_object_float(obj, sMtxQueue[sMtxQueued]);
+    *index = (s16)sMtxQueued++;
+    return NULL;
+}
+
+/**
+ * render_object_dl - Display list for the object's current detail level
+ *
+ * Levels with no list of their own use the next finer one.
+ */
+static Gfx *render_object_dl(RenderObject *obj) {
+    s32 lvl;
+
+    for (lvl = obj->lod; lvl > 0; lvl--) {
+        if (obj->lod_dl[lvl - 1] != NULL) {
+            return obj->lod_dl[lvl - 1];
+        }
+    }
+    return obj->dl;
+}
+
+/**
+ * render_queue_draw - Add one object draw for one viewport to the queue
+ *
+ * @param mtx Object matrix (shared by every viewport drawing the object),
+ *            or NULL if it waits in the matrix queue
+ * @param mtxIndex Matrix queue entry when mtx is NULL
+ * @param view Viewport the draw belongs to
+ * @param dist Distance from that viewport's camera
+ */
+static void render_queue_draw(RenderObject *obj, Mtx *mtx, s16 mtxIndex, s32 view, f32 dist) {
+    RenderDraw *draw;
+    u32 key, depth, tex, layer;
+    s32 xlu;
+
+    if (sDrawCount >= RENDER_MAX_DRAWS) {
+        sSortStats.dropped++;
+        return;
+    }
+
+    draw = &sDraws[sDrawCount];
+    draw->mtx = mtx;
+    draw->mtx_index = mtxIndex;
+    draw->dl = render_object_dl(obj);
+    draw->view = (u8)view;
+
+    /* Set up render mode based on object flags */
+    xlu = (obj->flags & OBJ_FLAG_SORT_ALPHA) != 0;
+    gRenderState.renderMode = xlu ? RENDER_TRANSLUCENT : RENDER_NORMAL;
+
+    if (obj->texture >= 0 && obj->texture < sTexCount) {
+        draw->texture = obj->texture;
+        draw->material = xlu ? RENDER_MAT_TEX_XLU : RENDER_MAT_TEX;
+        tex = (u32)obj->texture;
+    } else {
+        draw->texture = -1;
+        draw->material = xlu ? RENDER_MAT_SHADE_XLU : RENDER_MAT_SHADE;
+        tex = DRAW_TEX_NONE;
+    }
+
+    depth = (dist >= sProjFar) ? 0xFFFF : (u32)(dist * (65535.0f / sProjFar));
+    layer = (obj->priority > 7) ? 7 : obj->priority;
+
+    if (xlu) {
+        key = DRAW_KEY_XLU | (layer << 28) | ((0xFFFF - depth) << 12) |
+              ((u32)draw->material << 8) | tex;
+    } else {
+        key = (layer << 28) | ((u32)draw->material << 24) | (tex << 16) | depth;
+    }
+
+    sDrawKeys[0][sDrawCount] = key;
+    sDrawOrder[0][sDrawCount] = (u16)sDrawCount;
+    sDrawCount++;
+}
+
 /**
  * render_object - Render a 3D object
  * Address: 0x80099BFC (10KB function)
@@ -229,6 +710,11 @@ void render_set_fog(s32 near, s32 far, u8 r, u8 g, u8 b) {
  * @param obj Object to render
  */
 void render_object(RenderObject *obj) {
+    f32 dx, dy, dz, dist;
+    Mtx *mtx;
+    s16 mtxIndex;
+    s32 view;
+
     /* Validate object */
     if (obj == NULL || obj->objnum < 0) {
         return;
@@ -239,36 +725,35 @@ void render_object(RenderObject *obj) {
         return;
     }
 
-    /* Would do frustum culling here */
-    /* if (!render_cull_sphere(obj->pos, obj->radius)) return; */
+    /* Frustum culled by the caller (render_view runs the hierarchy) */
 
-    /* Push matrix for this object */
-    render_push_matrix();
+    dx = obj->pos[0] - gCamPos[0];
+    dy = obj->pos[1] - gCamPos[1];
+    dz = obj->pos[2] - gCamPos[2];
+    dist = sqrtf(dx * dx + dy * dy + dz * dz);
 
-    /* Apply object transform */
-    render_translate(obj->pos[0], obj->pos[1], obj->pos[2]);
-
-    /* Apply rotation (from orientation matrix) */
-    /* Would multiply by obj->orient matrix */
-
-    /* Apply scale if not identity */
-    if (obj->scale[0] != 1.0f || obj->scale[1] != 1.0f || obj->scale[2] != 1.0f) {
-        render_scale(obj->scale[0], obj->scale[1], obj->scale[2]);
+    /* Detail level from projected size (ZOID class), with hysteresis */
+    view = cull_view_current();
+    if (obj->radius > 0.0f) {
+        obj->lod = lod_select(view, LOD_CLASS_ZOID, obj->radius, dist, obj->lod);
     }
 
-    /* Set up render mode based on object flags */
-    if (obj->flags & OBJ_FLAG_SORT_ALPHA) {
-        /* Translucent rendering */
-        gRenderState.renderMode = RENDER_TRANSLUCENT;
-    } else {
-        gRenderState.renderMode = RENDER_NORMAL;
+    /* Nothing to draw (geometry not attached) */
+    if (obj->dl == NULL) {
+        return;
+    }
+    if (sDrawCount >= RENDER_MAX_DRAWS) {
+        sSortStats.dropped++;
+        return;
     }
 
-    /* Would emit display list commands for object geometry */
-    /* gSPDisplayList(gRenderState.dlCurrent++, objectDisplayList); */
+    mtx = render_object_matrix(obj, &mtxIndex);
+    if (mtx == NULL && mtxIndex < 0) {
+        sSortStats.dropped++;
+        return;
+    }
 
-    /* Pop matrix */
-    render_pop_matrix();
+    render_queue_draw(obj, mtx, mtxIndex, (view < 0) ? 0 : view, dist);
 }
 
 /**
@@ -285,19 +770,228 @@ void render_scene_large(void) {
     /* Would submit display lists for visible geometry */
 }
 
+/**
+ * render_static_build - Rebuild the cull hierarchy over the object pool
+ *
+ * Bounds come from the track's object placements (render_place_object).
+ * Objects without a bound are left out; render_view and
+ * render_objects_views draw them in every viewport.
+ */
+static void render_static_build(void) {
+    RenderObject *obj;
+    s32 i, k;
+
+    sStaticCount = 0;
+    for (i = 0; i < 256; i++) {
+        obj = &sRenderObjects[i];
+        if (obj->objnum < 0 || obj->radius <= 0.0f) {
+            continue;
+        }
+        for (k = 0; k < 3; k++) {
+            sStaticCenter[sStaticCount][k] = obj->pos[k];
+        }
+        sStaticRadius[sStaticCount] = obj->radius;
+        sStaticObj[sStaticCount] = (s16)i;
+        sStaticCount++;
+    }
+    cull_bvh_build(sStaticCenter, sStaticRadius, sStaticCount);
+    sStaticDirty = 0;
+}
+
+/**
+ * render_view_setup - Set up one viewport's camera, frustum and rectangle
+ *
+ * @param view Viewport index
+ * @param cam Camera for the viewport (bound to it for entity culling)
+ * @param aspect Viewport width / height
+ */
+static void render_view_setup(s32 view, CameraData *cam, f32 aspect) {
+    f32 up[3];
+
+    up[0] = 0.0f;
+    up[1] = 1.0f;
+    up[2] = 0.0f;
+
+    cull_view_begin(view);
+    cull_view_bind(view, cam);
+    render_set_projection(RENDER_FOVY, aspect, RENDER_NEAR, RENDER_FAR);
+    render_set_camera(cam->pos, cam->target, up);
+
+    /* Screen rectangle and rain volume for this player */
+    mp_apply_viewport(view);
+}
+
+/**
+ * render_view - Full screen: set up viewport 0 and queue what it sees
+ */
+static void render_view(CameraData *cam, f32 aspect) {
+    s32 i;
+
+    render_view_setup(0, cam, aspect);
+
+    /* Bounded objects through the hierarchy, unbounded ones always */
+    cull_bvh_run(0, sStaticVisible);
+    for (i = 0; i < sStaticCount; i++) {
+        if (sStaticVisible[i]) {
+            render_object(&sRenderObjects[sStaticObj[i]]);
+        }
+    }
+    for (i = 0; i < 256; i++) {
+        if (sRenderObjects[i].objnum >= 0 && sRenderObjects[i].radius <= 0.0f) {
+            render_object(&sRenderObjects[i]);
+        }
+    }
+}
+
+/**
+ * render_objects_views - Queue every render object for several viewports
+ *
+ * The split-screen path: instead of one traversal per viewport, each
+ * object is visited once. One walk of the hierarchy gives the viewports
+ * that see each bounded object, the matrix is built once and shared,
+ * and LOD is picked once for the nearest of those viewports; then a
+ * draw is queued per viewport with that viewport's depth.
+ * render_draw_flush writes each viewport's draws into its own display
+ * list slice.
+ *
+ * Every viewport in the mask must be set up first (render_view_setup).
+ *
+ * @param view_mask Bit per viewport to draw
+ * @return Draws queued
+ */
+s32 render_objects_views(s32 view_mask) {
+    RenderObject *obj;
+    Mtx *mtx;
+    f32 dist[CULL_MAX_VIEWS];
+    f32 dx, dy, dz, nearDist;
+    s16 mtxIndex;
+    s32 i, v, mask, nearView, first, queued;
+
+    view_mask &= (1 << CULL_MAX_VIEWS) - 1;
+    if (view_mask == 0) {
+        return 0;
+    }
+    if (sStaticDirty) {
+        render_static_build();
+    }
+
+    /* Bounded objects: one walk of the hierarchy for every viewport */
+    memset(sObjectViews, 0, sizeof(sObjectViews));
+    cull_bvh_run_views(view_mask, sStaticVisible);
+    for (i = 0; i < sStaticCount; i++) {
+        sObjectViews[sStaticObj[i]] = sStaticVisible[i];
+    }
+
+    queued = sDrawCount;
+    for (i = 0; i < 256; i++) {
+        obj = &sRenderObjects[i];
+        if (obj->objnum < 0 || (obj->flags & OBJ_FLAG_HIDDEN)) {
+            continue;
+        }
+
+        /* No bound: drawn everywhere, as render_view does */
+        mask = (obj->radius > 0.0f) ? sObjectViews[i] : view_mask;
+        if (mask == 0) {
+            continue;
+        }
+
+        nearView = -1;
+        nearDist = 0.0f;
+        for (v = 0; v < CULL_MAX_VIEWS; v++) {
+            if (!(mask & (1 << v))) {
+                continue;
+            }
+            dx = obj->pos[0] - sViewEye[v][0];
+            dy = obj->pos[1] - sViewEye[v][1];
+            dz = obj->pos[2] - sViewEye[v][2];
+            dist[v] = sqrtf(dx * dx + dy * dy + dz * dz);
+            if (nearView < 0 || dist[v] < nearDist) {
+                nearView = v;
+                nearDist = dist[v];
+            }
+        }
+
+        if (obj->radius > 0.0f) {
+            obj->lod = lod_select(nearView, LOD_CLASS_ZOID, obj->radius, nearDist, obj->lod);
+        }
+        if (obj->dl == NULL) {
+            continue;
+        }
+        if (sDrawCount >= RENDER_MAX_DRAWS) {
+            sSortStats.dropped++;
+            continue;
+        }
+
+        mtx = render_object_matrix(obj, &mtxIndex);
+        if (mtx == NULL && mtxIndex < 0) {
+            sSortStats.dropped++;
+            continue;
+        }
+
+        first = 1;
+        for (v = 0; v < CULL_MAX_VIEWS; v++) {
+            if (mask & (1 << v)) {
+                if (!first) {
+                    sSortStats.shared++;
+                }
+                render_queue_draw(obj, mtx, mtxIndex, v, dist[v]);
+                first = 0;
+            }
+        }
+    }
+
+    return sDrawCount - queued;
+}
+
 /**
  * render_scene - Set up scene for rendering
  * Address: 0x800A04C4 (2.7KB function)
  *
  * Configures viewport, projection, and view matrices.
  * Called from game_loop to prepare for rendering.
+ *
+ * Full screen culls the object pool through the hierarchy for the one
+ * camera. Split screen sets up every player's camera and rectangle
+ * first, then queues all viewports' draws in one traversal
+ * (render_objects_views). The draws are flushed before returning, so the
+ * 3D runs sit in the frame list ahead of the HUD and minimap.
  */
 void render_scene(void) {
-    /* Would set up viewport based on player count */
-    /* Would set up projection matrix */
-    /* Would set up view matrix from camera */
-    /* Would configure fog */
-    /* Would set geometry mode flags */
+    CameraData *cam;
+    s16 x, y, w, h;
+    s32 v, views;
+
+    if (sStaticDirty) {
+        render_static_build();
+    }
+
+    /* Placed objects that moved since last frame, converted in runs */
+    mtx_cache_flush();
+
+    if (!mp_is_split_screen()) {
+        cam = camera_get_view(0);
+        if (cam != NULL) {
+            render_view(cam, (f32)SCREEN_WIDTH / (f32)SCREEN_HEIGHT);
+        }
+        render_draw_flush();
+        return;
+    }
+
+    views = 0;
+    for (v = 0; v < MP_MAX_PLAYERS; v++) {
+        cam = camera_get_view(v);
+        if (cam == NULL) {
+            continue;
+        }
+        mp_get_viewport_rect(v, &x, &y, &w, &h);
+        if (w <= 0 || h <= 0) {
+            continue;
+        }
+        render_view_setup(v, cam, (f32)w / (f32)h);
+        views |= 1 << v;
+    }
+    render_objects_views(views);
+    render_draw_flush();
 }
 
 /**
@@ -310,6 +1004,530 @@ void render_util_common(void) {
     /* Common utility - likely matrix or state setup */
 }
 
+/* ---- Sorted Draws ---- */
+
+/**
+ * render_set_texture_table - Textures RenderObject.texture indexes
+ *
+ * @param table Texture descriptors
+ * @param stream_ids Track texture id (texcache key) per entry, -1 = none;
+ *                   may be NULL if nothing in the table is streamed
+ * @param count Entries in table
+ *
+ * Entries whose address is 0 are fetched from the texture cache by their
+ * stream id, the same id track_texture_load uses, so both paths share
+ * one resident copy.
+ */
+void render_set_texture_table(const TextureInfo *table, const s16 *stream_ids, s32 count) {
+    sTexTable = table;
+    sTexStream = (table == NULL) ? NULL : stream_ids;
+    sTexCount = (table == NULL) ? 0 : (count > DRAW_TEX_NONE ? DRAW_TEX_NONE : count);
+}
+
+/**
+ * render_sort_draws - LSD radix sort of the queued keys, 8 bits a pass
+ *
+ * Byte positions where every key agrees are skipped, so a frame with a
+ * single layer and material costs two passes, not four. With several
+ * viewports queued, one more pass groups the draws by viewport.
+ *
+ * @return Draw indices by viewport, in key order within each
+ */
+static u16 *render_sort_draws(void) {
+    u32 *keys = sDrawKeys[0], *keysOut = sDrawKeys[1], *kt;
+    u16 *order = sDrawOrder[0], *orderOut = sDrawOrder[1], *ot;
+    u32 diff, b, views;
+    u16 sum, c;
+    s32 i, shift;
+
+    diff = 0;
+    for (i = 1; i < sDrawCount; i++) {
+        diff |= keys[i] ^ keys[0];
+    }
+
+    for (shift = 0; shift < 32; shift += 8) {
+        if (((diff >> shift) & 0xFF) == 0) {
+            continue;
+        }
+
+        memset(sRadixCount, 0, sizeof(sRadixCount));
+        for (i = 0; i < sDrawCount; i++) {
+            sRadixCount[(keys[i] >> shift) & 0xFF]++;
+        }
+        sum = 0;
+        for (i = 0; i < 256; i++) {
+            c = sRadixCount[i];
+            sRadixCount[i] = sum;
+            sum += c;
+        }
+        for (i = 0; i < sDrawCount; i++) {
+            b = (keys[i] >> shift) & 0xFF;
+            keysOut[sRadixCount[b]] = keys[i];
+            orderOut[sRadixCount[b]++] = order[i];
+        }
+
+        kt = keys; keys = keysOut; keysOut = kt;
+        ot = order; order = orderOut; orderOut = ot;
+    }
+
+    /* Stable pass on the viewport; the keys are not needed past here */
+    views = 0;
+    for (i = 0; i < sDrawCount; i++) {
+        views |= 1U << sDraws[i].view;
+    }
+    if (views & (views - 1)) {
+        memset(sRadixCount, 0, CULL_MAX_VIEWS * sizeof(u16));
+        for (i = 0; i < sDrawCount; i++) {
+            sRadixCount[sDraws[order[i]].view]++;
+        }
+        sum = 0;
+        for (i = 0; i < CULL_MAX_VIEWS; i++) {
+            c = sRadixCount[i];
+            sRadixCount[i] = sum;
+            sum += c;
+        }
+        for (i = 0; i < sDrawCount; i++) {
+            b = sDraws[order[i]].view;
+            orderOut[sRadixCount[b]++] = order[i];
+        }
+        order = orderOut;
+    }
+
+    return order;
+}
+
+/**
+ * render_load_texture - Emit a block load of one texture into TMEM
+ *
+ * Same sequence as gDPLoadTextureBlock: texels are loaded as 16-bit
+ * words, so 4 and 8-bit textures go through the same path.
+ *
+ * @param addr RDRAM address of the texels (ti->address or a cache slot)
+ * @return Commands written (7)
+ */
+static s32 render_load_texture(Gfx *dl, const TextureInfo *ti, u32 addr) {
+    u32 bits, lineBytes, line, words, dxt, lrs;
+    u32 masks, maskt;
+
+    bits = 4U << ti->size;
+    lineBytes = (ti->width * bits) >> 3;
+    line = (lineBytes + 7) >> 3;
+    words = (lineBytes >> 3) ? (lineBytes >> 3) : 1;
+    dxt = (0x800 + words - 1) / words;
+    lrs = ((ti->width * ti->height * bits) >> 4) - 1;
+    if (lrs > 0x7FF) {
+        lrs = 0x7FF;
+    }
+
+    for (masks = 0; (2U << masks) <= ti->width; masks++)
+        ;
+    for (maskt = 0; (2U << maskt) <= ti->height; maskt++)
+        ;
+
+    dl[0].words.w0 = 0xFD100000 | ((u32)ti->format << 21);     /* G_SETTIMG, 16b */
+    dl[0].words.w1 = addr;
+    dl[1].words.w0 = 0xF5100000 | ((u32)ti->format << 21);     /* G_SETTILE load */
+    dl[1].words.w1 = 0x07000000;
+    dl[2].words.w0 = 0xE6000000;                                /* G_RDPLOADSYNC */
+    dl[2].words.w1 = 0;
+    dl[3].words.w0 = 0xF3000000;                                /* G_LOADBLOCK */
+    dl[3].words.w1 = 0x07000000 | (lrs << 12) | dxt;
+    dl[4].words.w0 = 0xE7000000;                                /* G_RDPPIPESYNC */
+    dl[4].words.w1 = 0;
+    dl[5].words.w0 = 0xF5000000 | ((u32)ti->format << 21) |    /* G_SETTILE render */
+                     ((u32)ti->size << 19) | (line << 9);
+    dl[5].words.w1 = ((u32)ti->wrapT << 18) | (maskt << 14) |
+                     ((u32)ti->wrapS << 8) | (masks << 4);
+    dl[6].words.w0 = 0xF2000000;                                /* G_SETTILESIZE */
+    dl[6].words.w1 = (((u32)(ti->width - 1) << 2) << 12) | ((u32)(ti->height - 1) << 2);
+    return 7;
+}
+
+/**
+ * render_emit_draws - Write one viewport's sorted draws
+ *
+ * RDP state is unknown at the start of a slice (other code writes
+ * between flushes), so the first draw always sets everything. The run is
+ * called from the frame list, so it ends with G_ENDDL. With no display
+ * list the job only counts: cmd_end[i] is the command total through
+ * draw i, not counting the G_ENDDL, so a short slice can still take a
+ * prefix.
+ *
+ * Touches nothing but the job and its own slice, so viewports can be
+ * emitted concurrently.
+ *
+ * @return Commands for the job's draws
+ */
+static s32 render_emit_draws(RenderEmitJob *job) {
+    RenderDraw *draw;
+    RenderSortStats *st = &job->stats;
+    Gfx *dl = job->dl;
+    const u32 *combine;
+    u32 lastCombine[2], lastMode;
+    s32 lastTex, setCombine, setMode, setTex;
+    s32 i, n;
+
+    lastCombine[0] = 0;         /* Never a valid G_SETCOMBINE */
+    lastCombine[1] = 0;
+    lastMode = 0xFFFFFFFF;
+    lastTex = -2;
+    n = 0;
+
+    for (i = 0; i < job->count; i++) {
+        draw = &job->draws[job->order[i]];
+        combine = sMaterialCombine[draw->material];
+
+        setCombine = combine[0] != lastCombine[0] || combine[1] != lastCombine[1];
+        setMode = sMaterialMode[draw->material] != lastMode;
+        setTex = draw->tex_addr != 0 && draw->texture != lastTex;
+
+        if (dl == NULL) {
+            n += 2 + setCombine + setMode + (setTex ? 7 : 0);
+            if (setCombine || setMode || setTex) {
+                n++;    /* Pipe sync ahead of the state change */
+            }
+            job->cmd_end[i] = (u16)n;
+        } else {
+            if (setCombine || setMode || setTex) {
+                dl[n].words.w0 = 0xE7000000;        /* G_RDPPIPESYNC */
+                dl[n].words.w1 = 0;
+                n++;
+            }
+            if (setCombine) {
+                dl[n].words.w0 = combine[0];
+                dl[n].words.w1 = combine[1];
+                n++;
+                st->combine_set++;
+            } else {
+                st->combine_saved++;
+            }
+            if (setMode) {
+                dl[n].words.w0 = 0xE200001C;        /* G_SETOTHERMODE_L */
+                dl[n].words.w1 = sMaterialMode[draw->material];
+                n++;
+                st->mode_set++;
+            } else {
+                st->mode_saved++;
+            }
+            if (setTex) {
+                n += render_load_texture(&dl[n], &sTexTable[draw->texture], draw->tex_addr);
+                st->tex_loads++;
+            } else if (draw->texture >= 0) {
+                st->tex_saved++;
+            }
+
+            dl[n].words.w0 = 0xDA380003;            /* G_MTX modelview load */
+            dl[n].words.w1 = (u32)draw->mtx;
+            n++;
+            dl[n].words.w0 = 0xDE000000;            /* G_DL */
+            dl[n].words.w1 = (u32)draw->dl;
+            n++;
+            st->draws++;
+        }
+
+        if (setCombine) {
+            lastCombine[0] = combine[0];
+            lastCombine[1] = combine[1];
+        }
+        if (setMode) {
+            lastMode = sMaterialMode[draw->material];
+        }
+        if (setTex) {
+            lastTex = draw->texture;
+        }
+    }
+
+    if (dl != NULL) {
+        dl[n].words.w0 = 0xDF000000;                /* G_ENDDL */
+        dl[n].words.w1 = 0;
+    }
+    n++;
+
+    job->cmds = n;
+    return n;
+}
+
+#ifdef HOST_BUILD
+/*
+ * Emit workers for viewports 1..3, started on first use and kept for the
+ * life of the process. A worker sleeps until handed a job and clears it
+ * when the job's commands are written.
+ */
+typedef struct RenderEmitWorker {
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    RenderEmitJob   *job;       /* NULL = idle */
+    s32             state;      /* 0 = not started, 1 = running, -1 = failed */
+} RenderEmitWorker;
+
+static RenderEmitWorker sEmitWorkers[CULL_MAX_VIEWS - 1];
+
+static void *render_emit_worker(void *arg) {
+    RenderEmitWorker *w = (RenderEmitWorker *)arg;
+    RenderEmitJob *job;
+
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (w->job == NULL) {
+            pthread_cond_wait(&w->cond, &w->lock);
+        }
+        job = w->job;
+        pthread_mutex_unlock(&w->lock);
+
+        render_emit_draws(job);
+
+        pthread_mutex_lock(&w->lock);
+        w->job = NULL;
+        pthread_cond_broadcast(&w->cond);
+    }
+    return NULL;
+}
+
+/**
+ * render_emit_start - Hand a job to a worker, starting it if needed
+ * @return 0 if no worker could be started (run the job inline)
+ */
+static s32 render_emit_start(RenderEmitWorker *w, RenderEmitJob *job) {
+    if (w->state == 0) {
+        pthread_mutex_init(&w->lock, NULL);
+        pthread_cond_init(&w->cond, NULL);
+        w->job = NULL;
+        if (pthread_create(&w->thread, NULL, render_emit_worker, w) != 0) {
+            w->state = -1;
+            return 0;
+        }
+        pthread_detach(w->thread);
+        w->state = 1;
+    }
+    if (w->state < 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&w->lock);
+    w->job = job;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+    return 1;
+}
+
+static void render_emit_wait(RenderEmitWorker *w) {
+    pthread_mutex_lock(&w->lock);
+    while (w->job != NULL) {
+        pthread_cond_wait(&w->cond, &w->lock);
+    }
+    pthread_mutex_unlock(&w->lock);
+}
+#endif
+
+/**
+ * render_draw_flush - Sort queued draws and emit them
+ *
+ * Serial part: convert the queued object matrices in one batch, sort,
+ * resolve texture addresses (the texture cache is not
+ * thread safe), count each viewport's commands and reserve them from its
+ * slice, trimming to a prefix if the slice is short. The writes are then
+ * one independent job per viewport; host builds run them on persistent
+ * worker threads. Each written run is called from the frame list with G_DL, in
+ * viewport order, at the point of the flush, after its viewport's scissor;
+ * the scissor goes back to full screen after the last run. If the frame
+ * list has no room for those words the flush drops every run.
+ *
+ * Leaves gfx_alloc_dl on the last viewport's slice.
+ *
+ * @return Draws emitted
+ */
+s32 render_draw_flush(void) {
+    RenderEmitJob jobs[CULL_MAX_VIEWS];
+    RenderEmitJob *job;
+    RenderDraw *draw;
+    Mtx *mtxBase;
+    Gfx *frame;
+    u16 *order;
+    s16 *r;
+    u32 avail;
+    s32 i, v, k, numJobs, lastTex, emitted, frameCmds, scissored;
+#ifdef HOST_BUILD
+    s32 started[CULL_MAX_VIEWS];
+#endif
+
+    if (sDrawCount == 0) {
+        return 0;
+    }
+
+    /* Per-frame matrices in one batch; if the arena is full their draws go */
+    if (sMtxQueued > 0) {
+        mtxBase = mtx_arena_convert((const f32 (*)[4][4])sMtxQueue, sMtxQueued);
+        k = 0;
+        for (i = 0; i < sDrawCount; i++) {
+            draw = &sDraws[i];
+            if (draw->mtx == NULL) {
+                if (mtxBase == NULL) {
+                    sSortStats.dropped++;
+                    continue;
+                }
+                draw->mtx = &mtxBase[draw->mtx_index];
+            }
+            if (k != i) {
+                sDraws[k] = *draw;
+                sDrawKeys[0][k] = sDrawKeys[0][i];
+            }
+            sDrawOrder[0][k] = (u16)k;
+            k++;
+        }
+        sDrawCount = k;
+        sMtxQueued = 0;
+        if (sDrawCount == 0) {
+            return 0;
+        }
+    }
+
+    order = render_sort_draws();
+
+    /* Table entries with no address are streamed through the texture cache */
+    lastTex = -2;
+    v = -1;
+    for (i = 0; i < sDrawCount; i++) {
+        draw = &sDraws[order[i]];
+        if (draw->view != v) {
+            v = draw->view;
+            lastTex = -2;
+        }
+        if (draw->texture < 0) {
+            draw->tex_addr = 0;
+            continue;
+        }
+        if (draw->texture != lastTex) {
+            draw->tex_addr = sTexTable[draw->texture].address;
+            if (draw->tex_addr == 0 && sTexStream != NULL &&
+                sTexStream[draw->texture] >= 0) {
+                draw->tex_addr = (u32)texcache_get(sTexStream[draw->texture]);
+            }
+            lastTex = draw->texture;
+        } else {
+            draw->tex_addr = sDraws[order[i - 1]].tex_addr;
+        }
+    }
+
+    /* One job per run of same-viewport draws */
+    numJobs = 0;
+    for (i = 0; i < sDrawCount; i = k) {
+        v = sDraws[order[i]].view;
+        for (k = i + 1; k < sDrawCount && sDraws[order[k]].view == v; k++)
+            ;
+
+        job = &jobs[numJobs];
+        memset(&job->stats, 0, sizeof(job->stats));
+        job->draws = sDraws;
+        job->order = &order[i];
+        job->cmd_end = &sDrawCmdEnd[i];
+        job->count = k - i;
+        job->view = v;
+        job->dl = NULL;
+        render_emit_draws(job);
+
+        gfx_arena_set_view(v);
+        job->dl = gfx_alloc_dl((u32)job->cmds);
+        if (job->dl == NULL) {
+            /* Short slice: keep the longest prefix that fits with its G_ENDDL */
+            avail = gfx_dl_free();
+            while (job->count > 0 && (u32)job->cmd_end[job->count - 1] + 1 > avail) {
+                job->count--;
+            }
+            job->stats.dropped += (u32)(k - i - job->count);
+            if (job->count > 0) {
+                job->dl = gfx_alloc_dl((u32)job->cmd_end[job->count - 1] + 1);
+            }
+        }
+        if (job->dl == NULL) {
+            job->count = 0;
+        }
+        numJobs++;
+    }
+
+    /* Frame list words: a scissor and a G_DL per run, then the reset */
+    frameCmds = 0;
+    for (i = 0; i < numJobs; i++) {
+        if (jobs[i].count > 0) {
+            frameCmds += (sViewRect[jobs[i].view][2] > 0) ? 2 : 1;
+        }
+    }
+    if (frameCmds > 0 && !gfx_frame_reserve(*gfx_dl_ptr, (u32)frameCmds + 1)) {
+        for (i = 0; i < numJobs; i++) {
+            jobs[i].stats.dropped += (u32)jobs[i].count;
+            jobs[i].count = 0;
+            jobs[i].dl = NULL;
+        }
+    }
+
+#ifdef HOST_BUILD
+    for (i = 1; i < numJobs; i++) {
+        started[i] = render_emit_start(&sEmitWorkers[i - 1], &jobs[i]);
+        if (!started[i]) {
+            render_emit_draws(&jobs[i]);
+        }
+    }
+    if (numJobs > 0) {
+        render_emit_draws(&jobs[0]);
+    }
+    for (i = 1; i < numJobs; i++) {
+        if (started[i]) {
+            render_emit_wait(&sEmitWorkers[i - 1]);
+        }
+    }
+#else
+    for (i = 0; i < numJobs; i++) {
+        render_emit_draws(&jobs[i]);
+    }
+#endif
+
+    emitted = 0;
+    scissored = 0;
+    frame = *gfx_dl_ptr;
+    for (i = 0; i < numJobs; i++) {
+        job = &jobs[i];
+        if (job->count > 0 && sViewRect[job->view][2] > 0) {
+            r = sViewRect[job->view];
+            frame->words.w0 = 0xED000000 | ((u32)(r[0] << 2) << 12) | (u32)(r[1] << 2);
+            frame->words.w1 = ((u32)((r[0] + r[2]) << 2) << 12) | (u32)((r[1] + r[3]) << 2);
+            frame++;                                /* G_SETSCISSOR */
+            scissored = 1;
+        }
+        if (job->count > 0) {
+            frame->words.w0 = 0xDE000000;           /* G_DL, returns here */
+            frame->words.w1 = (u32)job->dl;
+            frame++;
+        }
+        sSortStats.draws += job->stats.draws;
+        sSortStats.combine_set += job->stats.combine_set;
+        sSortStats.combine_saved += job->stats.combine_saved;
+        sSortStats.mode_set += job->stats.mode_set;
+        sSortStats.mode_saved += job->stats.mode_saved;
+        sSortStats.tex_loads += job->stats.tex_loads;
+        sSortStats.tex_saved += job->stats.tex_saved;
+        sSortStats.dropped += job->stats.dropped;
+        emitted += (s32)job->stats.draws;
+    }
+
+    /* Whatever the frame list draws next (HUD, minimap) is full screen */
+    if (scissored) {
+        frame->words.w0 = 0xED000000;               /* G_SETSCISSOR 0,0 */
+        frame->words.w1 = ((u32)(SCREEN_WIDTH << 2) << 12) | (u32)(SCREEN_HEIGHT << 2);
+        frame++;
+    }
+    *gfx_dl_ptr = frame;
+
+    sDrawCount = 0;
+    return emitted;
+}
+
+/**
+ * render_get_sort_stats - Draw sorting counters for the last frame
+ */
+RenderSortStats *render_get_sort_stats(void) {
+    return &sSortLast;
+}
+
 /* ---- Object Visibility Functions ---- */
 
 /**
@@ -395,6 +1613,94 @@ void MBOX_SetObjectDef(s32 objnum, s32 defnum) {
     }
 
     sRenderObjects[objnum].objnum = defnum;
+    sStaticDirty = 1;
+
+    if (defnum < 0 && sRenderObjects[objnum].mtx_slot >= 0) {
+        mtx_cache_free(sRenderObjects[objnum].mtx_slot);
+        sRenderObjects[objnum].mtx_slot = -1;
+    }
+}
+
+/**
+ * render_set_object_dl - Attach geometry for one detail level
+ *
+ * @param objnum Object index
+ * @param lod Detail level (0 = full, up to LOD_LEVELS - 1)
+ * @param dl Display list; NULL at level 0 draws nothing, at coarser
+ *           levels falls back to the next finer list
+ */
+void render_set_object_dl(s32 objnum, s32 lod, Gfx *dl) {
+    if (objnum < 0 || objnum >= 256 || lod < 0 || lod >= LOD_LEVELS) {
+        return;
+    }
+
+    if (lod == 0) {
+        sRenderObjects[objnum].dl = dl;
+    } else {
+        sRenderObjects[objnum].lod_dl[lod - 1] = dl;
+    }
+}
+
+/**
+ * render_place_object - Put an object at its world position
+ *
+ * Upright at unit scale. Objects with a bound are culled through the
+ * hierarchy, rebuilt at the next render_scene. The transform goes into a
+ * static matrix cache slot, freed when the object's definition is
+ * cleared (MBOX_SetObjectDef with -1).
+ *
+ * @param objnum Object index
+ * @param pos World position
+ * @param yaw Heading about the vertical axis (radians)
+ * @param radius Bounding radius; 0 draws it in every view, at full detail
+ */
+void render_place_object(s32 objnum, const f32 pos[3], f32 yaw, f32 radius) {
+    RenderObject *obj;
+    f32 mf[4][4];
+    f32 s, c;
+    s32 i;
+
+    if (objnum < 0 || objnum >= 256) {
+        return;
+    }
+
+    obj = &sRenderObjects[objnum];
+    s = sinf(yaw);
+    c = cosf(yaw);
+    for (i = 0; i < 3; i++) {
+        obj->pos[i] = pos[i];
+        obj->scale[i] = 1.0f;
+    }
+    obj->orient[0][0] = c;     obj->orient[0][1] = 0.0f;  obj->orient[0][2] = -s;
+    obj->orient[1][0] = 0.0f;  obj->orient[1][1] = 1.0f;  obj->orient[1][2] = 0.0f;
+    obj->orient[2][0] = s;     obj->orient[2][1] = 0.0f;  obj->orient[2][2] = c;
+    obj->parent = -1;
+    obj->radius = (radius > 0.0f) ? radius : 0.0f;
+    obj->lod = 0;
+    sStaticDirty = 1;
+
+    /* Placed objects do not move; keep their matrix converted */
+    if (obj->mtx_slot < 0) {
+        obj->mtx_slot = (s16)mtx_cache_alloc();
+    }
+    if (obj->mtx_slot >= 0) {
+        render_object_float(obj, mf);
+        mtx_cache_set(obj->mtx_slot, (const f32 (*)[4])mf);
+    }
+}
+
+/**
+ * render_set_object_texture - Texture an object draws with
+ *
+ * @param objnum Object index
+ * @param texture render_set_texture_table index, -1 = untextured
+ */
+void render_set_object_texture(s32 objnum, s32 texture) {
+    if (objnum < 0 || objnum >= 256) {
+        return;
+    }
+
+    sRenderObjects[objnum].texture = (s16)((texture < 0) ? -1 : texture);
 }
 
 /**
@@ -579,26 +1885,29 @@ s32 render_cull_sphere(f32 center[3], f32 radius) {
 /**
  * render_cull_box - Test if bounding box is visible
  *
+ * Tests the corner furthest along each plane normal; if even that one is
+ * behind a plane the whole box is.
+ *
  * @param min Box minimum corner
  * @param max Box maximum corner
  * @return 1 if visible, 0 if culled
  */
 s32 render_cull_box(f32 min[3], f32 max[3]) {
-    /* Simple sphere approximation for now */
-    f32 center[3];
-    f32 radius;
-    f32 dx, dy, dz;
+    s32 i;
+    f32 *pl;
 
-    center[0] = (min[0] + max[0]) * 0.5f;
-    center[1] = (min[1] + max[1]) * 0.5f;
-    center[2] = (min[2] + max[2]) * 0.5f;
+    for (i = 0; i < 6; i++) {
+        pl = gFrustumPlanes[i];
 
-    dx = max[0] - min[0];
-    dy = max[1] - min[1];
-    dz = max[2] - min[2];
-    radius = sqrtf(dx * dx + dy * dy + dz * dz) * 0.5f;
+        /* Corner furthest along the normal, picked by sign */
+        if (pl[0] * (pl[0] >= 0.0f ? max[0] : min[0]) +
+            pl[1] * (pl[1] >= 0.0f ? max[1] : min[1]) +
+            pl[2] * (pl[2] >= 0.0f ? max[2] : min[2]) + pl[3] < 0.0f) {
+            return 0;
+        }
+    }
 
-    return render_cull_sphere(center, radius);
+    return 1;
 }
 
 /* ---- Debug Rendering ---- */
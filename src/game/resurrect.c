@@ -39,6 +39,7 @@ extern f32 sqrtf(f32 x);
 extern f32 fabsf(f32 x);
 extern void crossprod(f32 *v1, f32 *v2, f32 *result);
 extern f32 magnitude(f32 *v);
+extern s32 road_get_car_direction(s32 car_index, f32 pos[3], f32 dir[3]);
 
 /*
  * Constants
@@ -486,7 +487,7 @@ void resurrect_car(s32 car_index)
 {
     ResurrectData *res;
     CarData *car;
-    f32 pos[3];
+    f32 pos[3], dir[3], len;
     s32 i, j;
     s32 pole_idx;
 
@@ -532,7 +533,23 @@ void resurrect_car(s32 car_index)
     res->pos[1] = res->save_pos[1] + pole_pos_offset[pole_idx][1];
     res->pos[2] = res->save_pos[2] + pole_pos_offset[pole_idx][2] - 2.0f;
 
-    /* Get target orientation quaternion (would use path direction) */
+    /* Come back level, facing along the road where the car crashed */
+    if (road_get_car_direction(car_index, res->save_pos, dir) >= 0) {
+        len = sqrtf(dir[0] * dir[0] + dir[1] * dir[1]);
+        if (len > 0.0f) {
+            res->uvs[0][0] = dir[0] / len;
+            res->uvs[0][1] = dir[1] / len;
+            res->uvs[0][2] = 0.0f;
+            res->uvs[1][0] = -res->uvs[0][1];
+            res->uvs[1][1] = res->uvs[0][0];
+            res->uvs[1][2] = 0.0f;
+            res->uvs[2][0] = 0.0f;
+            res->uvs[2][1] = 0.0f;
+            res->uvs[2][2] = 1.0f;
+        }
+    }
+
+    /* Get target orientation quaternion */
     make_quat_from_uvs(res->uvs, res->quat_end);
 
     /* Choose shortest rotation path */
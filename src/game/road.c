@@ -26,10 +26,20 @@ extern s32 this_car;
 extern f32 sqrtf(f32 x);
 extern void collision(CarPhysics *m);
 
+#ifdef HOST_BUILD
+#include <string.h>
+#include <time.h>
+extern f32 sinf(f32 x);
+extern f32 cosf(f32 x);
+#endif
+
 /* Global state */
-TrackData *gCurrentTrack = NULL;
+TrackData *gRoadTrack = NULL;
 s32 gTrackLoaded = 0;
 
+/* Road of the loaded track; segments point into its geometry section */
+static TrackData sRoadTrack;
+
 /* Friction table indexed by road code */
 static const f32 friction_table[] = {
     FRICTION_ASPHALT,   /* 0: Asphalt */
@@ -49,12 +59,16 @@ static const f32 friction_table[] = {
 static f32 BODYRWV[3];
 static f32 tuvs[3][3];
 
+/* Segment lookup index */
+static RoadSegIndex sSegIndex;
+
 /**
  * road_init - Initialize road system
  */
 void road_init(void) {
-    gCurrentTrack = NULL;
+    gRoadTrack = NULL;
     gTrackLoaded = 0;
+    sSegIndex.num_segments = 0;
 }
 
 /**
@@ -303,21 +317,211 @@ s32 road_is_shortcut(u8 roadcode) {
 }
 
 /**
- * road_load_track - Load track data
+ * road_load_segments - Take the road from a streamed geometry section
+ *
+ * The section starts with a RoadGeometryHeader and the segment records.
+ * They are used in place, so the section must stay resident until
+ * road_unload_track. A header that does not fit leaves no road loaded.
  *
- * @param track_id Track identifier
+ * @param data Geometry section
+ * @param size Section size in bytes
  */
-void road_load_track(s32 track_id) {
-    /* Track loading would be done from ROM data */
+void road_load_segments(void *data, u32 size) {
+    RoadGeometryHeader *hdr;
+
+    road_unload_track();
+
+    hdr = (RoadGeometryHeader *)data;
+    if (data == NULL || size < sizeof(RoadGeometryHeader) ||
+        hdr->num_segments == 0 || hdr->num_segments > ROAD_MAX_SEGMENTS ||
+        hdr->num_segments * sizeof(RoadSegment) > size - sizeof(RoadGeometryHeader)) {
+        return;
+    }
+
+    sRoadTrack.num_segments = (s32)hdr->num_segments;
+    sRoadTrack.segments = (RoadSegment *)(hdr + 1);
+    sRoadTrack.total_length = hdr->total_length;
+    gRoadTrack = &sRoadTrack;
     gTrackLoaded = 1;
+    road_build_segment_index();
 }
 
 /**
  * road_unload_track - Unload current track
  */
 void road_unload_track(void) {
-    gCurrentTrack = NULL;
+    gRoadTrack = NULL;
     gTrackLoaded = 0;
+    sSegIndex.num_segments = 0;
+}
+
+/**
+ * road_seg_cell_range - Grid cell range covered by a segment
+ *
+ * Covers the segment's XY bounding box grown by its half width.
+ */
+static void road_seg_cell_range(RoadSegment *seg, s32 lo[2], s32 hi[2]) {
+    f32 mn, mx, hw;
+    s32 a;
+
+    hw = seg->width * 0.5f;
+    for (a = 0; a < 2; a++) {
+        mn = (seg->start_pos[a] < seg->end_pos[a]) ? seg->start_pos[a] : seg->end_pos[a];
+        mx = (seg->start_pos[a] > seg->end_pos[a]) ? seg->start_pos[a] : seg->end_pos[a];
+        lo[a] = (s32)((mn - hw - sSegIndex.origin[a]) * sSegIndex.inv_cell[a]);
+        hi[a] = (s32)((mx + hw - sSegIndex.origin[a]) * sSegIndex.inv_cell[a]);
+        if (lo[a] < 0) lo[a] = 0;
+        if (hi[a] >= ROAD_GRID_DIM) hi[a] = ROAD_GRID_DIM - 1;
+    }
+}
+
+/**
+ * road_build_segment_index - Build the segment lookup grid
+ *
+ * Precomputes centerline direction, length and half width for every
+ * segment, then buckets segments into a uniform XY grid by their
+ * bounding boxes so point queries only test a cell's few candidates.
+ * Called once at track load (road_load_segments).
+ */
+void road_build_segment_index(void) {
+    RoadSegment *seg;
+    RoadSegInfo *info;
+    f32 mn[2], mx[2], d[3], len;
+    s32 lo[2], hi[2];
+    s32 i, a, x, y, n, cell;
+    u16 fill[ROAD_GRID_DIM * ROAD_GRID_DIM];
+
+    sSegIndex.num_segments = 0;
+    sSegIndex.queries = 0;
+    sSegIndex.cache_hits = 0;
+    sSegIndex.segments_tested = 0;
+    for (i = 0; i < MAX_CARS; i++) {
+        sSegIndex.car_segment[i] = -1;
+    }
+
+    if (gRoadTrack == NULL || gRoadTrack->segments == NULL) {
+        return;
+    }
+
+    n = gRoadTrack->num_segments;
+    if (n > ROAD_MAX_SEGMENTS) {
+        n = ROAD_MAX_SEGMENTS;
+    }
+    if (n <= 0) {
+        return;
+    }
+
+    /* Per-segment centerline data and overall bounds */
+    mn[0] = mn[1] = 1.0e30f;
+    mx[0] = mx[1] = -1.0e30f;
+    for (i = 0; i < n; i++) {
+        seg = &gRoadTrack->segments[i];
+        info = &sSegIndex.info[i];
+
+        d[0] = seg->end_pos[0] - seg->start_pos[0];
+        d[1] = seg->end_pos[1] - seg->start_pos[1];
+        d[2] = seg->end_pos[2] - seg->start_pos[2];
+        len = sqrtf(d[0] * d[0] + d[1] * d[1]);
+
+        info->start[0] = seg->start_pos[0];
+        info->start[1] = seg->start_pos[1];
+        info->start[2] = seg->start_pos[2];
+        info->length = len;
+        info->half_width = seg->width * 0.5f;
+        if (len > 0.0f) {
+            info->dir[0] = d[0] / len;
+            info->dir[1] = d[1] / len;
+            info->dir[2] = d[2] / len;
+        } else {
+            info->dir[0] = 1.0f;
+            info->dir[1] = 0.0f;
+            info->dir[2] = 0.0f;
+        }
+
+        for (a = 0; a < 2; a++) {
+            if (seg->start_pos[a] - info->half_width < mn[a]) mn[a] = seg->start_pos[a] - info->half_width;
+            if (seg->end_pos[a] - info->half_width < mn[a]) mn[a] = seg->end_pos[a] - info->half_width;
+            if (seg->start_pos[a] + info->half_width > mx[a]) mx[a] = seg->start_pos[a] + info->half_width;
+            if (seg->end_pos[a] + info->half_width > mx[a]) mx[a] = seg->end_pos[a] + info->half_width;
+        }
+    }
+
+    for (a = 0; a < 2; a++) {
+        sSegIndex.origin[a] = mn[a];
+        sSegIndex.inv_cell[a] = (mx[a] > mn[a]) ? (f32)ROAD_GRID_DIM / (mx[a] - mn[a]) : 0.0f;
+    }
+
+    /* Count references per cell */
+    for (i = 0; i <= ROAD_GRID_DIM * ROAD_GRID_DIM; i++) {
+        sSegIndex.cell_start[i] = 0;
+    }
+    for (i = 0; i < n; i++) {
+        road_seg_cell_range(&gRoadTrack->segments[i], lo, hi);
+        for (y = lo[1]; y <= hi[1]; y++) {
+            for (x = lo[0]; x <= hi[0]; x++) {
+                sSegIndex.cell_start[y * ROAD_GRID_DIM + x + 1]++;
+            }
+        }
+    }
+
+    /* Prefix sum into offsets, dropping references past the pool */
+    for (i = 0; i < ROAD_GRID_DIM * ROAD_GRID_DIM; i++) {
+        cell = sSegIndex.cell_start[i] + sSegIndex.cell_start[i + 1];
+        sSegIndex.cell_start[i + 1] = (u16)((cell > ROAD_GRID_MAX_REFS) ? ROAD_GRID_MAX_REFS : cell);
+        fill[i] = sSegIndex.cell_start[i];
+    }
+
+    /* Scatter segment indices into their cells */
+    for (i = 0; i < n; i++) {
+        road_seg_cell_range(&gRoadTrack->segments[i], lo, hi);
+        for (y = lo[1]; y <= hi[1]; y++) {
+            for (x = lo[0]; x <= hi[0]; x++) {
+                cell = y * ROAD_GRID_DIM + x;
+                if (fill[cell] < sSegIndex.cell_start[cell + 1]) {
+                    sSegIndex.refs[fill[cell]++] = (u16)i;
+                }
+            }
+        }
+    }
+
+    sSegIndex.num_segments = n;
+}
+
+/**
+ * road_seg_distance_sq - Squared lateral distance from a segment's centerline
+ *
+ * @param info Segment data
+ * @param pos World position
+ * @return Squared XY distance to the nearest centerline point
+ */
+static f32 road_seg_distance_sq(RoadSegInfo *info, f32 pos[3]) {
+    f32 dx, dy, t;
+
+    dx = pos[0] - info->start[0];
+    dy = pos[1] - info->start[1];
+    t = dx * info->dir[0] + dy * info->dir[1];
+    if (t < 0.0f) {
+        t = 0.0f;
+    } else if (t > info->length) {
+        t = info->length;
+    }
+    dx -= t * info->dir[0];
+    dy -= t * info->dir[1];
+    return dx * dx + dy * dy;
+}
+
+/**
+ * road_seg_contains - Check whether a position lies on a segment's road
+ */
+static s32 road_seg_contains(s32 seg, f32 pos[3]) {
+    RoadSegInfo *info;
+
+    if (seg < 0 || seg >= sSegIndex.num_segments) {
+        return 0;
+    }
+    info = &sSegIndex.info[seg];
+    sSegIndex.segments_tested++;
+    return road_seg_distance_sq(info, pos) <= info->half_width * info->half_width;
 }
 
 /**
@@ -326,7 +530,7 @@ void road_unload_track(void) {
  * @return Pointer to track data or NULL
  */
 TrackData* road_get_track_data(void) {
-    return gCurrentTrack;
+    return gRoadTrack;
 }
 
 /**
@@ -335,8 +539,8 @@ TrackData* road_get_track_data(void) {
  * @return Track length in feet
  */
 f32 road_get_track_length(void) {
-    if (gCurrentTrack != NULL) {
-        return gCurrentTrack->total_length;
+    if (gRoadTrack != NULL) {
+        return gRoadTrack->total_length;
     }
     return 0.0f;
 }
@@ -348,8 +552,118 @@ f32 road_get_track_length(void) {
  * @return Segment index or -1
  */
 s32 road_get_segment_at_pos(f32 pos[3]) {
-    /* Would search track segments */
-    return -1;
+    RoadSegInfo *info;
+    s32 x, y, cell, i, seg, best;
+    f32 d, best_d;
+
+    if (sSegIndex.num_segments == 0) {
+        return -1;
+    }
+
+    sSegIndex.queries++;
+
+    x = (s32)((pos[0] - sSegIndex.origin[0]) * sSegIndex.inv_cell[0]);
+    y = (s32)((pos[1] - sSegIndex.origin[1]) * sSegIndex.inv_cell[1]);
+    if (x < 0 || x >= ROAD_GRID_DIM || y < 0 || y >= ROAD_GRID_DIM) {
+        return -1;
+    }
+
+    /* Nearest centerline among the cell's candidates */
+    cell = y * ROAD_GRID_DIM + x;
+    best = -1;
+    best_d = 1.0e30f;
+    for (i = sSegIndex.cell_start[cell]; i < sSegIndex.cell_start[cell + 1]; i++) {
+        seg = sSegIndex.refs[i];
+        info = &sSegIndex.info[seg];
+        d = road_seg_distance_sq(info, pos);
+        if (d < best_d) {
+            best_d = d;
+            best = seg;
+        }
+    }
+    sSegIndex.segments_tested += sSegIndex.cell_start[cell + 1] - sSegIndex.cell_start[cell];
+
+    return best;
+}
+
+/**
+ * road_get_car_segment - Get road segment under a car
+ *
+ * Checks the car's previous segment and its successor before falling
+ * back to a grid query, since cars rarely skip a segment per frame.
+ *
+ * @param car_index Car index
+ * @param pos Car world position
+ * @return Segment index or -1
+ */
+s32 road_get_car_segment(s32 car_index, f32 pos[3]) {
+    s32 last, seg;
+
+    if (car_index < 0 || car_index >= MAX_CARS) {
+        return road_get_segment_at_pos(pos);
+    }
+
+    last = sSegIndex.car_segment[car_index];
+    if (last >= 0 && last < sSegIndex.num_segments) {
+        if (road_seg_contains(last, pos)) {
+            sSegIndex.queries++;
+            sSegIndex.cache_hits++;
+            return last;
+        }
+        seg = gRoadTrack->segments[last].next_segment;
+        if (road_seg_contains(seg, pos)) {
+            sSegIndex.queries++;
+            sSegIndex.cache_hits++;
+            sSegIndex.car_segment[car_index] = (s16)seg;
+            return seg;
+        }
+    }
+
+    seg = road_get_segment_at_pos(pos);
+    sSegIndex.car_segment[car_index] = (s16)seg;
+    return seg;
+}
+
+/**
+ * road_get_car_direction - Road direction under a car
+ *
+ * @param car_index Car index (its last segment is tried first)
+ * @param pos Car world position
+ * @param dir Output: unit direction, +X off the road
+ * @return Segment index or -1
+ */
+s32 road_get_car_direction(s32 car_index, f32 pos[3], f32 dir[3]) {
+    s32 seg;
+
+    seg = road_get_car_segment(car_index, pos);
+    if (seg < 0) {
+        dir[0] = 1.0f;
+        dir[1] = 0.0f;
+        dir[2] = 0.0f;
+        return -1;
+    }
+
+    dir[0] = sSegIndex.info[seg].dir[0];
+    dir[1] = sSegIndex.info[seg].dir[1];
+    dir[2] = sSegIndex.info[seg].dir[2];
+    return seg;
+}
+
+/**
+ * road_get_car_width - Road width under a car
+ *
+ * @param car_index Car index (its last segment is tried first)
+ * @param pos Car world position
+ * @return Road width in feet
+ */
+f32 road_get_car_width(s32 car_index, f32 pos[3]) {
+    s32 seg;
+
+    seg = road_get_car_segment(car_index, pos);
+    if (seg < 0) {
+        return 40.0f;
+    }
+    return sSegIndex.info[seg].half_width * 2.0f;
 }
 
 /**
@@ -359,10 +673,20 @@ s32 road_get_segment_at_pos(f32 pos[3]) {
  * @param dir Output: direction vector
  */
 void road_get_road_direction(f32 pos[3], f32 dir[3]) {
-    /* Default to forward */
-    dir[0] = 1.0f;
-    dir[1] = 0.0f;
-    dir[2] = 0.0f;
+    s32 seg;
+
+    seg = road_get_segment_at_pos(pos);
+    if (seg < 0) {
+        /* Default to forward */
+        dir[0] = 1.0f;
+        dir[1] = 0.0f;
+        dir[2] = 0.0f;
+        return;
+    }
+
+    dir[0] = sSegIndex.info[seg].dir[0];
+    dir[1] = sSegIndex.info[seg].dir[1];
+    dir[2] = sSegIndex.info[seg].dir[2];
 }
 
 /**
@@ -372,9 +696,142 @@ void road_get_road_direction(f32 pos[3], f32 dir[3]) {
  * @return Road width in feet
  */
 f32 road_get_road_width(f32 pos[3]) {
-    /* Default road width */
-    return 40.0f;
+    s32 seg;
+
+    seg = road_get_segment_at_pos(pos);
+    if (seg < 0) {
+        /* Default road width */
+        return 40.0f;
+    }
+    return sSegIndex.info[seg].half_width * 2.0f;
+}
+
+#ifdef HOST_BUILD
+/* Synthetic track for the lookup bench: header then segments */
+static struct {
+    RoadGeometryHeader  hdr;
+    RoadSegment         seg[ROAD_MAX_SEGMENTS];
+} sRoadBench;
+
+static s64 road_bench_ns(struct timespec *t0, struct timespec *t1) {
+    return (s64)(t1->tv_sec - t0->tv_sec) * 1000000000LL + (t1->tv_nsec - t0->tv_nsec);
+}
+
+/**
+ * road_index_bench - Time segment lookups against a linear scan (host)
+ *
+ * Lays out a closed, winding loop of segments, drives MAX_CARS cars
+ * round it at different lane offsets and speeds, and answers each car's
+ * position three ways: nearest centerline over every segment, the grid
+ * (road_get_segment_at_pos) and the per-car cache (road_get_car_segment).
+ * Replaces any loaded road.
+ *
+ * @param segments Segments in the loop (up to ROAD_MAX_SEGMENTS)
+ * @param frames Frames to drive; every car is queried once per method per frame
+ * @param out Results
+ */
+void road_index_bench(s32 segments, s32 frames, RoadBenchStats *out) {
+    struct timespec t0, t1;
+    f32 pts[MAX_CARS][3];
+    f32 t, a, r, w, lane, d, best_d, dx, dy, len, total;
+    s32 i, c, f, k, best, n, grid, method;
+    s32 answer[MAX_CARS];
+    s64 ns[3];
+    volatile s32 sink;
+    RoadSegment *seg;
+
+    if (segments < 4) {
+        segments = 4;
+    } else if (segments > ROAD_MAX_SEGMENTS) {
+        segments = ROAD_MAX_SEGMENTS;
+    }
+    n = segments;
+
+    /* Winding loop: a circle with a slow radial wave */
+    total = 0.0f;
+    for (i = 0; i < n; i++) {
+        seg = &sRoadBench.seg[i];
+        for (k = 0; k < 2; k++) {
+            a = 6.2831853f * (f32)(i + k) / (f32)n;
+            r = 3000.0f + 600.0f * sinf(a * 5.0f);
+            (k ? seg->end_pos : seg->start_pos)[0] = r * cosf(a);
+            (k ? seg->end_pos : seg->start_pos)[1] = r * sinf(a);
+            (k ? seg->end_pos : seg->start_pos)[2] = 0.0f;
+        }
+        dx = seg->end_pos[0] - seg->start_pos[0];
+        dy = seg->end_pos[1] - seg->start_pos[1];
+        total += sqrtf(dx * dx + dy * dy);
+        seg->width = 40.0f;
+        seg->banking = 0.0f;
+        seg->surface_type = ROAD_ASPHALT;
+        seg->flags = 0;
+        seg->next_segment = (u16)((i + 1) % n);
+        seg->alt_segment = seg->next_segment;
+        seg->checkpoint_id = 0;
+    }
+    sRoadBench.hdr.num_segments = (u32)n;
+    sRoadBench.hdr.total_length = total;
+    road_load_segments(&sRoadBench, sizeof(sRoadBench));
+
+    memset(out, 0, sizeof(*out));
+    ns[0] = ns[1] = ns[2] = 0;
+    sink = 0;
+
+    for (f = 0; f < frames; f++) {
+        /* Each car covers a quarter to a half segment per frame */
+        for (c = 0; c < MAX_CARS; c++) {
+            t = (f32)f * (0.25f + 0.03f * (f32)c) + (f32)c * 7.0f;
+            k = (s32)t % n;
+            w = t - (f32)(s32)t;
+            seg = &sRoadBench.seg[k];
+            dx = seg->end_pos[0] - seg->start_pos[0];
+            dy = seg->end_pos[1] - seg->start_pos[1];
+            len = sqrtf(dx * dx + dy * dy);
+            lane = 15.0f * sinf((f32)(f + c * 13) * 0.05f);
+            pts[c][0] = seg->start_pos[0] + dx * w - dy / len * lane;
+            pts[c][1] = seg->start_pos[1] + dy * w + dx / len * lane;
+            pts[c][2] = 0.0f;
+        }
+
+        for (method = 0; method < 3; method++) {
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            for (c = 0; c < MAX_CARS; c++) {
+                if (method == 0) {
+                    best = -1;
+                    best_d = 1.0e30f;
+                    for (i = 0; i < n; i++) {
+                        d = road_seg_distance_sq(&sSegIndex.info[i], pts[c]);
+                        if (d < best_d) {
+                            best_d = d;
+                            best = i;
+                        }
+                    }
+                    answer[c] = best;
+                } else if (method == 1) {
+                    grid = road_get_segment_at_pos(pts[c]);
+                    if (grid != answer[c]) {
+                        out->mismatches++;
+                    }
+                    sink += grid;
+                } else {
+                    sink += road_get_car_segment(c, pts[c]);
+                }
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            ns[method] += road_bench_ns(&t0, &t1);
+        }
+    }
+
+    out->queries = (u32)(frames * MAX_CARS);
+    if (out->queries != 0) {
+        out->linear_ns = (u32)(ns[0] / out->queries);
+        out->grid_ns = (u32)(ns[1] / out->queries);
+        out->car_ns = (u32)(ns[2] / out->queries);
+    }
+    out->cache_hits = sSegIndex.cache_hits;
+    out->segments_tested = sSegIndex.segments_tested;
 }
+#endif
 
 /**
  * uvinterp - Interpolate unit vectors
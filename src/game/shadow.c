@@ -15,6 +15,8 @@
 #include "types.h"
 #include "game/shadow.h"
 #include "game/visuals.h"
+#include "game/ground.h"
+#include "game/multiplayer.h"
 
 /* ======================= EXTERNAL DECLARATIONS ======================== */
 
@@ -56,6 +58,34 @@ static s32 gShadowPolyPool[8];
 /* Shadow system initialized flag */
 static s32 gShadowInitialized = 0;
 
+/* SHADOW_QUALITY_* level */
+static s32 gShadowQuality = SHADOW_QUALITY_FULL;
+
+/**
+ * shadow_is_local - Car followed by one of this console's viewports
+ *
+ * this_node is player 1's car; in split screen every other active human
+ * player's car has a viewport too.
+ */
+static s32 shadow_is_local(s32 slot) {
+    MPPlayer *p;
+    s32 i;
+
+    if (slot == this_node) {
+        return 1;
+    }
+    if (!mp_is_split_screen()) {
+        return 0;
+    }
+    for (i = 1; i < MP_MAX_PLAYERS; i++) {
+        p = &gMultiplayer.players[i];
+        if (p->active && p->human && p->viewport.active && p->car_index == slot) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
 /* ======================= INITIALIZATION ======================== */
 
 /**
@@ -182,6 +212,13 @@ void shadow_update(s16 slot) {
         return;
     }
 
+    /* Reduced quality drops non-local cars' shadows first, then all of them */
+    if (gShadowQuality == SHADOW_QUALITY_OFF ||
+        (gShadowQuality == SHADOW_QUALITY_LOCAL && !shadow_is_local(slot))) {
+        state->hidden = 1;
+        return;
+    }
+
     /* Check diagonal vertical distance for hide condition */
     /* From arcade: abs(d1) > 8 || abs(d2) > 8 */
     d1 = state->airdist[0] - state->airdist[3];
@@ -263,6 +300,51 @@ void shadow_update(s16 slot) {
     /* ZOID_UpdatePoly(v->objnum, 0, -2, xyz, -1, xlu); */
 }
 
+/**
+ * shadow_set_tires - Record a car's tire positions for this frame
+ * @param slot Car slot index
+ * @param tirePos Tire positions
+ * @param airdist Distance from each tire to the road
+ *
+ * The arcade AnimateShadow reads these from m->reckon. The ground under
+ * each tire (tire height minus airdist) is also published to the ground
+ * cache, so every other ground query near this car reuses the contact
+ * the car already resolved this frame.
+ */
+void shadow_set_tires(s16 slot, f32 tirePos[4][3], f32 airdist[4]) {
+    CarShadowState *state;
+    f32 contacts[4][3];
+    s32 i;
+
+    if (slot < 0 || slot >= 8) {
+        return;
+    }
+
+    state = &gCarShadows[slot];
+    for (i = 0; i < 4; i++) {
+        state->tirePos[i][0] = tirePos[i][0];
+        state->tirePos[i][1] = tirePos[i][1];
+        state->tirePos[i][2] = tirePos[i][2];
+        state->airdist[i] = airdist[i];
+
+        contacts[i][0] = tirePos[i][0];
+        contacts[i][1] = tirePos[i][1] - airdist[i];
+        contacts[i][2] = tirePos[i][2];
+    }
+
+    ground_cache_set_car(slot, contacts);
+}
+
+/**
+ * shadow_set_quality - Limit which cars get shadows
+ * @param quality SHADOW_QUALITY_* level
+ *
+ * Takes effect on each car's next shadow_update.
+ */
+void shadow_set_quality(s32 quality) {
+    gShadowQuality = quality;
+}
+
 /**
  * shadow_remove - Remove shadow for a car
  * @param slot Car slot index
@@ -528,8 +610,8 @@ f32 shadow_calc_scale(f32 height, f32 maxHeight) {
  * @return Ground Y height
  */
 f32 shadow_get_ground_y(f32 x, f32 z) {
-    /* Use replay_start as ground height query (from game.c) */
-    return replay_start(x, z);
+    /* Cached near cars, replay_start (full query) elsewhere */
+    return ground_get_y(x, z);
 }
 
 /**
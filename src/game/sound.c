@@ -6,6 +6,7 @@
  */
 
 #include "types.h"
+#include "PR/os_message.h"
 #include "game/sound.h"
 #include "game/structs.h"
 
@@ -35,6 +36,13 @@ u8 music_volume = 100;
 u8 sfx_volume = 100;
 u8 sound_enabled = 1;
 
+/* Virtual voice helpers (defined with the voice manager) */
+static void snd_voice_move(u8 handle, s32 x, s32 y);
+static void snd_voice_pitch(u8 handle, u16 pitch);
+
+/* Command ring entry point (defined with the ring) */
+static void snd_cmd_submit(const SndCmd *cmd);
+
 /* Current music state */
 static u16 current_music = 0xFFFF;
 static u8 music_playing = 0;
@@ -70,6 +78,8 @@ void sound_init(void) {
     sfx_volume = 100;
     current_music = 0xFFFF;
     music_playing = 0;
+
+    snd_cmd_init();
 }
 
 /**
@@ -96,43 +106,22 @@ void sound_play(u16 sound_id) {
  * @param volume Volume (0-127)
  */
 void sound_play_vol(u16 sound_id, u8 volume) {
-    s32 i;
-    s32 best_channel = -1;
-    u8 lowest_priority = 255;
+    SndCmd c;
 
     if (!sound_enabled) {
         return;
     }
 
-    /* Scale volume by master SFX volume */
-    volume = (u8)((volume * sfx_volume) / 100);
-
-    /* Find free channel or lowest priority channel */
-    for (i = 0; i < NUM_SFX_CHANNELS; i++) {
-        if (!sound_channels[i].playing) {
-            best_channel = i;
-            break;
-        }
-        if (sound_channels[i].priority < lowest_priority) {
-            lowest_priority = sound_channels[i].priority;
-            best_channel = i;
-        }
-    }
-
-    if (best_channel < 0) {
-        return;  /* No channel available */
-    }
-
-    /* Set up channel */
-    sound_channels[best_channel].sound_id = sound_id;
-    sound_channels[best_channel].volume = volume;
-    sound_channels[best_channel].priority = SND_PRIORITY_NORMAL;
-    sound_channels[best_channel].playing = 1;
-    sound_channels[best_channel].looping = 0;
-
-    /* Play sound via N64 audio */
-    /* alSndpPlay(best_channel); */
-    /* alSndpSetVol(best_channel, volume); */
+    c.kind = SNDCMD_START;
+    c.handle = 0;
+    c.priority = SND_PRIORITY_NORMAL;
+    c.pad = 0;
+    c.id = sound_id;
+    c.pitch = 0;
+    c.x = 0;
+    c.y = 0;
+    c.volume = volume;
+    snd_cmd_submit(&c);
 }
 
 /**
@@ -153,28 +142,27 @@ void sound_play_3d(u16 sound_id, f32 pos[3]) {
  * @param sound_id Sound effect ID to stop
  */
 void sound_stop(u16 sound_id) {
-    s32 i;
+    SndCmd c;
 
-    for (i = 0; i < NUM_SFX_CHANNELS; i++) {
-        if (sound_channels[i].sound_id == sound_id && sound_channels[i].playing) {
-            sound_channels[i].playing = 0;
-            /* alSndpStop(i); */
-        }
-    }
+    c.kind = SNDCMD_STOP;
+    c.handle = 0;
+    c.pad = 0;
+    c.id = sound_id;
+    snd_cmd_submit(&c);
 }
 
 /**
  * sound_stop_all - Stop all sound effects
  */
 void sound_stop_all(void) {
+    SndCmd c;
     s32 i;
 
-    for (i = 0; i < NUM_SFX_CHANNELS; i++) {
-        if (sound_channels[i].playing) {
-            sound_channels[i].playing = 0;
-            /* alSndpStop(i); */
-        }
-    }
+    c.kind = SNDCMD_STOP;
+    c.handle = 0;
+    c.pad = SNDCMD_F_ALL;
+    c.id = 0;
+    snd_cmd_submit(&c);
 
     /* Stop engine sounds */
     for (i = 0; i < NUM_ENGINE_CHANNELS; i++) {
@@ -492,12 +480,28 @@ static u8 attract_music = 1;
  * SOUND - Arcade-style sound command
  * Based on arcade: sounds.c SOUND macro
  *
- * This wraps the arcade's SOUND() macro for compatibility.
- * Commands >= 0x8000 are GUTS commands, others are sound IDs.
+ * This wraps the arcade's SOUND() macro for compatibility. Non-matching
+ * builds queue the command for the audio thread (see snd_cmd_submit).
  *
  * @param cmd Sound command or ID
  */
 void SOUND(u16 cmd) {
+    SndCmd c;
+
+    c.kind = SNDCMD_SOUND;
+    c.handle = 0;
+    c.id = cmd;
+    snd_cmd_submit(&c);
+}
+
+/**
+ * sound_exec - Execute a SOUND() command
+ *
+ * Commands >= 0x8000 are GUTS commands, others are sound IDs.
+ *
+ * @param cmd Sound command or ID
+ */
+void sound_exec(u16 cmd) {
     /* Check for attract mode restrictions */
     if (attract_mode_sound) {
         if (cmd < 0x8000 && !attract_effects) {
@@ -745,11 +749,21 @@ void stop_car_select_music(void) {
  * Arcade-compatible function implementations (sounds.c)
  * ======================================================================== */
 
+/* Listener position for voice scoring */
+static s32 snd_listener_x;
+static s32 snd_listener_y;
+
+static s32 snd_start(u16 objID, u8 handle, u8 priority, s32 x, s32 y, u16 pitch);
+
 /**
  * sndUpdate - Per-frame sound queue update
  * Arcade: sounds.c:sndUpdate()
  */
 void sndUpdate(void) {
+#ifdef NON_MATCHING
+    /* Hand this frame's coalesced commands to the audio thread */
+    snd_cmd_flush();
+#endif
     sound_update();
 }
 
@@ -758,8 +772,28 @@ void sndUpdate(void) {
  * Arcade: sounds.c:sndListenerUpdate()
  */
 s32 sndListenerUpdate(s32 x, s32 y, u16 velocity, u16 vel_angle, u16 facing_angle) {
-    /* On N64, 3D audio positioning is handled differently */
-    /* For now, just acknowledge the update */
+    /* Voice scoring measures distance from here */
+    snd_listener_x = x;
+    snd_listener_y = y;
+    return 0;
+}
+
+/**
+ * snd_start - Queue a positional sound start for the voice manager
+ */
+static s32 snd_start(u16 objID, u8 handle, u8 priority, s32 x, s32 y, u16 pitch) {
+    SndCmd c;
+
+    c.kind = SNDCMD_START;
+    c.handle = handle;
+    c.priority = priority;
+    c.pad = SNDCMD_F_POSITIONAL;
+    c.id = objID;
+    c.x = x;
+    c.y = y;
+    c.pitch = pitch;
+    c.volume = 127;
+    snd_cmd_submit(&c);
     return 0;
 }
 
@@ -768,12 +802,7 @@ s32 sndListenerUpdate(s32 x, s32 y, u16 velocity, u16 vel_angle, u16 facing_angl
  * Arcade: sounds.c:sndStartStaticUnpitched()
  */
 s32 sndStartStaticUnpitched(u16 objID, u8 handle, u8 priority, s16 x, s16 y) {
-    f32 pos[3];
-    pos[0] = (f32)x;
-    pos[1] = (f32)y;
-    pos[2] = 0.0f;
-    sound_play_3d(objID, pos);
-    return 0;
+    return snd_start(objID, handle, priority, x, y, 0);
 }
 
 /**
@@ -782,13 +811,8 @@ s32 sndStartStaticUnpitched(u16 objID, u8 handle, u8 priority, s16 x, s16 y) {
  */
 s32 sndStartStaticPitched(u16 objID, u8 handle, u8 priority,
                           s32 x, s32 y, u16 pitch, u8 filter, u8 Q) {
-    f32 pos[3];
-    pos[0] = (f32)x;
-    pos[1] = (f32)y;
-    pos[2] = 0.0f;
-    sound_play_3d(objID, pos);
-    /* Pitch and filter would be applied via N64 audio */
-    return 0;
+    /* Filter would be applied via N64 audio */
+    return snd_start(objID, handle, priority, x, y, pitch);
 }
 
 /**
@@ -797,12 +821,7 @@ s32 sndStartStaticPitched(u16 objID, u8 handle, u8 priority,
  */
 s32 sndStartDopplerUnpitched(u16 objID, u8 handle, u8 priority,
                              s32 x, s32 y, u16 velocity, u16 vel_angle) {
-    f32 pos[3];
-    pos[0] = (f32)x;
-    pos[1] = (f32)y;
-    pos[2] = 0.0f;
-    sound_play_3d(objID, pos);
-    return 0;
+    return snd_start(objID, handle, priority, x, y, 0);
 }
 
 /**
@@ -812,12 +831,7 @@ s32 sndStartDopplerUnpitched(u16 objID, u8 handle, u8 priority,
 s32 sndStartDopplerPitched(u16 objID, u8 handle, u8 priority,
                            s32 x, s32 y, u16 velocity, u16 vel_angle,
                            u16 pitch, u8 filter, u8 Q) {
-    f32 pos[3];
-    pos[0] = (f32)x;
-    pos[1] = (f32)y;
-    pos[2] = 0.0f;
-    sound_play_3d(objID, pos);
-    return 0;
+    return snd_start(objID, handle, priority, x, y, pitch);
 }
 
 /**
@@ -834,7 +848,13 @@ s32 sndPositionSound(u16 objId, u16 angle, u16 volume) {
  * Arcade: sounds.c:sndChangePosition()
  */
 s32 sndChangePosition(u8 handle, s16 x, s16 y) {
-    /* Position changes not directly supported on N64 */
+    SndCmd c;
+
+    c.kind = SNDCMD_POSITION;
+    c.handle = handle;
+    c.x = x;
+    c.y = y;
+    snd_cmd_submit(&c);
     return 0;
 }
 
@@ -852,7 +872,12 @@ s32 sndChangeVelocity(u8 handle, u16 velocity, u16 vel_angle) {
  * Arcade: sounds.c:sndChangePitch()
  */
 s32 sndChangePitch(u8 handle, u16 pitch) {
-    /* Would apply pitch via alSndpSetPitch */
+    SndCmd c;
+
+    c.kind = SNDCMD_PITCH;
+    c.handle = handle;
+    c.pitch = pitch;
+    snd_cmd_submit(&c);
     return 0;
 }
 
@@ -939,7 +964,11 @@ s32 sndUpdateManualEngine(u16 rpm, s16 etorque) {
  */
 #ifdef NON_MATCHING
 s32 sndKillMoob(u16 handle) {
-    /* N64 stub - would send kill command to audio system */
+    SndCmd c;
+
+    c.kind = SNDCMD_KILL;
+    c.handle = (u8)handle;
+    snd_cmd_submit(&c);
     return 0;
 }
 #endif
@@ -987,11 +1016,557 @@ s32 doSndTest(u16 snd_id, u16 pitch, u16 volume) {
 s32 sndUpdateMoobEngine(u16 objID, u8 handle, u8 priority,
                         s32 x, s32 y,
                         u16 velocity, u16 vel_angle, u16 rpm, u16 etorque) {
-    /* N64 stub - would update drone engine with 3D position */
+    SndCmd c;
+
+    c.kind = SNDCMD_MOOB_ENGINE;
+    c.handle = handle;
+    c.priority = priority;
+    c.id = objID;
+    c.x = x;
+    c.y = y;
+    c.velocity = velocity;
+    c.vel_angle = vel_angle;
+    c.pitch = rpm;
+    c.etorque = etorque;
+    snd_cmd_submit(&c);
     return 0;
 }
 #endif
 
+/******* VIRTUAL VOICES *******/
+
+/*
+ * The voice table is owned by whoever executes sound commands: the audio
+ * thread in non-matching builds (via snd_cmd_drain), the caller otherwise.
+ */
+
+static SndVoice snd_voices[SND_MAX_VOICES];
+static SndVoiceStats snd_voice_stats;
+static u32 snd_voice_frame;
+
+/**
+ * snd_voice_score - Rank a voice by audible volume x priority
+ */
+static u32 snd_voice_score(SndVoice *v) {
+    f32 dx, dy, d2, gain;
+
+    gain = 1.0f;
+    if (v->flags & SNDCMD_F_POSITIONAL) {
+        dx = (f32)(v->x - snd_listener_x);
+        dy = (f32)(v->y - snd_listener_y);
+        d2 = dx * dx + dy * dy;
+        gain = (SND_REF_DIST * SND_REF_DIST) / (SND_REF_DIST * SND_REF_DIST + d2);
+    }
+
+    v->audible = (u8)((f32)v->volume * gain);
+    if (v->audible < SND_AUDIBLE_MIN) {
+        return 0;
+    }
+    return (u32)v->audible * ((u32)v->priority + 1);
+}
+
+/**
+ * snd_voice_bind - Give a voice a physical channel
+ *
+ * A revived voice would resume at (snd_voice_frame - start_frame).
+ */
+static void snd_voice_bind(SndVoice *v, s32 ch) {
+    SoundChannel *c = &sound_channels[ch];
+
+    c->sound_id = v->sound_id;
+    c->priority = v->priority;
+    c->volume = v->audible;
+    c->playing = 1;
+    c->looping = v->looping;
+    v->channel = (s8)ch;
+    /* alSndpPlay(ch); alSndpSetVol(ch, v->audible); */
+}
+
+/**
+ * snd_voice_unbind - Virtualize a voice, freeing its channel
+ */
+static void snd_voice_unbind(SndVoice *v) {
+    if (v->channel >= 0) {
+        sound_channels[v->channel].playing = 0;
+        /* alSndpStop(v->channel); */
+        v->channel = -1;
+    }
+}
+
+static void snd_voice_free(SndVoice *v) {
+    snd_voice_unbind(v);
+    v->active = 0;
+    snd_voice_stats.voices--;
+}
+
+/**
+ * snd_voice_weaker - Nonzero if voice a loses to voice b
+ *
+ * Lower score loses; on a tie the older voice does, so a run of equally
+ * ranked one-shots keeps cycling through the channels.
+ */
+static s32 snd_voice_weaker(SndVoice *a, SndVoice *b) {
+    if (a->score != b->score) {
+        return a->score < b->score;
+    }
+    return (s32)(a->start_frame - b->start_frame) < 0;
+}
+
+static SndVoice *snd_voice_find_handle(u8 handle) {
+    s32 i;
+
+    if (handle == 0) {
+        return NULL;
+    }
+    for (i = 0; i < SND_MAX_VOICES; i++) {
+        if (snd_voices[i].active && snd_voices[i].handle == handle) {
+            return &snd_voices[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * snd_voice_start - Request a sound
+ *
+ * The sound always gets a virtual voice unless the table is full of
+ * higher-scoring voices; it gets a channel now if one is free or held
+ * by a voice scoring no higher (the oldest such voice is stolen).
+ *
+ * @param handle Moob handle (nonzero handles loop until killed)
+ * @param positional Nonzero to attenuate by distance from the listener
+ * @return Voice index, or -1 if rejected
+ */
+s32 snd_voice_start(u16 sound_id, u8 handle, u8 priority, u8 volume,
+                    s32 x, s32 y, s32 positional) {
+    SndVoice *v, *victim;
+    SndVoice tmp;
+    s32 i, ch;
+    u32 score;
+
+    tmp.volume = volume;
+    tmp.priority = priority;
+    tmp.flags = positional ? SNDCMD_F_POSITIONAL : 0;
+    tmp.x = x;
+    tmp.y = y;
+    score = snd_voice_score(&tmp);
+
+    snd_voice_stats.starts++;
+
+    /* Restarting a handle reuses its voice */
+    v = snd_voice_find_handle(handle);
+    if (v != NULL) {
+        snd_voice_free(v);
+    }
+
+    v = NULL;
+    victim = NULL;
+    for (i = 0; i < SND_MAX_VOICES; i++) {
+        if (!snd_voices[i].active) {
+            v = &snd_voices[i];
+            break;
+        }
+        if (snd_voices[i].channel < 0 &&
+            (victim == NULL || snd_voice_weaker(&snd_voices[i], victim))) {
+            victim = &snd_voices[i];
+        }
+    }
+    if (v == NULL) {
+        if (victim == NULL || victim->score > score) {
+            snd_voice_stats.rejected++;
+            return -1;
+        }
+        snd_voice_free(victim);
+        v = victim;
+    }
+
+    v->sound_id = sound_id;
+    v->handle = handle;
+    v->priority = priority;
+    v->volume = volume;
+    v->flags = tmp.flags;
+    v->x = x;
+    v->y = y;
+    v->pitch = 0;
+    v->looping = handle != 0;
+    v->start_frame = snd_voice_frame;
+    v->channel = -1;
+    v->active = 1;
+    v->score = score;
+    v->audible = tmp.audible;
+
+    snd_voice_stats.voices++;
+    if (snd_voice_stats.voices > snd_voice_stats.peak_voices) {
+        snd_voice_stats.peak_voices = snd_voice_stats.voices;
+    }
+
+    if (score == 0) {
+        return v - snd_voices;
+    }
+
+    /* Free channel, else steal the weakest unless it outranks us */
+    victim = NULL;
+    for (ch = 0; ch < NUM_SFX_CHANNELS; ch++) {
+        if (!sound_channels[ch].playing) {
+            break;
+        }
+    }
+    if (ch == NUM_SFX_CHANNELS) {
+        for (i = 0; i < SND_MAX_VOICES; i++) {
+            if (snd_voices[i].active && snd_voices[i].channel >= 0 &&
+                (victim == NULL || snd_voice_weaker(&snd_voices[i], victim))) {
+                victim = &snd_voices[i];
+            }
+        }
+        if (victim == NULL || victim->score > score) {
+            return v - snd_voices;
+        }
+        ch = victim->channel;
+        snd_voice_unbind(victim);
+        snd_voice_stats.steals++;
+    }
+    snd_voice_bind(v, ch);
+    return v - snd_voices;
+}
+
+static void snd_voice_move(u8 handle, s32 x, s32 y) {
+    SndVoice *v = snd_voice_find_handle(handle);
+
+    if (v != NULL) {
+        v->x = x;
+        v->y = y;
+    }
+}
+
+static void snd_voice_pitch(u8 handle, u16 pitch) {
+    SndVoice *v = snd_voice_find_handle(handle);
+
+    if (v != NULL) {
+        v->pitch = pitch;
+    }
+}
+
+void snd_voice_kill_handle(u8 handle) {
+    SndVoice *v = snd_voice_find_handle(handle);
+
+    if (v != NULL) {
+        snd_voice_free(v);
+    }
+}
+
+void snd_voice_stop_id(u16 sound_id) {
+    s32 i;
+
+    for (i = 0; i < SND_MAX_VOICES; i++) {
+        if (snd_voices[i].active && snd_voices[i].sound_id == sound_id) {
+            snd_voice_free(&snd_voices[i]);
+        }
+    }
+}
+
+void snd_voice_stop_all(void) {
+    s32 i;
+
+    for (i = 0; i < SND_MAX_VOICES; i++) {
+        if (snd_voices[i].active) {
+            snd_voice_free(&snd_voices[i]);
+        }
+    }
+}
+
+/**
+ * snd_voice_update - Re-rank voices and reassign channels (audio frame)
+ *
+ * Expires finished one-shots (virtual or not), rescores the rest, and
+ * makes the channel owners exactly the top NUM_SFX_CHANNELS audible
+ * voices.
+ */
+void snd_voice_update(void) {
+    u8 order[SND_MAX_VOICES];
+    u8 keep[SND_MAX_VOICES];
+    SndVoice *v;
+    s32 i, j, n, best, ch;
+    u8 t;
+
+    snd_voice_frame++;
+
+    n = 0;
+    for (i = 0; i < SND_MAX_VOICES; i++) {
+        v = &snd_voices[i];
+        keep[i] = 0;
+        if (!v->active) {
+            continue;
+        }
+        if (!v->looping && snd_voice_frame - v->start_frame >= SND_ONESHOT_FRAMES) {
+            snd_voice_free(v);
+            snd_voice_stats.expired++;
+            continue;
+        }
+        v->score = snd_voice_score(v);
+        if (v->channel >= 0) {
+            sound_channels[v->channel].volume = v->audible;
+        }
+        if (v->score != 0) {
+            order[n++] = (u8)i;
+        }
+    }
+
+    /* Partial selection sort: top NUM_SFX_CHANNELS, newest first on ties */
+    for (i = 0; i < n && i < NUM_SFX_CHANNELS; i++) {
+        best = i;
+        for (j = i + 1; j < n; j++) {
+            if (snd_voice_weaker(&snd_voices[order[best]], &snd_voices[order[j]])) {
+                best = j;
+            }
+        }
+        t = order[i];
+        order[i] = order[best];
+        order[best] = t;
+        keep[order[i]] = 1;
+    }
+
+    /* Virtualize losers first so their channels are free */
+    for (i = 0; i < SND_MAX_VOICES; i++) {
+        v = &snd_voices[i];
+        if (v->active && v->channel >= 0 && !keep[i]) {
+            snd_voice_unbind(v);
+            snd_voice_stats.steals++;
+        }
+    }
+
+    ch = 0;
+    for (i = 0; i < SND_MAX_VOICES; i++) {
+        v = &snd_voices[i];
+        if (!keep[i] || v->channel >= 0) {
+            continue;
+        }
+        while (ch < NUM_SFX_CHANNELS && sound_channels[ch].playing) {
+            ch++;
+        }
+        if (ch == NUM_SFX_CHANNELS) {
+            break;
+        }
+        snd_voice_bind(v, ch);
+        snd_voice_stats.revivals++;
+    }
+
+    snd_voice_stats.physical = 0;
+    for (i = 0; i < SND_MAX_VOICES; i++) {
+        if (snd_voices[i].active && snd_voices[i].channel >= 0) {
+            snd_voice_stats.physical++;
+        }
+    }
+    snd_voice_stats.pressure_pct = snd_voice_stats.voices * 100 / NUM_SFX_CHANNELS;
+}
+
+/**
+ * snd_voice_get_stats - Get channel pressure counters
+ */
+SndVoiceStats *snd_voice_get_stats(void) {
+    return &snd_voice_stats;
+}
+
+/******* GAME -> AUDIO COMMAND RING *******/
+
+/*
+ * Per-handle updates (position, pitch, moob engine) arrive several times a
+ * frame per car; only the last one matters by the time the audio thread
+ * runs. The game thread stages commands in order; a newer update of the
+ * same kind and handle cancels the staged one and goes on the tail, so it
+ * still lands after any start or one-shot staged in between. The batch is
+ * then published into an OSSpscQueue. Messages point into a command pool twice the
+ * ring size, so a slot is never rewritten while the audio thread could
+ * still be reading it.
+ */
+
+static SndCmd snd_stage[SND_CMD_STAGE_MAX];
+static s32 snd_stage_count;
+static u8 snd_stage_slot[SNDCMD_NUM_KINDS][256];   /* Staged index + 1 */
+
+static OSSpscQueue snd_cmd_queue;
+static OSMesg snd_cmd_msgs[SND_CMD_RING_SIZE];
+static SndCmd snd_cmd_pool[SND_CMD_RING_SIZE * 2];
+static u32 snd_cmd_pool_next;
+
+static SndCmdStats snd_cmd_stats;
+
+#define SNDCMD_COALESCES(kind)  ((kind) >= SNDCMD_POSITION && (kind) <= SNDCMD_MOOB_ENGINE)
+
+static void snd_cmd_exec(const SndCmd *c);
+
+/**
+ * snd_cmd_init - Reset the command ring
+ */
+void snd_cmd_init(void) {
+    s32 i, k;
+
+    osCreateSpscQueue(&snd_cmd_queue, snd_cmd_msgs, SND_CMD_RING_SIZE);
+    snd_cmd_pool_next = 0;
+    snd_stage_count = 0;
+
+    for (k = 0; k < SNDCMD_NUM_KINDS; k++) {
+        for (i = 0; i < 256; i++) {
+            snd_stage_slot[k][i] = 0;
+        }
+    }
+
+    snd_cmd_stats.issued = 0;
+    snd_cmd_stats.coalesced = 0;
+    snd_cmd_stats.queued = 0;
+    snd_cmd_stats.dropped = 0;
+    snd_cmd_stats.drained = 0;
+}
+
+/**
+ * snd_cmd_stage - Stage a command for this frame (game thread)
+ *
+ * @param cmd Command to stage (copied)
+ */
+static void snd_cmd_stage(const SndCmd *cmd) {
+    u8 *slot;
+    s32 k;
+
+    snd_cmd_stats.issued++;
+
+    if (SNDCMD_COALESCES(cmd->kind)) {
+        slot = &snd_stage_slot[cmd->kind][cmd->handle];
+        if (*slot != 0) {
+            /* Last update wins, in its own place in the order */
+            snd_stage[*slot - 1].kind = SNDCMD_NONE;
+            *slot = 0;
+            snd_cmd_stats.coalesced++;
+        }
+    }
+
+    if (snd_stage_count >= SND_CMD_STAGE_MAX) {
+        snd_cmd_flush();
+    }
+
+    snd_stage[snd_stage_count] = *cmd;
+    snd_stage_count++;
+    if (SNDCMD_COALESCES(cmd->kind)) {
+        snd_stage_slot[cmd->kind][cmd->handle] = (u8)snd_stage_count;
+    } else if (cmd->kind != SNDCMD_SOUND) {
+        /* Updates after a start/kill must not fold into ones before it */
+        for (k = SNDCMD_POSITION; k <= SNDCMD_MOOB_ENGINE; k++) {
+            snd_stage_slot[k][cmd->handle] = 0;
+        }
+    }
+}
+
+/**
+ * snd_cmd_submit - Route a command to the audio side
+ *
+ * Non-matching builds stage it for the ring; matching builds have no
+ * drain hook and execute it immediately.
+ */
+static void snd_cmd_submit(const SndCmd *cmd) {
+#ifdef NON_MATCHING
+    snd_cmd_stage(cmd);
+#else
+    snd_cmd_exec(cmd);
+#endif
+}
+
+/**
+ * snd_cmd_flush - Publish staged commands to the audio thread (game thread)
+ */
+void snd_cmd_flush(void) {
+    SndCmd *c;
+    s32 i;
+
+    for (i = 0; i < snd_stage_count; i++) {
+        c = &snd_stage[i];
+        if (c->kind == SNDCMD_NONE) {
+            continue;
+        }
+        if (SNDCMD_COALESCES(c->kind)) {
+            snd_stage_slot[c->kind][c->handle] = 0;
+        }
+
+        snd_cmd_pool[snd_cmd_pool_next & (SND_CMD_RING_SIZE * 2 - 1)] = *c;
+        if (osSpscSend(&snd_cmd_queue,
+                       &snd_cmd_pool[snd_cmd_pool_next & (SND_CMD_RING_SIZE * 2 - 1)],
+                       OS_MESG_NOBLOCK) == 0) {
+            snd_cmd_pool_next++;
+            snd_cmd_stats.queued++;
+        } else {
+            snd_cmd_stats.dropped++;
+        }
+    }
+
+    snd_stage_count = 0;
+}
+
+/**
+ * snd_cmd_exec - Apply one command (audio thread)
+ */
+static void snd_cmd_exec(const SndCmd *c) {
+    switch (c->kind) {
+        case SNDCMD_SOUND:
+            sound_exec(c->id);
+            break;
+
+        case SNDCMD_POSITION:
+            snd_voice_move(c->handle, c->x, c->y);
+            break;
+
+        case SNDCMD_PITCH:
+            /* Would apply pitch via alSndpSetPitch */
+            snd_voice_pitch(c->handle, c->pitch);
+            break;
+
+        case SNDCMD_MOOB_ENGINE:
+            /* Would update drone engine with 3D position */
+            snd_voice_move(c->handle, c->x, c->y);
+            snd_voice_pitch(c->handle, c->pitch);
+            break;
+
+        case SNDCMD_START:
+            if (sound_enabled) {
+                /* Scale volume by master SFX volume */
+                snd_voice_start(c->id, c->handle, c->priority,
+                                (u8)((c->volume * sfx_volume) / 100), c->x, c->y,
+                                c->pad & SNDCMD_F_POSITIONAL);
+                snd_voice_pitch(c->handle, c->pitch);
+            }
+            break;
+
+        case SNDCMD_KILL:
+            snd_voice_kill_handle(c->handle);
+            break;
+
+        case SNDCMD_STOP:
+            if (c->pad & SNDCMD_F_ALL) {
+                snd_voice_stop_all();
+            } else {
+                snd_voice_stop_id(c->id);
+            }
+            break;
+    }
+}
+
+/**
+ * snd_cmd_drain - Execute everything queued so far (audio thread)
+ *
+ * Called once per audio frame.
+ */
+void snd_cmd_drain(void) {
+    OSMesg msg;
+
+    while (osSpscRecv(&snd_cmd_queue, &msg, OS_MESG_NOBLOCK) == 0) {
+        snd_cmd_exec((SndCmd *)msg);
+        snd_cmd_stats.drained++;
+    }
+}
+
+/**
+ * snd_cmd_get_stats - Get command ring counters
+ */
+SndCmdStats *snd_cmd_get_stats(void) {
+    return &snd_cmd_stats;
+}
+
 /******* ARCADE-COMPATIBLE CAR SOUND FUNCTIONS (carsnd.c) *******/
 
 /* ========================================================================
@@ -0,0 +1,362 @@
+/**
+ * texcache.c - Track texture residency cache
+ *
+ * Slot pool is a flat array of TEXCACHE_SLOT_SIZE blocks, 8-byte aligned
+ * for the RDP. Entries map a texture id to its ROM image and, while
+ * resident, to the slot holding it. Slots record the frame they were last
+ * handed out, which is both the LRU order and the in-flight guard.
+ *
+ * Stats roll over when the local player's maxpath lap changes; the
+ * finished lap's counters stay readable until the next rollover.
+ */
+
+#include "types.h"
+#include "PR/os.h"
+#include "game/texcache.h"
+#include "game/maxpath.h"
+
+#ifdef NON_MATCHING
+
+extern void dma_read(void *dest, u32 rom_addr, u32 size);
+extern s32 inflate_decompress(void *src, void *dst, s32 use_heap);
+extern void *memset(void *s, s32 c, u32 n);
+extern s32 this_node;
+
+typedef struct TexEntry {
+    u32     rom_addr;
+    u32     rom_size;           /* 0 = not registered */
+    u16     ram_size;           /* Decompressed size */
+    u16     sections;           /* Bit per track section using it */
+    u8      flags;
+    s8      slot;               /* -1 = not resident */
+    u8      pad[2];
+} TexEntry;
+
+typedef struct TexSlot {
+    s16     id;                 /* Owning texture, -1 = free */
+    s16     pad;
+    u32     last_used;          /* sTexFrame when last handed out */
+} TexSlot;
+
+static u64 sTexPool[TEXCACHE_MAX_SLOTS][TEXCACHE_SLOT_SIZE / sizeof(u64)];
+static u64 sTexStage[TEXCACHE_SLOT_SIZE / sizeof(u64)];   /* Deflated image */
+
+static TexEntry sTexEntries[TEXCACHE_MAX_TEXTURES];
+static TexSlot sTexSlots[TEXCACHE_MAX_SLOTS];
+static s32 sTexBudget = TEXCACHE_MAX_SLOTS;
+static u32 sTexFrame = 2;
+
+static TexCacheStats sTexStats;
+static TexCacheStats sTexLast;
+
+/* ---- Slots ---- */
+
+/**
+ * texcache_evict - Drop a slot's texture
+ */
+static void texcache_evict(s32 s) {
+    TexSlot *sl = &sTexSlots[s];
+
+    if (sl->id >= 0) {
+        sTexEntries[sl->id].slot = -1;
+        sl->id = -1;
+        sTexStats.evictions++;
+    }
+}
+
+/**
+ * texcache_evictable - Slot not handed out this frame or last frame
+ *
+ * Applies to free slots too: a slot freed by texcache_register or
+ * texcache_flush keeps its last_used, since the RDP may still be reading
+ * the image it held.
+ */
+static s32 texcache_evictable(s32 s) {
+    return sTexSlots[s].last_used + 1 < sTexFrame;
+}
+
+/**
+ * texcache_pick_slot - Free slot within budget, else least recently used
+ * @return Slot index, or -1 if every slot may still be in flight
+ */
+static s32 texcache_pick_slot(void) {
+    s32 s, best;
+    u32 oldest;
+
+    best = -1;
+    oldest = 0xFFFFFFFF;
+    for (s = 0; s < sTexBudget; s++) {
+        if (!texcache_evictable(s)) {
+            continue;
+        }
+        if (sTexSlots[s].id < 0) {
+            return s;
+        }
+        if (sTexSlots[s].last_used < oldest) {
+            oldest = sTexSlots[s].last_used;
+            best = s;
+        }
+    }
+    return best;
+}
+
+/**
+ * texcache_load - DMA (and inflate) a texture into a slot
+ * @param id Registered texture id
+ * @param prefetch Nonzero if loaded ahead of use
+ * @return Slot data, or NULL if no slot could be freed or the image is bad
+ *
+ * An image that fails to inflate, or inflates past the slot, is
+ * unregistered so later lookups fall back to texture_data_array.
+ */
+static void *texcache_load(s32 id, s32 prefetch) {
+    TexEntry *e = &sTexEntries[id];
+    void *dst;
+    s32 s;
+    u32 size;
+
+    s = texcache_pick_slot();
+    if (s < 0) {
+        sTexStats.refused++;
+        return NULL;
+    }
+    texcache_evict(s);
+    dst = sTexPool[s];
+
+    if (e->flags & TEXCACHE_FLAG_COMPRESSED) {
+        osInvalDCache(sTexStage, e->rom_size);
+        dma_read(sTexStage, e->rom_addr, e->rom_size);
+        size = (u32)inflate_decompress(sTexStage, dst, 0);
+        if (size == 0 || size > TEXCACHE_SLOT_SIZE) {
+            /* Slot stays free; drop the entry rather than retry it */
+            e->rom_size = 0;
+            sTexStats.failed++;
+            return NULL;
+        }
+        sTexStats.bytes_decompressed += size;
+    } else {
+        osInvalDCache(dst, e->rom_size);
+        dma_read(dst, e->rom_addr, e->rom_size);
+        size = e->rom_size;
+    }
+    /* RDP reads RDRAM, not the CPU cache */
+    osWritebackDCache(dst, size);
+    sTexStats.bytes_loaded += e->rom_size;
+
+    sTexSlots[s].id = (s16)id;
+    sTexSlots[s].last_used = sTexFrame;
+    e->slot = (s8)s;
+
+    if (prefetch) {
+        sTexStats.prefetches++;
+    } else {
+        sTexStats.misses++;
+    }
+    return dst;
+}
+
+/* ---- Setup ---- */
+
+/**
+ * texcache_init - Forget every texture and empty the pool
+ */
+void texcache_init(void) {
+    s32 i;
+
+    for (i = 0; i < TEXCACHE_MAX_TEXTURES; i++) {
+        sTexEntries[i].rom_size = 0;
+        sTexEntries[i].slot = -1;
+    }
+    for (i = 0; i < TEXCACHE_MAX_SLOTS; i++) {
+        sTexSlots[i].id = -1;
+        sTexSlots[i].last_used = 0;
+    }
+    sTexBudget = TEXCACHE_MAX_SLOTS;
+    sTexFrame = 2;
+
+    memset(&sTexStats, 0, sizeof(sTexStats));
+    memset(&sTexLast, 0, sizeof(sTexLast));
+    sTexStats.lap = -1;
+    sTexLast.lap = -1;
+}
+
+/**
+ * texcache_set_budget - Limit the slots the cache may fill
+ * @param slots Slot count (clamped to 1..TEXCACHE_MAX_SLOTS)
+ *
+ * Slots above a lowered budget are released by texcache_frame once the
+ * RDP is done with them.
+ */
+void texcache_set_budget(s32 slots) {
+    if (slots < 1) {
+        slots = 1;
+    }
+    if (slots > TEXCACHE_MAX_SLOTS) {
+        slots = TEXCACHE_MAX_SLOTS;
+    }
+    sTexBudget = slots;
+}
+
+/**
+ * texcache_register - Describe a texture's ROM image
+ * @param id Texture id (texture_data_array index)
+ * @param rom_addr ROM address of the image
+ * @param rom_size Bytes in ROM
+ * @param ram_size Bytes once decompressed
+ * @param flags TEXCACHE_FLAG_*
+ * @param section_mask Bit per track section that draws it (0 = never prefetch)
+ *
+ * Images that do not fit one slot are not registered and keep using
+ * texture_data_array.
+ */
+void texcache_register(s32 id, u32 rom_addr, u32 rom_size, u32 ram_size,
+                       u32 flags, u16 section_mask) {
+    TexEntry *e;
+
+    if (id < 0 || id >= TEXCACHE_MAX_TEXTURES) {
+        return;
+    }
+    if (rom_size == 0 || rom_size > TEXCACHE_SLOT_SIZE ||
+        ram_size > TEXCACHE_SLOT_SIZE) {
+        return;
+    }
+
+    e = &sTexEntries[id];
+    if (e->slot >= 0) {
+        sTexSlots[e->slot].id = -1;
+    }
+    e->rom_addr = rom_addr;
+    e->rom_size = rom_size;
+    e->ram_size = (u16)ram_size;
+    e->sections = section_mask;
+    e->flags = (u8)flags;
+    e->slot = -1;
+}
+
+/**
+ * texcache_flush - Drop every resident texture and registration (track change)
+ *
+ * Slots keep last_used, so none is refilled while the last two frames'
+ * display lists may still sample it.
+ */
+void texcache_flush(void) {
+    s32 i, s;
+
+    for (i = 0; i < TEXCACHE_MAX_TEXTURES; i++) {
+        sTexEntries[i].rom_size = 0;
+    }
+    for (s = 0; s < TEXCACHE_MAX_SLOTS; s++) {
+        if (sTexSlots[s].id >= 0) {
+            sTexEntries[sTexSlots[s].id].slot = -1;
+            sTexSlots[s].id = -1;
+        }
+    }
+}
+
+/* ---- Per frame ---- */
+
+/**
+ * texcache_roll_lap - Close out the stats when the player's lap changes
+ */
+static void texcache_roll_lap(void) {
+    s32 lap;
+    u32 total;
+
+    lap = maxpath_get_lap(this_node);
+    if (lap == sTexStats.lap) {
+        return;
+    }
+
+    total = sTexStats.hits + sTexStats.misses;
+    sTexStats.hit_pct = total ? (sTexStats.hits * 100) / total : 100;
+    sTexLast = sTexStats;
+
+    memset(&sTexStats, 0, sizeof(sTexStats));
+    sTexStats.lap = lap;
+}
+
+/**
+ * texcache_frame - Advance the frame, trim the budget and prefetch
+ */
+void texcache_frame(void) {
+    TexEntry *e;
+    s32 i, s, section, loads;
+    u16 want;
+
+    sTexFrame++;
+    texcache_roll_lap();
+    sTexStats.frames++;
+
+    for (s = sTexBudget; s < TEXCACHE_MAX_SLOTS; s++) {
+        if (sTexSlots[s].id >= 0 && texcache_evictable(s)) {
+            texcache_evict(s);
+        }
+    }
+
+    section = maxpath_get_section(this_node, TEXCACHE_SECTIONS);
+    if (section < 0) {
+        return;
+    }
+    want = (u16)((1 << section) |
+                 (1 << ((section + 1) % TEXCACHE_SECTIONS)));
+
+    loads = 0;
+    for (i = 0; i < TEXCACHE_MAX_TEXTURES && loads < TEXCACHE_PREFETCH; i++) {
+        e = &sTexEntries[i];
+        if (e->rom_size == 0 || e->slot >= 0 || !(e->sections & want)) {
+            continue;
+        }
+        if (texcache_load(i, 1) == NULL) {
+            if (e->rom_size == 0) {
+                continue;
+            }
+            /* Everything is in flight; try again next frame */
+            break;
+        }
+        loads++;
+    }
+}
+
+/**
+ * texcache_get - Resident copy of a texture, loading it on a miss
+ * @param id Texture id
+ * @return Texture data, or NULL if unregistered or no slot is free
+ */
+void *texcache_get(s32 id) {
+    TexEntry *e;
+
+    if (id < 0 || id >= TEXCACHE_MAX_TEXTURES) {
+        return NULL;
+    }
+    e = &sTexEntries[id];
+    if (e->rom_size == 0) {
+        return NULL;
+    }
+
+    if (e->slot >= 0) {
+        sTexSlots[e->slot].last_used = sTexFrame;
+        sTexStats.hits++;
+        return sTexPool[e->slot];
+    }
+    return texcache_load(id, 0);
+}
+
+/**
+ * texcache_is_resident - Check for a texture without loading it
+ */
+s32 texcache_is_resident(s32 id) {
+    if (id < 0 || id >= TEXCACHE_MAX_TEXTURES) {
+        return 0;
+    }
+    return sTexEntries[id].slot >= 0;
+}
+
+/**
+ * texcache_get_stats - Counters for the current or the last finished lap
+ * @param last_lap Nonzero for the last finished lap
+ */
+TexCacheStats *texcache_get_stats(s32 last_lap) {
+    return last_lap ? &sTexLast : &sTexStats;
+}
+
+#endif /* NON_MATCHING */
@@ -7,6 +7,7 @@
 
 #include "types.h"
 #include "game/structs.h"
+#include "game/timer.h"
 
 /* External OS timing functions */
 extern u64 osGetTime(void);
@@ -191,24 +192,67 @@ s32 countdown_get_value(void) {
 static u32 last_frame_count;
 static f32 delta_time;
 
+/* Fixed-step accumulator, in osGetCount() counts so it never drifts */
+#define PHYSICS_STEP_COUNTS (COUNT_PER_SEC / PHYSICS_HZ)
+
+static u32 physics_accum;        /* Counts not yet simulated */
+static s32 physics_steps;        /* Substeps due this frame */
+static FrameTimeStats frame_stats;
+
 /**
  * frame_time_init - Initialize frame timing
  */
 void frame_time_init(void) {
     last_frame_count = osGetCount();
     delta_time = 1.0f / 60.0f;  /* Default to 60 FPS */
+
+    physics_accum = 0;
+    physics_steps = 0;
+    frame_stats.frames = 0;
+    frame_stats.substeps_total = 0;
+    frame_stats.substeps_last = 0;
+    frame_stats.substeps_max = 0;
+    frame_stats.idle_frames = 0;
+    frame_stats.clamped_frames = 0;
 }
 
 /**
  * frame_time_update - Update frame delta time
  *
- * Called at start of each frame to calculate delta time.
+ * Called at start of each frame to calculate delta time. Also feeds the
+ * fixed-step accumulator: at 30 fps split screen two 1/60s substeps are
+ * due per frame, at 60 fps one, so handling does not depend on render rate.
  */
 void frame_time_update(void) {
     u32 current = osGetCount();
     u32 elapsed = current - last_frame_count;
     last_frame_count = current;
 
+    /* Long stalls (loads, pause) are dropped rather than replayed */
+    if (elapsed > PHYSICS_STEP_COUNTS * PHYSICS_MAX_SUBSTEPS) {
+        elapsed = PHYSICS_STEP_COUNTS * PHYSICS_MAX_SUBSTEPS;
+        frame_stats.clamped_frames++;
+    }
+    physics_accum += elapsed;
+    physics_steps = (s32)(physics_accum / PHYSICS_STEP_COUNTS);
+    if (physics_steps > PHYSICS_MAX_SUBSTEPS) {
+        physics_steps = PHYSICS_MAX_SUBSTEPS;
+    }
+    physics_accum -= (u32)physics_steps * PHYSICS_STEP_COUNTS;
+    if (physics_accum >= PHYSICS_STEP_COUNTS) {
+        physics_accum = PHYSICS_STEP_COUNTS - 1;
+    }
+
+    frame_stats.frames++;
+    frame_stats.substeps_total += physics_steps;
+    frame_stats.substeps_last = physics_steps;
+    if (physics_steps > frame_stats.substeps_max) {
+        frame_stats.substeps_max = physics_steps;
+    }
+    if (physics_steps == 0) {
+        frame_stats.idle_frames++;
+    }
+
     /* Convert to seconds */
     delta_time = (f32)elapsed / (f32)COUNT_PER_SEC;
 
@@ -241,6 +285,36 @@ f32 frame_time_get_fps(void) {
     return 60.0f;
 }
 
+/**
+ * frame_time_physics_steps - Get physics substeps due this frame
+ *
+ * @return Number of PHYSICS_HZ steps to run (0..PHYSICS_MAX_SUBSTEPS)
+ */
+s32 frame_time_physics_steps(void) {
+    return physics_steps;
+}
+
+/**
+ * frame_time_get_alpha - Get render interpolation factor
+ *
+ * Fraction of a physics step elapsed since the last substep; rendered
+ * transforms blend the previous and current physics states by this.
+ *
+ * @return Blend factor in [0, 1)
+ */
+f32 frame_time_get_alpha(void) {
+    return (f32)physics_accum / (f32)PHYSICS_STEP_COUNTS;
+}
+
+/**
+ * frame_time_get_stats - Get frame/substep statistics
+ *
+ * @return Pointer to live stats
+ */
+FrameTimeStats *frame_time_get_stats(void) {
+    return &frame_stats;
+}
+
 /******* ARCADE-COMPATIBLE TIMING FUNCTIONS *******/
 /* Based on arcade game/sselect.c timing system */
 /* Uses millisecond time base like arcade IRQTIME */
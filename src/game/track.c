@@ -5,15 +5,32 @@
  */
 
 #include "game/track.h"
+#include "game/render.h"
+#include "PR/os_pi.h"
+
+#ifdef HOST_BUILD
+#include <time.h>
+#endif
 
 /* External functions */
 extern void *malloc(u32 size);
 extern void free(void *ptr);
-extern void dma_read(void *dest, u32 rom_addr, u32 size);
-extern s32 inflate_decompress(void *dest, void *src, u32 src_size);
+extern void *memcpy(void *dst, const void *src, u32 n);
+extern s32 inflate_decompress(void *src, void *dst, s32 use_heap);
+extern void osInvalDCache(void *addr, u32 size);
+extern u32 osGetCount(void);
 extern f32 sqrtf(f32 x);
 extern f32 fabsf(f32 x);
 
+/* Section consumers */
+extern void maxpath_load_data(void *data, u32 size);
+extern void boost_load_pads(void *track_data, u32 size);
+extern void road_load_segments(void *data, u32 size);
+extern void road_unload_track(void);
+extern void texcache_register(s32 id, u32 rom_addr, u32 rom_size, u32 ram_size,
+                              u32 flags, u16 section_mask);
+extern void texcache_flush(void);
+
 /* Global track manager */
 TrackManager gTracks;
 
@@ -48,6 +65,21 @@ static const char *sStuntArenaNames[MAX_STUNT_ARENAS] = {
     "Sky Ramps"
 };
 
+/* Directory index, read at each track_load */
+static TrackDirIndex sTrackDirIndex;
+
+/* Render texture table for the streamed textures (address 0 = cache) */
+static TextureInfo sTrackTexInfo[TRACK_MAX_TEXTURES];
+static s16 sTrackTexIds[TRACK_MAX_TEXTURES];
+
+/* Sections placed objects are built from */
+#define TRACK_OBJECT_SECTIONS   ((1 << TRACK_SECTION_GEOMETRY) | (1 << TRACK_SECTION_TARGETS))
+
+/* Section streaming DMA */
+static OSIoMesg sTrackDmaMsg;
+static OSMesgQueue sTrackDmaQueue;
+static OSMesg sTrackDmaMsgBuf[1];
+
 /* Default checkpoint bonus times per difficulty */
 static const f32 sDefaultBonusTimes[NUM_DIFFICULTIES] = {
     20.0f,  /* Easy */
@@ -268,11 +300,394 @@ static void track_init_default_spawns(Track *track) {
     }
 }
 
+/**
+ * Copy streamed checkpoint records into the track
+ */
+static void track_apply_checkpoints(Track *track, void *data, u32 size) {
+    TrackCheckpoint *src;
+    s32 count;
+
+    src = (TrackCheckpoint *)data;
+    count = (s32)(size / sizeof(TrackCheckpoint));
+    if (count <= 0) {
+        return;
+    }
+    if (count > MAX_CHECKPOINTS) {
+        count = MAX_CHECKPOINTS;
+    }
+
+    memcpy(track->checkpoints, src, (u32)count * sizeof(TrackCheckpoint));
+
+    track->num_checkpoints = count;
+    track->timing.finish_line = 0;
+    track->timing.before_finish = (s16)(count - 1);
+    track->timing.loop_checkpoint = 0;
+}
+
+/**
+ * Register streamed texture records with the texture cache
+ *
+ * Images stay in ROM; the cache pulls them in as the lap reaches the
+ * sections that draw them. The records also become the renderer's
+ * texture table, with no address so draws fetch them from the cache.
+ */
+static void track_apply_textures(TrackStream *st, void *data, u32 size) {
+    TrackTextureEntry *tex;
+    TextureInfo *ti;
+    s32 count;
+    s32 i;
+
+    tex = (TrackTextureEntry *)data;
+    count = (s32)(size / sizeof(TrackTextureEntry));
+    if (count > TRACK_MAX_TEXTURES) {
+        count = TRACK_MAX_TEXTURES;
+    }
+
+    for (i = 0; i < count; i++) {
+#ifdef NON_MATCHING
+        texcache_register(tex[i].id, st->dir_rom_addr + tex[i].rom_offset,
+                          tex[i].rom_size, tex[i].ram_size, tex[i].flags,
+                          tex[i].sections);
+#endif
+        ti = &sTrackTexInfo[i];
+        ti->address = 0;
+        ti->width = tex[i].width;
+        ti->height = tex[i].height;
+        ti->format = tex[i].format;
+        ti->size = tex[i].size;
+        ti->wrapS = tex[i].wrapS;
+        ti->wrapT = tex[i].wrapT;
+        sTrackTexIds[i] = tex[i].id;
+    }
+
+#ifdef NON_MATCHING
+    render_set_texture_table(sTrackTexInfo, sTrackTexIds, count);
+#endif
+}
+
+/**
+ * Place each track object and attach its geometry and texture
+ *
+ * Bounded objects end up in the renderer's cull hierarchy. Records are
+ * read in place from the targets section; their display
+ * lists live in the geometry section, so this runs once both are
+ * resident, whichever arrives last.
+ */
+static void track_apply_objects(TrackStream *st) {
+    TrackObjectEntry *obj;
+    u8 *geom;
+    u32 geomSize, off;
+    s32 count, i, lod;
+
+    obj = (TrackObjectEntry *)st->section_data[TRACK_SECTION_TARGETS];
+    count = (s32)(st->section_size[TRACK_SECTION_TARGETS] / sizeof(TrackObjectEntry));
+    geom = (u8 *)st->section_data[TRACK_SECTION_GEOMETRY];
+    geomSize = st->section_size[TRACK_SECTION_GEOMETRY];
+
+    for (i = 0; i < count; i++, obj++) {
+#ifdef NON_MATCHING
+        for (lod = 0; lod < TRACK_OBJECT_LODS; lod++) {
+            off = obj->dl_offset[lod];
+            render_set_object_dl(obj->objnum, lod,
+                                 (off == TRACK_OBJECT_NO_DL || off >= geomSize) ?
+                                 NULL : (Gfx *)(geom + off));
+        }
+        render_set_object_texture(obj->objnum, obj->texture);
+        render_place_object(obj->objnum, obj->pos, obj->yaw, obj->radius);
+        MBOX_SetObjectFlags(obj->objnum, obj->flags);
+        MBOX_SetObjectDef(obj->objnum, obj->defnum);
+#endif
+    }
+}
+
+/**
+ * Detach placed objects before their sections are freed
+ */
+static void track_release_objects(TrackStream *st) {
+    TrackObjectEntry *obj;
+    s32 count, i, lod;
+
+    if ((st->resident_mask & TRACK_OBJECT_SECTIONS) != TRACK_OBJECT_SECTIONS) {
+        return;
+    }
+
+    obj = (TrackObjectEntry *)st->section_data[TRACK_SECTION_TARGETS];
+    count = (s32)(st->section_size[TRACK_SECTION_TARGETS] / sizeof(TrackObjectEntry));
+
+    for (i = 0; i < count; i++, obj++) {
+#ifdef NON_MATCHING
+        for (lod = 0; lod < TRACK_OBJECT_LODS; lod++) {
+            render_set_object_dl(obj->objnum, lod, NULL);
+        }
+        render_set_object_texture(obj->objnum, -1);
+        MBOX_SetObjectDef(obj->objnum, -1);
+#endif
+    }
+}
+
+/**
+ * Hand a fully received section to its owner and mark it resident
+ */
+static void track_stream_finish_section(Track *track, TrackSectionEntry *ent) {
+    TrackStream *st;
+    void *data;
+    u32 size;
+
+    st = &gTracks.stream;
+    data = st->dest;
+    size = ent->rom_size;
+
+    /* Inflate from the staging buffer into the final allocation */
+    if (ent->flags & TRACK_SECTION_FLAG_COMPRESSED) {
+        data = malloc(ent->ram_size);
+        size = 0;
+        if (data != NULL) {
+            size = (u32)inflate_decompress(st->dest, data, 1);
+        }
+        free(st->dest);
+        st->dest = NULL;
+        if (size == 0 || size > ent->ram_size) {
+            /* Corrupt or truncated: stay non-resident, owners keep defaults */
+            if (data != NULL) {
+                free(data);
+            }
+            return;
+        }
+    }
+    st->dest = NULL;
+
+    st->section_data[ent->type] = data;
+    st->section_size[ent->type] = size;
+
+    switch (ent->type) {
+        case TRACK_SECTION_GEOMETRY:
+            track->geometry_data = data;
+            track->geometry_size = size;
+            road_load_segments(data, size);
+            break;
+        case TRACK_SECTION_CHECKPOINTS:
+            track_apply_checkpoints(track, data, size);
+            break;
+        case TRACK_SECTION_MAXPATHS:
+            maxpath_load_data(data, size);
+            break;
+        case TRACK_SECTION_BOOST_PADS:
+            boost_load_pads(data, size);
+            break;
+        case TRACK_SECTION_TEXTURES:
+            track_apply_textures(st, data, size);
+            break;
+        default:
+            /* Respawns and targets are read in place by their owners */
+            break;
+    }
+
+    st->resident_mask |= (u16)(1 << ent->type);
+
+    if (((1 << ent->type) & TRACK_OBJECT_SECTIONS) &&
+        (st->resident_mask & TRACK_OBJECT_SECTIONS) == TRACK_OBJECT_SECTIONS) {
+        track_apply_objects(st);
+    }
+}
+
+/**
+ * Blocking PI read through the section DMA queue (stream must be idle)
+ */
+static void track_rom_read(void *dest, u32 rom_addr, u32 size) {
+    OSMesg msg;
+
+    if (sTrackDmaQueue.msg == NULL) {
+        osCreateMesgQueue(&sTrackDmaQueue, sTrackDmaMsgBuf, 1);
+    }
+    osInvalDCache(dest, size);
+    osPiStartDma(&sTrackDmaMsg, OS_MESG_PRI_NORMAL, OS_READ,
+                 rom_addr, dest, size, &sTrackDmaQueue);
+    osRecvMesg(&sTrackDmaQueue, &msg, OS_MESG_BLOCK);
+}
+
+/**
+ * Read the track directory and queue its sections, critical ones first
+ *
+ * @return 1 if a valid directory was found, 0 to fall back to defaults
+ */
+static s32 track_stream_begin(u32 dir_rom_addr) {
+    TrackStream *st;
+    TrackSectionEntry *ent;
+    s32 i, n;
+
+    st = &gTracks.stream;
+    st->active = 0;
+    st->resident_mask = 0;
+    st->critical_mask = 0;
+    st->bytes_total = 0;
+    st->bytes_done = 0;
+    st->dma_requests = 0;
+
+    if (dir_rom_addr == 0) {
+        return 0;
+    }
+
+    track_rom_read(&st->dir, dir_rom_addr, sizeof(TrackDirectory));
+    if (st->dir.magic != TRACK_DIR_MAGIC || st->dir.version != TRACK_DIR_VERSION ||
+        st->dir.num_sections > NUM_TRACK_SECTIONS) {
+        return 0;
+    }
+
+    /* Critical sections stream first so the race can start early */
+    n = 0;
+    for (i = 0; i < st->dir.num_sections; i++) {
+        ent = &st->dir.sections[i];
+        if (ent->type >= NUM_TRACK_SECTIONS) {
+            return 0;
+        }
+        if (ent->flags & TRACK_SECTION_FLAG_CRITICAL) {
+            st->order[n++] = (s8)i;
+            st->critical_mask |= (u16)(1 << ent->type);
+        }
+        st->bytes_total += ent->rom_size;
+    }
+    for (i = 0; i < st->dir.num_sections; i++) {
+        if (!(st->dir.sections[i].flags & TRACK_SECTION_FLAG_CRITICAL)) {
+            st->order[n++] = (s8)i;
+        }
+    }
+
+    st->dir_rom_addr = dir_rom_addr;
+    st->cur = 0;
+    st->dest = NULL;
+    st->section_offset = 0;
+    st->dma_busy = 0;
+    st->active = 1;
+    st->start_count = osGetCount();
+    st->critical_count = 0;
+    st->total_count = 0;
+    return 1;
+}
+
+/**
+ * Advance section streaming
+ *
+ * Issues PI DMA requests in TRACK_DMA_CHUNK pieces and collects their
+ * completions without blocking. Each finished section is inflated and
+ * handed to its consumer as soon as it arrives.
+ *
+ * @param byte_budget ROM bytes to transfer this call (0 = no limit)
+ * @return 1 while sections remain outstanding, 0 when done
+ */
+s32 track_stream_update(u32 byte_budget) {
+    TrackStream *st;
+    TrackSectionEntry *ent;
+    OSMesg msg;
+    u32 moved;
+    u32 remain;
+
+    st = &gTracks.stream;
+    if (!st->active || gCurrentTrack == NULL) {
+        return 0;
+    }
+
+    moved = 0;
+    while (st->cur < st->dir.num_sections) {
+        ent = &st->dir.sections[st->order[st->cur]];
+
+        if (st->dma_busy) {
+            if (osRecvMesg(&sTrackDmaQueue, &msg, OS_MESG_NOBLOCK) == -1) {
+                break;
+            }
+            st->dma_busy = 0;
+            st->section_offset += st->chunk_size;
+            st->bytes_done += st->chunk_size;
+            moved += st->chunk_size;
+
+            if (st->section_offset >= ent->rom_size) {
+                track_stream_finish_section(gCurrentTrack, ent);
+                st->cur++;
+                st->section_offset = 0;
+                if ((st->resident_mask & st->critical_mask) == st->critical_mask &&
+                    st->critical_count == 0) {
+                    st->critical_count = osGetCount() - st->start_count;
+                }
+                continue;
+            }
+        }
+
+        if (byte_budget != 0 && moved >= byte_budget) {
+            break;
+        }
+
+        if (st->section_offset == 0) {
+            st->dest = (ent->rom_size != 0) ? (u8 *)malloc(ent->rom_size) : NULL;
+            if (st->dest == NULL) {
+                /* Leave the section non-resident; owners keep defaults */
+                st->bytes_done += ent->rom_size;
+                st->cur++;
+                continue;
+            }
+        }
+
+        remain = ent->rom_size - st->section_offset;
+        st->chunk_size = (remain > TRACK_DMA_CHUNK) ? TRACK_DMA_CHUNK : remain;
+        osInvalDCache(st->dest + st->section_offset, st->chunk_size);
+        osPiStartDma(&sTrackDmaMsg, OS_MESG_PRI_NORMAL, OS_READ,
+                     st->dir_rom_addr + ent->rom_offset + st->section_offset,
+                     st->dest + st->section_offset, st->chunk_size, &sTrackDmaQueue);
+        st->dma_busy = 1;
+        st->dma_requests++;
+    }
+
+    if (st->bytes_total != 0) {
+        remain = (u32)((u64)st->bytes_done * 100 / st->bytes_total);
+        gTracks.load_progress = (u8)((remain > 100) ? 100 : remain);
+    }
+
+    if (st->cur >= st->dir.num_sections) {
+        st->active = 0;
+        st->total_count = osGetCount() - st->start_count;
+        gTracks.load_progress = 100;
+        gTracks.loading = 0;
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Per-frame streaming pump, bounded so in-race frames stay on budget
+ */
+void track_stream_frame(void) {
+    track_stream_update(TRACK_STREAM_BUDGET);
+}
+
+/**
+ * ROM address of a track's section directory
+ *
+ * Looked up by track id in the directory index at TRACK_DIR_INDEX_ROM.
+ * An index without its magic, or with no entry for the track, means the
+ * image has no streamed data and the built-in layout is used.
+ *
+ * @return ROM address, or 0 if the track has no directory
+ */
+static u32 track_dir_rom_addr(s32 track_id) {
+    TrackDirIndex *index = &sTrackDirIndex;
+
+    track_rom_read(index, TRACK_DIR_INDEX_ROM, sizeof(TrackDirIndex));
+    if (index->magic != TRACK_DIR_INDEX_MAGIC || index->version != TRACK_DIR_VERSION ||
+        track_id >= index->num_tracks || track_id >= MAX_TRACKS) {
+        return 0;
+    }
+    return index->dir_rom_addr[track_id];
+}
+
 /**
  * Load a race track
+ *
+ * Streams the track directory from ROM and returns once the
+ * gameplay-critical sections are resident. Cosmetic sections keep
+ * streaming through track_stream_update() while the race runs.
  */
 s32 track_load(s32 track_id, u32 flags) {
     Track *track;
+    TrackStream *st;
 
     if (track_id < 0 || track_id >= MAX_TRACKS) {
         return 0;
@@ -289,12 +704,9 @@ s32 track_load(s32 track_id, u32 flags) {
     track->mirror = (flags & TRACK_FLAG_MIRROR) ? 1 : 0;
     track->reverse = (flags & TRACK_FLAG_REVERSE) ? 1 : 0;
 
-    /* Initialize defaults if ROM data not available */
+    /* Defaults cover any section missing from ROM */
     track_init_default_checkpoints(track);
-    gTracks.load_progress = 30;
-
     track_init_default_spawns(track);
-    gTracks.load_progress = 50;
 
     /* Set track bounds (placeholder) */
     track->bounds_min[0] = -1000.0f;
@@ -305,7 +717,6 @@ s32 track_load(s32 track_id, u32 flags) {
     track->bounds_max[2] = 1000.0f;
 
     track->track_length = 2000.0f;  /* Placeholder */
-    gTracks.load_progress = 80;
 
     /* Apply environment settings */
     if (flags & TRACK_FLAG_NIGHT) {
@@ -318,12 +729,22 @@ s32 track_load(s32 track_id, u32 flags) {
     }
 
     track->loaded = 1;
-    gTracks.load_progress = 100;
-    gTracks.loading = 0;
     gTracks.current_track = track_id;
     gTracks.current_type = TRACK_TYPE_RACE;
     gCurrentTrack = track;
 
+    /* Stream until everything the race needs is resident; a chunk per
+     * call, so cosmetic sections are left to the in-race pump */
+    st = &gTracks.stream;
+    if (track_stream_begin(track_dir_rom_addr(track_id))) {
+        while ((st->resident_mask & st->critical_mask) != st->critical_mask &&
+               track_stream_update(TRACK_DMA_CHUNK)) {
+        }
+    } else {
+        gTracks.load_progress = 100;
+        gTracks.loading = 0;
+    }
+
     return 1;
 }
 
@@ -387,15 +808,44 @@ s32 track_load_stunt(s32 arena_id) {
  * Unload current track
  */
 void track_unload(void) {
+    TrackStream *st;
+    OSMesg msg;
+    s32 i;
+
     if (gCurrentTrack == NULL) {
         return;
     }
 
-    /* Free loaded data */
-    if (gCurrentTrack->geometry_data != NULL) {
-        free(gCurrentTrack->geometry_data);
-        gCurrentTrack->geometry_data = NULL;
+    /* Drain any in-flight DMA before releasing its buffer */
+    st = &gTracks.stream;
+    if (st->dma_busy) {
+        osRecvMesg(&sTrackDmaQueue, &msg, OS_MESG_BLOCK);
+        st->dma_busy = 0;
     }
+    if (st->dest != NULL) {
+        free(st->dest);
+        st->dest = NULL;
+    }
+
+    /* Free streamed sections (geometry is owned by the stream) */
+    track_release_objects(st);
+    road_unload_track();
+    for (i = 0; i < NUM_TRACK_SECTIONS; i++) {
+        if (st->section_data[i] != NULL) {
+            free(st->section_data[i]);
+            st->section_data[i] = NULL;
+            st->section_size[i] = 0;
+        }
+    }
+    st->resident_mask = 0;
+    st->active = 0;
+    gCurrentTrack->geometry_data = NULL;
+#ifdef NON_MATCHING
+    /* Texture ids are per track */
+    render_set_texture_table(NULL, NULL, 0);
+    texcache_flush();
+#endif
+    gTracks.loading = 0;
 
     if (gCurrentTrack->collision_data != NULL) {
         free(gCurrentTrack->collision_data);
@@ -421,6 +871,44 @@ s32 track_get_load_progress(void) {
     return gTracks.load_progress;
 }
 
+/**
+ * Check whether a streamed section is resident
+ */
+s32 track_section_is_resident(s32 section) {
+    if (section < 0 || section >= NUM_TRACK_SECTIONS) {
+        return 0;
+    }
+    return (gTracks.stream.resident_mask >> section) & 1;
+}
+
+/**
+ * Get a resident section's data
+ *
+ * @param section TRACK_SECTION_* type
+ * @param size Output: section size in bytes (may be NULL)
+ * @return Section data, or NULL if not resident
+ */
+void* track_get_section_data(s32 section, u32 *size) {
+    if (!track_section_is_resident(section)) {
+        if (size != NULL) {
+            *size = 0;
+        }
+        return NULL;
+    }
+    if (size != NULL) {
+        *size = gTracks.stream.section_size[section];
+    }
+    return gTracks.stream.section_data[section];
+}
+
+/**
+ * Get byte-level loading progress
+ */
+void track_get_load_bytes(u32 *done, u32 *total) {
+    *done = gTracks.stream.bytes_done;
+    *total = gTracks.stream.bytes_total;
+}
+
 /* -------------------------------------------------------------------------- */
 /* Track Info Access                                                           */
 /* -------------------------------------------------------------------------- */
@@ -822,3 +1310,63 @@ s32 track_get_segment_at(f32 *pos) {
     /* Would return which track segment the position is in */
     return 0;
 }
+
+#ifdef HOST_BUILD
+static u32 track_bench_ns(struct timespec *t0, struct timespec *t1) {
+    return (u32)((s64)(t1->tv_sec - t0->tv_sec) * 1000000000LL + (t1->tv_nsec - t0->tv_nsec));
+}
+
+/**
+ * track_load_bench - Time the streamed loader against a ROM image (host)
+ *
+ * Loads the image through the host PI backend, then loads every race
+ * track its directory index lists. Each load is timed until track_load
+ * returns (critical sections resident), then pumped a frame budget at a
+ * time until the cosmetic sections finish too. Directory structures are
+ * read as stored, so the image must be built in host byte order.
+ *
+ * @param rom_path Cartridge image
+ * @param out Results, one per track loaded
+ * @return Tracks loaded, or -1 if the image could not be read
+ */
+s32 track_load_bench(const char *rom_path, TrackLoadBenchStats out[MAX_TRACKS]) {
+    struct timespec t0, t1;
+    TrackStream *st;
+    TrackLoadBenchStats *b;
+    s32 id, n;
+
+    if (__osHostRomOpen(rom_path) == 0) {
+        return -1;
+    }
+
+    st = &gTracks.stream;
+    n = 0;
+    for (id = 0; id < MAX_TRACKS; id++) {
+        if (track_dir_rom_addr(id) == 0) {
+            continue;
+        }
+        b = &out[n++];
+        b->track_id = id;
+        b->frames = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        track_load(id, 0);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        b->critical_ns = track_bench_ns(&t0, &t1);
+
+        while (st->active) {
+            track_stream_frame();
+            b->frames++;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        b->total_ns = track_bench_ns(&t0, &t1);
+
+        b->bytes = st->bytes_total;
+        b->dma_requests = st->dma_requests;
+    }
+
+    track_unload();
+    __osHostRomClose();
+    return n;
+}
+#endif
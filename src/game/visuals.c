@@ -11,6 +11,7 @@
 #include "types.h"
 #include "game/visuals.h"
 #include "game/game.h"
+#include "game/camera.h"
 
 /* ======================= EXTERNAL DECLARATIONS ======================== */
 
@@ -39,6 +40,19 @@ extern s32 abs(s32 x);
 /* Camera position */
 extern f32 gCamPos[3];
 
+/* Local players (one camera each in split screen) */
+extern s32 mp_get_num_players(void);
+
+/* Car positions (world) */
+extern f32 gCarPositions[8][3];
+
+/* Car appearance bits (car.c) */
+extern u32 car_get_appearance(s32 slot);
+
+/* Appearance bits (effects.h; its VisualTypes clashes with this file's) */
+#define APP_TRANSLUCENT     0x00000008
+#define APP_HULK            0x00000010
+
 /* ======================= GLOBAL VARIABLES ======================== */
 
 /* Smoke/skid intensity arrays */
@@ -90,9 +104,32 @@ static Skid *gSkidList;                  /* Points to list of previously created
 
 /* Environmental visual effects list */
 static Visual gEnvirons[MAX_VISUALS];    /* Environmental visual effects list */
-static Visual *gEnvList;                 /* List of used fx slots */
 static Visual *gFreeVis;                 /* List of free fx slots */
 
+/*
+ * Active environmental visuals, bucketed by controller function. Each
+ * bucket is a dense array of the visuals using that function, so
+ * UpdateEnvirons runs one type at a time over contiguous entries and a
+ * release swaps the last entry into the hole instead of searching a list.
+ * Bucket 0 takes visuals whose function arrives after ENV_MAX_TYPES
+ * buckets are in use.
+ */
+typedef struct EnvBucket {
+    VisFunc         func;
+    EnvBatchFunc    batch;              /* Optional: whole bucket in one call */
+    s16             every;              /* Far visuals update every Nth frame */
+    s16             count;
+    Visual          *vis[MAX_VISUALS];
+} EnvBucket;
+
+static EnvBucket gEnvBuckets[ENV_MAX_TYPES];
+static s32 gEnvNumBuckets;
+static s8 gEnvBucketOf[MAX_VISUALS];     /* Bucket per gEnvirons entry, -1 if free */
+static s16 gEnvPosOf[MAX_VISUALS];       /* Index within that bucket */
+static u32 gEnvDone[MAX_VISUALS];        /* gEnvFrame of last update */
+static u32 gEnvFrame;
+static EnvTypeStats gEnvStats[ENV_MAX_TYPES];
+
 /* Dynamic texture maps */
 static s32 gTexList[NUM_DYN_TEXS];
 
@@ -102,12 +139,30 @@ static CarParts gCarParts[NCARS];
 /* Frame rate check */
 static s32 gGoodFrameRate;               /* TRUE if instantaneous frame rate is OK */
 
+/*
+ * Body quads are rebuilt only when the inputs packed into Visual.state
+ * change: damage level, translucency and the car's body generation.
+ * Unchanged quads keep the build they already have.
+ */
+#define QUAD_STATE_DAMAGE   0x03
+#define QUAD_STATE_XLU      0x04
+#define QUAD_STATE_GEN_SHIFT 8
+
+static u16 gCarBodyGen[MAX_LINKS];      /* Bumped when a car's body changes */
+static QuadStats gQuadStats;             /* Frame in progress */
+static QuadStats gQuadLast;              /* Last completed frame */
+
 /* ======================= STATIC FUNCTION PROTOTYPES ======================== */
 
 static void HandleASpark(Visual *v, s32 on, f32 x, f32 y, f32 z, s32 name, s16 op);
 static s32 PlaceAnObj(s32 objnum, f32 v[3]);
 static s32 PlaceChildObj(s32 objnum, f32 dx, f32 dy, f32 dz, f32 *orient, s32 parent);
 static void StartSmoke(s16 slot, u32 tire, s32 fast);
+static void AnimateSmokeBatch(Visual **vis, s32 count);
+static s32 StepSmoke(Visual *v);
+static Visual *StartEnvVisual(VisFunc func, s16 slot, u32 data);
+static void StartSkidTrail(s16 slot);
+static void InitEnvTypes(void);
 static void StartBrakeLights(s16 slot);
 static void StartTire(s16 slot, u32 tire);
 static void StartShadow(s16 slot);
@@ -176,12 +231,26 @@ void InitVisuals(s32 for_game) {
 
     gEnvirons[i].next = NULL;
     gEnvirons[i].objnum = -1;
-    gEnvList = NULL;
+
+    for (i = 0; i < MAX_VISUALS; i++) {
+        gEnvBucketOf[i] = -1;
+        gEnvDone[i] = 0;
+    }
+    memset((void *)gEnvBuckets, 0, sizeof(gEnvBuckets));
+    memset((void *)gEnvStats, 0, sizeof(gEnvStats));
+    gEnvNumBuckets = 1;
+    gEnvBuckets[0].every = 1;
+    gEnvFrame = 0;
+    InitEnvTypes();
     InitSkids();
 
     memset((void *)gCarParts, 0, sizeof(gCarParts));
     memset((void *)gTexList, 0, sizeof(gTexList));
 
+    memset((void *)gCarBodyGen, 0, sizeof(gCarBodyGen));
+    memset((void *)&gQuadStats, 0, sizeof(gQuadStats));
+    memset((void *)&gQuadLast, 0, sizeof(gQuadLast));
+
     /* Would pre-locate dynamic texture maps */
 
     spring_save = 0.0f;
@@ -231,6 +300,11 @@ void SetupCar(s16 slot, s16 type, s32 for_game) {
     }
 
     /* Would configure car body and parts based on type and damage */
+
+    /* Body may have changed: rebuild quads on their next update */
+    if (slot < MAX_LINKS) {
+        gCarBodyGen[slot]++;
+    }
 }
 
 /**
@@ -244,6 +318,7 @@ void StartCar(s16 slot) {
 
     StartFrame(slot);
     StartSparks(slot);
+    StartSkidTrail(slot);
     StartBrakeLights(slot);
 
     for (j = 0; j < 4; j++) {
@@ -330,14 +405,197 @@ Visual *GrabEnvEntry(void) {
     return v;
 }
 
+/**
+ * FindEnvBucket - Bucket for a controller function, creating it if needed
+ */
+static s32 FindEnvBucket(VisFunc func) {
+    s32 b;
+
+    for (b = 1; b < gEnvNumBuckets; b++) {
+        if (gEnvBuckets[b].func == func) {
+            return b;
+        }
+    }
+
+    if (func == NULL || gEnvNumBuckets >= ENV_MAX_TYPES) {
+        return 0;
+    }
+
+    b = gEnvNumBuckets++;
+    gEnvBuckets[b].func = func;
+    gEnvBuckets[b].batch = NULL;
+    gEnvBuckets[b].every = 1;
+    gEnvBuckets[b].count = 0;
+    return b;
+}
+
+/**
+ * SetEnvType - Configure how visuals with a controller are updated
+ * @param func Controller function the visuals are started with
+ * @param batch Called once per frame with the due visuals instead of
+ *              func(v, 1) for each, or NULL
+ * @param every Visuals further than ENV_FAR_DIST from the camera update
+ *              only every Nth frame (1 = every frame). Controllers must
+ *              time their animation from IRQTIME to use this.
+ */
+void SetEnvType(VisFunc func, EnvBatchFunc batch, s32 every) {
+    s32 b = FindEnvBucket(func);
+
+    if (b == 0) {
+        return;
+    }
+    gEnvBuckets[b].batch = batch;
+    gEnvBuckets[b].every = (s16)((every < 1) ? 1 : every);
+}
+
+/**
+ * InitEnvTypes - Register the environment controllers
+ *
+ * Gives each controller its bucket up front, so the types keep the same
+ * stats index from race to race whichever one starts first.
+ */
+static void InitEnvTypes(void) {
+    SetEnvType(AnimateSmoke, AnimateSmokeBatch, ENV_SMOKE_EVERY);
+    SetEnvType(AnimateSkidTrail, NULL, ENV_SKID_EVERY);
+    SetEnvType(AnimateLSpark, NULL, ENV_SPARK_EVERY);
+    SetEnvType(AnimateRSpark, NULL, ENV_SPARK_EVERY);
+    SetEnvType(AnimateBSpark, NULL, ENV_SPARK_EVERY);
+}
+
+/**
+ * StartEnvVisual - Grab an environment entry and start a controller on it
+ * @return The visual, or NULL if none are free
+ */
+static Visual *StartEnvVisual(VisFunc func, s16 slot, u32 data) {
+    Visual *v = GrabEnvEntry();
+
+    if (v == NULL) {
+        return NULL;
+    }
+    v->func = func;
+    v->slot = slot;
+    v->data = data;
+    v->timeStamp = IRQTIME;
+    AddToEnvList(v);
+    return v;
+}
+
 /**
  * AddToEnvList - Add a visual to the environment list
  *
  * From arcade visuals.c:916-925
+ * Set v->func first; it picks the bucket.
  */
 void AddToEnvList(Visual *v) {
-    v->next = gEnvList;
-    gEnvList = v;
+    EnvBucket *bk;
+    s32 idx, b;
+
+    idx = v - gEnvirons;
+    if (idx < 0 || idx >= MAX_VISUALS || gEnvBucketOf[idx] >= 0) {
+        return;
+    }
+
+    b = FindEnvBucket(v->func);
+    bk = &gEnvBuckets[b];
+
+    v->next = NULL;
+    gEnvBucketOf[idx] = (s8)b;
+    gEnvPosOf[idx] = bk->count;
+    gEnvDone[idx] = gEnvFrame;      /* First update is next frame */
+    bk->vis[bk->count++] = v;
+}
+
+/**
+ * EnvIsFar - Visual's owner car is beyond ENV_FAR_DIST from every camera
+ *
+ * Measured against each local player's camera rather than gCamPos,
+ * which only holds whichever viewport was drawn last.
+ */
+static s32 EnvIsFar(Visual *v) {
+    CameraData *cam;
+    f32 d, dist;
+    s32 i, vw, numViews;
+
+    if (v->slot >= MAX_LINKS || (s32)v->slot == this_node) {
+        return 0;
+    }
+
+    numViews = mp_get_num_players();
+    if (numViews < 1) {
+        numViews = 1;
+    }
+
+    for (vw = 0; vw < numViews; vw++) {
+        cam = camera_get_view(vw);
+        if (cam == NULL) {
+            continue;
+        }
+        if (cam->target_car == (s32)v->slot) {
+            return 0;
+        }
+
+        dist = 0.0f;
+        for (i = 0; i < 3; i++) {
+            d = gCarPositions[v->slot][i] - cam->pos[i];
+            dist += d * d;
+        }
+        if (dist <= ENV_FAR_DIST * ENV_FAR_DIST) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * UpdateEnvBucket - Run one bucket's due visuals
+ *
+ * Walks from the end so a visual releasing itself (swap-remove) only
+ * moves an already-updated entry into its place; gEnvDone stops anything
+ * a controller shuffles from being updated twice.
+ */
+static void UpdateEnvBucket(s32 b) {
+    EnvBucket *bk = &gEnvBuckets[b];
+    EnvTypeStats *st = &gEnvStats[b];
+    Visual *due[MAX_VISUALS];
+    Visual *v;
+    s32 i, idx, n;
+
+    st->func = bk->func;
+    st->active = bk->count;
+    st->updated = 0;
+    st->throttled = 0;
+
+    n = 0;
+    for (i = bk->count - 1; i >= 0; i--) {
+        if (i >= bk->count) {
+            continue;
+        }
+        v = bk->vis[i];
+        idx = v - gEnvirons;
+        if (gEnvDone[idx] == gEnvFrame) {
+            continue;
+        }
+
+        /* Stagger far visuals so each frame takes a share */
+        if (bk->every > 1 && (u32)(idx + gEnvFrame) % (u32)bk->every != 0 &&
+            EnvIsFar(v)) {
+            st->throttled++;
+            continue;
+        }
+
+        gEnvDone[idx] = gEnvFrame;
+        st->updated++;
+
+        if (bk->batch != NULL) {
+            due[n++] = v;
+        } else if (v->func) {
+            v->func(v, 1);
+        }
+    }
+
+    if (n > 0) {
+        bk->batch(due, n);
+    }
 }
 
 /**
@@ -346,18 +604,19 @@ void AddToEnvList(Visual *v) {
  * From arcade visuals.c:931-951
  */
 void UpdateEnvirons(void) {
-    Visual *v, *next;
+    s32 b;
+    u32 frames;
 
-    v = gEnvList;
-    next = (gEnvList) ? gEnvList->next : NULL;
+    gEnvFrame++;
 
-    while (v) {
-        if (v->func) {
-            v->func(v, 1);
-        }
-        if ((v = next) != NULL) {
-            next = v->next;
-        }
+    /* Publish last frame's quad counters */
+    frames = gQuadLast.frames + 1;
+    gQuadLast = gQuadStats;
+    gQuadLast.frames = frames;
+    memset((void *)&gQuadStats, 0, sizeof(gQuadStats));
+
+    for (b = 0; b < gEnvNumBuckets; b++) {
+        UpdateEnvBucket(b);
     }
 
     AnimateSkids();
@@ -368,28 +627,31 @@ void UpdateEnvirons(void) {
  * ReleaseEnviron - Free an environmental entry
  *
  * From arcade visuals.c:957-989
+ * The bucket entry is always dropped (O(1) swap with the last), so
+ * unlink no longer needs the caller to have walked the list.
  */
 void ReleaseEnviron(Visual *v, s32 unlink) {
-    Visual *p;
+    EnvBucket *bk;
+    Visual *last;
+    s32 idx, pos;
 
     v->func = NULL;
     v->index = 0;
     v->objnum = -1;
 
-    /* Remove from the used environment list */
-    if (unlink) {
-        if (v == gEnvList) {
-            gEnvList = gEnvList->next;
-        } else {
-            /* Find the previous link */
-            for (p = gEnvList; p && p->next != v; p = p->next)
-                ;
+    idx = v - gEnvirons;
+    if (idx < 0 || idx >= MAX_VISUALS) {
+        return;
+    }
 
-            /* Remove from the list */
-            if (p && p->next == v) {
-                p->next = v->next;
-            }
-        }
+    /* Remove from the used environment bucket */
+    if (gEnvBucketOf[idx] >= 0) {
+        bk = &gEnvBuckets[gEnvBucketOf[idx]];
+        pos = gEnvPosOf[idx];
+        last = bk->vis[--bk->count];
+        bk->vis[pos] = last;
+        gEnvPosOf[last - gEnvirons] = (s16)pos;
+        gEnvBucketOf[idx] = -1;
     }
 
     /* Put back on the free list */
@@ -403,13 +665,34 @@ void ReleaseEnviron(Visual *v, s32 unlink) {
  * From arcade visuals.c:995-1001
  */
 void RemoveEnvirons(void) {
-    while (gEnvList) {
-        ReleaseEnviron(gEnvList, 1);
+    s32 b;
+
+    for (b = 0; b < gEnvNumBuckets; b++) {
+        while (gEnvBuckets[b].count > 0) {
+            ReleaseEnviron(gEnvBuckets[b].vis[gEnvBuckets[b].count - 1], 1);
+        }
     }
 
     InitSkids();
 }
 
+/**
+ * GetEnvStats - Per-type update counts for the last UpdateEnvirons
+ * @param numTypes Output: entries in the returned array
+ * @return Stats indexed by bucket (0 = overflow bucket)
+ */
+EnvTypeStats *GetEnvStats(s32 *numTypes) {
+    *numTypes = gEnvNumBuckets;
+    return gEnvStats;
+}
+
+/**
+ * GetQuadStats - Body quad rebuild counters for the last frame
+ */
+QuadStats *GetQuadStats(void) {
+    return &gQuadLast;
+}
+
 /**
  * UpdateVisuals - Update visual effects for a single car
  *
@@ -431,9 +714,36 @@ void UpdateVisuals(s16 slot) {
  * (static function)
  */
 static void RemoveVisuals(s16 slot) {
-    s16 i;
+    Visual *v;
+    s32 b, i;
+    s16 j;
 
     /* Would call cleanup on all car visuals */
+
+    /* Stop this car's environment controllers */
+    for (b = 0; b < gEnvNumBuckets; b++) {
+        for (i = gEnvBuckets[b].count - 1; i >= 0; i--) {
+            if (i >= gEnvBuckets[b].count) {
+                continue;
+            }
+            v = gEnvBuckets[b].vis[i];
+            if ((s16)v->slot != slot) {
+                continue;
+            }
+            if (v->func) {
+                v->func(v, 0);
+            }
+            if (gEnvBucketOf[v - gEnvirons] >= 0) {
+                ReleaseEnviron(v, 1);
+            }
+        }
+    }
+
+    for (j = 0; j < 4; j++) {
+        if (gNewSkid[slot][j].skid != NULL) {
+            StopSkid(&gNewSkid[slot][j]);
+        }
+    }
 }
 
 /**
@@ -450,11 +760,15 @@ static void StartQuad(s16 slot, s16 quad) {
  * AnimateQuad - Makes car body quad animate
  *
  * From arcade visuals.c:1111-1158
+ * The quad is only rebuilt when its damage, translucency or the car's
+ * body changed since the last build. A hidden quad keeps the change
+ * pending until it is shown again.
  */
 void AnimateQuad(Visual *v, s16 op) {
     s16 slot;
     s16 quad;
     s32 damage;
+    u32 appear, state;
 
     if (gstate == TRKSEL || gstate == CARSEL) {
         return;
@@ -470,7 +784,40 @@ void AnimateQuad(Visual *v, s16 op) {
         return;
     }
 
-    /* Would update quad visibility and translucency */
+    if (slot < 0 || slot >= MAX_LINKS || quad >= NUM_QUADS) {
+        return;
+    }
+    gQuadStats.updates++;
+
+    /* Hulks draw the hulk body instead of quads; a change waits until shown */
+    appear = car_get_appearance(slot);
+    if (!CheckVisible(v, !(appear & APP_HULK))) {
+        gQuadStats.deferred++;
+        return;
+    }
+    CheckXlu(v, (appear & APP_TRANSLUCENT) != 0, QUAD_XLU_ALPHA);
+
+    damage = (appear & gDamageMask[quad]) >> gDamageShift[quad];
+    state = (u32)damage | ((appear & APP_TRANSLUCENT) ? QUAD_STATE_XLU : 0) |
+            ((u32)gCarBodyGen[slot] << QUAD_STATE_GEN_SHIFT);
+    if (state != v->state || v->gen == 0) {
+        v->state = state;
+        v->dirty = 1;
+    }
+
+    if (!v->dirty) {
+        gQuadStats.reused++;
+        return;
+    }
+
+    /* Would rebuild the quad for its damage level and translucency */
+    v->gen++;
+    if (v->gen == 0) {
+        v->gen = 1;
+    }
+    v->dirty = 0;
+    gQuadStats.rewrites++;
+    gQuadStats.vtx_bytes += QUAD_VTX_BYTES;
 }
 
 /**
@@ -607,7 +954,36 @@ void Transpose3x3(f32 mat[3][3]) {
 static void StartSmoke(s16 slot, u32 tire, s32 fast) {
     Visual *v;
 
-    /* Would grab visual entry and set up smoke animation */
+    v = StartEnvVisual(AnimateSmoke, slot, (tire & 0x0f) | (fast ? 0x100 : 0));
+    if (v == NULL) {
+        return;
+    }
+    v->index = 0;
+
+    /* Would place the smoke object at the tire contact */
+}
+
+/**
+ * StepSmoke - Advance one puff to its frame for IRQTIME
+ * @return FALSE once the sequence has finished and the puff is released
+ */
+static s32 StepSmoke(Visual *v) {
+    s32 frame;
+
+    frame = (s32)((IRQTIME - v->timeStamp) / SMOKE_HOLD);
+    if (v->data & 0x100) {
+        frame <<= 1;                /* Fast smoke runs at double rate */
+    }
+    if (frame >= SMOKE_FRAMES) {
+        ReleaseEnviron(v, 1);
+        return 0;
+    }
+
+    if (frame != v->index) {
+        v->index = frame;
+        /* Would set the smoke object's frame and fade */
+    }
+    return 1;
 }
 
 /**
@@ -616,16 +992,72 @@ static void StartSmoke(s16 slot, u32 tire, s32 fast) {
  * From arcade visuals.c:1501-1569
  */
 void AnimateSmoke(Visual *v, s16 op) {
-    s16 slot;
+    /* Handle cleanup call */
+    if (op == 0) {
+        ReleaseEnviron(v, 1);
+        return;
+    }
+
+    StepSmoke(v);
+}
+
+/**
+ * AnimateSmokeBatch - Advance every due smoke puff
+ *
+ * Frames come from IRQTIME, so puffs skipped while far catch up to the
+ * right frame on their next update.
+ */
+static void AnimateSmokeBatch(Visual **vis, s32 count) {
+    s32 i;
+
+    for (i = 0; i < count; i++) {
+        StepSmoke(vis[i]);
+    }
+
+    /* Would rise and spread the remaining puffs by gGameExecTime */
+}
+
+/**
+ * StartSkidTrail - Start the controller that lays a car's skids and smoke
+ */
+static void StartSkidTrail(s16 slot) {
+    if (slot < 0 || slot >= MAX_LINKS) {
+        return;
+    }
+    StartEnvVisual(AnimateSkidTrail, slot, 0);
+}
+
+/**
+ * AnimateSkidTrail - Lay skids and puff smoke from a car's tires
+ *
+ * Driven by skid_intensity/smoke_intensity. A far car's skids extend
+ * every ENV_SKID_EVERY frames, which only makes its segments longer.
+ */
+void AnimateSkidTrail(Visual *v, s16 op) {
+    s16 slot = (s16)v->slot;
+    u32 tire;
+    s32 puff;
 
     /* Handle cleanup call */
     if (op == 0) {
+        for (tire = 0; tire < 4; tire++) {
+            DoSkid(slot, tire, 0);
+        }
         ReleaseEnviron(v, 1);
         return;
     }
 
-    /* Would update smoke position and opacity */
-    /* Would advance smoke animation frame */
+    puff = (IRQTIME - v->timeStamp) >= SMOKE_INTERVAL;
+    for (tire = 0; tire < 4; tire++) {
+        DoSkid(slot, tire, skid_intensity[slot][tire][0] > 0);
+
+        if (puff && smoke_intensity[slot][tire][0] > 0) {
+            StartSmoke(slot, tire, smoke_intensity[slot][tire][1] > 0);
+        }
+    }
+    if (puff) {
+        v->timeStamp = IRQTIME;
+    }
 }
 
 /**
@@ -973,7 +1405,9 @@ void StartSparks(s16 slot) {
         return;
     }
 
-    /* Would initialize left, right, and bottom spark visuals */
+    StartEnvVisual(AnimateLSpark, slot, 0);
+    StartEnvVisual(AnimateRSpark, slot, 0);
+    StartEnvVisual(AnimateBSpark, slot, 0);
 }
 
 /**
@@ -356,32 +356,13 @@ void weapon_update_cooldown(s32 player) {
  * @return Target player index or -1
  */
 s32 weapon_find_target(s32 player, f32 max_range) {
-    s32 i;
-    s32 best_target = -1;
-    f32 best_dist = max_range;
-    f32 my_x, my_z;
-
     if (player < 0 || player >= WEAPON_MAX_PLAYERS) {
         return -1;
     }
 
-    my_x = car_array[player].dr_pos[0];
-    my_z = car_array[player].dr_pos[2];
-
-    for (i = 0; i < WEAPON_MAX_PLAYERS; i++) {
-        if (i != player && gBattle.players[i].alive) {
-            f32 dx = car_array[i].dr_pos[0] - my_x;
-            f32 dz = car_array[i].dr_pos[2] - my_z;
-            f32 dist = sqrtf(dx*dx + dz*dz);
-
-            if (dist < best_dist) {
-                best_dist = dist;
-                best_target = i;
-            }
-        }
-    }
-
-    return best_target;
+    /* Nearest live opponent from the battle spatial hash */
+    return battle_grid_nearest(car_array[player].dr_pos, max_range,
+                               BATTLE_ENT_PLAYER, player, NULL);
 }
 
 /**
@@ -64,6 +64,15 @@ static const f32 sRainSpawnRates[5] = {
     15.0f   /* Storm */
 };
 
+/* Share of the drop pool used per intensity, in 1/16ths */
+static const u8 sRainDensity[5] = {
+    0,      /* None */
+    4,      /* Light */
+    8,      /* Medium */
+    12,     /* Heavy */
+    16      /* Storm */
+};
+
 /* Fog distances per weather type */
 static const f32 sFogNear[NUM_WEATHER_TYPES] = {
     5000.0f,    /* Clear */
@@ -144,6 +153,9 @@ void weather_init(void) {
     gWeather.day_cycle_time = 0.5f;  /* Noon */
     gWeather.day_cycle_speed = 0.0f;
     gWeather.day_cycle_enabled = 0;
+
+    /* Single full-screen view until split screen says otherwise */
+    weather_set_views(1);
 }
 
 /**
@@ -169,49 +181,75 @@ void weather_update(void) {
     weather_update_wetness();
 }
 
+/**
+ * Wrap a coordinate into [lo, lo + size)
+ *
+ * Snaps in one step however far outside the box the point is, so a
+ * volume that jumps (camera cut, respawn) is refilled the same frame.
+ */
+static f32 weather_wrap(f32 p, f32 lo, f32 size) {
+    f32 d = p - lo;
+
+    if (d >= 0.0f && d < size) {
+        return p;
+    }
+    p -= (f32)(s32)(d / size) * size;
+    if (p < lo) {
+        p += size;
+    } else if (p >= lo + size) {
+        p -= size;
+    }
+    return p;
+}
+
 /**
  * Update rain particles
+ *
+ * Drops live in a fixed box around each viewport's camera. A drop that
+ * leaves its box through any face re-enters through the opposite face,
+ * so once the volumes are filled rain costs no spawning at all and the
+ * drop count stays fixed regardless of player count.
  */
 void weather_update_rain(void) {
-    s32 i;
+    s32 v, i, end;
     RainDrop *drop;
-    f32 ground_y = 0.0f;  /* Would come from collision */
+    WeatherVolume *vol;
+    f32 wind_x, wind_z;
 
-    /* Spawn new drops */
-    if (gWeather.rain_intensity > RAIN_NONE) {
-        gWeather.rain_spawn_accum += gWeather.rain_spawn_rate;
-        while (gWeather.rain_spawn_accum >= 1.0f) {
-            weather_spawn_rain(1);
-            gWeather.rain_spawn_accum -= 1.0f;
-        }
+    gWeather.rain_count = 0;
+    gWeather.rain_wraps = 0;
+    if (gWeather.rain_intensity == RAIN_NONE) {
+        return;
     }
 
-    /* Update existing drops */
-    gWeather.rain_count = 0;
-    for (i = 0; i < MAX_RAIN_DROPS; i++) {
-        drop = &gWeather.rain[i];
-        if (!drop->active) {
-            continue;
-        }
+    wind_x = gWeather.wind.direction[0] * gWeather.wind.speed * 0.1f;
+    wind_z = gWeather.wind.direction[2] * gWeather.wind.speed * 0.1f;
+
+    for (v = 0; v < gWeather.num_views; v++) {
+        vol = &gWeather.volumes[v];
+        end = vol->first + vol->count;
 
-        /* Apply velocity */
-        drop->pos[0] += drop->vel[0];
-        drop->pos[1] += drop->vel[1];
-        drop->pos[2] += drop->vel[2];
+        for (i = vol->first; i < end; i++) {
+            drop = &gWeather.rain[i];
 
-        /* Apply wind */
-        drop->pos[0] += gWeather.wind.direction[0] * gWeather.wind.speed * 0.1f;
-        drop->pos[2] += gWeather.wind.direction[2] * gWeather.wind.speed * 0.1f;
+            drop->pos[0] += drop->vel[0] + wind_x;
+            drop->pos[1] += drop->vel[1];
+            drop->pos[2] += drop->vel[2] + wind_z;
 
-        /* Check if hit ground */
-        if (drop->pos[1] < ground_y) {
-            if (drop->splash) {
-                weather_spawn_splash(drop->pos, 0.5f);
+            /* Wrap through the opposite face */
+            if (drop->pos[1] < vol->min[1]) {
+                if (drop->splash) {
+                    weather_spawn_splash(drop->pos, 0.5f);
+                }
+                gWeather.rain_wraps++;
             }
-            drop->active = 0;
-        } else {
-            gWeather.rain_count++;
+            drop->pos[0] = weather_wrap(drop->pos[0], vol->min[0], WEATHER_VOLUME_SIZE);
+            drop->pos[1] = weather_wrap(drop->pos[1], vol->min[1],
+                                        WEATHER_VOLUME_ABOVE + WEATHER_VOLUME_BELOW);
+            drop->pos[2] = weather_wrap(drop->pos[2], vol->min[2], WEATHER_VOLUME_SIZE);
         }
+
+        gWeather.rain_count += vol->count;
     }
 }
 
@@ -491,6 +529,89 @@ void weather_set_rain(s32 intensity) {
 
     gWeather.rain_intensity = (u8)intensity;
     gWeather.rain_spawn_rate = sRainSpawnRates[intensity];
+    weather_fill_volumes();
+}
+
+/**
+ * Split the drop pool between viewports
+ *
+ * Each view gets an equal slice, so the total drop count never exceeds
+ * MAX_RAIN_DROPS however many players are on screen.
+ */
+void weather_set_views(s32 num_views) {
+    s32 i;
+
+    if (num_views < 1) {
+        num_views = 1;
+    } else if (num_views > WEATHER_MAX_VIEWS) {
+        num_views = WEATHER_MAX_VIEWS;
+    }
+
+    gWeather.num_views = num_views;
+    for (i = 0; i < num_views; i++) {
+        gWeather.volumes[i].min[0] = -WEATHER_VOLUME_SIZE * 0.5f;
+        gWeather.volumes[i].min[1] = -WEATHER_VOLUME_BELOW;
+        gWeather.volumes[i].min[2] = -WEATHER_VOLUME_SIZE * 0.5f;
+    }
+
+    weather_fill_volumes();
+}
+
+/**
+ * Anchor a view's rain volume to its camera
+ *
+ * Only the box moves; drops keep their world positions and wrap into
+ * the new box on the next update.
+ */
+void weather_set_view_camera(s32 view, f32 *pos) {
+    WeatherVolume *vol;
+
+    if (view < 0 || view >= gWeather.num_views) {
+        return;
+    }
+
+    vol = &gWeather.volumes[view];
+    vol->min[0] = pos[0] - WEATHER_VOLUME_SIZE * 0.5f;
+    vol->min[1] = pos[1] - WEATHER_VOLUME_BELOW;
+    vol->min[2] = pos[2] - WEATHER_VOLUME_SIZE * 0.5f;
+}
+
+/**
+ * Distribute drops through every view's volume
+ *
+ * Called only when intensity or the view count changes.
+ */
+void weather_fill_volumes(void) {
+    s32 v, i, per_view, total;
+    RainDrop *drop;
+    WeatherVolume *vol;
+
+    weather_clear_rain();
+
+    total = (MAX_RAIN_DROPS * sRainDensity[gWeather.rain_intensity]) >> 4;
+    per_view = total / gWeather.num_views;
+
+    for (v = 0; v < gWeather.num_views; v++) {
+        vol = &gWeather.volumes[v];
+        vol->first = (s16)(v * per_view);
+        vol->count = (s16)per_view;
+
+        for (i = vol->first; i < vol->first + vol->count; i++) {
+            drop = &gWeather.rain[i];
+            drop->active = 1;
+            drop->splash = ((i & 7) == 0);  /* Splash on one drop in eight */
+
+            drop->pos[0] = vol->min[0] + RANDF() * WEATHER_VOLUME_SIZE;
+            drop->pos[1] = vol->min[1] + RANDF() * (WEATHER_VOLUME_ABOVE + WEATHER_VOLUME_BELOW);
+            drop->pos[2] = vol->min[2] + RANDF() * WEATHER_VOLUME_SIZE;
+
+            drop->vel[0] = 0.0f;
+            drop->vel[1] = -3.0f - RANDF() * 2.0f;
+            drop->vel[2] = 0.0f;
+
+            drop->length = 1.0f + RANDF() * 0.5f;
+        }
+    }
 }
 
 void weather_spawn_rain(s32 count) {
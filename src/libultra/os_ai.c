@@ -8,6 +8,9 @@
 
 #include "types.h"
 
+/* Host builds use os_host_audio.c */
+#ifndef HOST_BUILD
+
 /* Hardware register addresses (AI Base: 0xA4500000) */
 #define AI_DRAM_ADDR_REG    (*(vu32 *)0xA4500000)  /* AI_DRAM_ADDR: DRAM address for DMA */
 #define AI_LEN_REG          (*(vu32 *)0xA4500004)  /* AI_LEN: Length of DMA transfer */
@@ -122,3 +125,5 @@ s32 osAiSetFrequency(u32 frequency) {
     /* Return actual frequency */
     return (s32)osClockRate / dRate;
 }
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,593 @@
+/**
+ * @file os_host.c
+ * @brief POSIX-thread backend for libultra threads and message queues
+ *
+ * Host-only replacement for os_thread.c, os_yield.c, os_message.c and
+ * os_jam.c / os_mesg_jam.c, compiled when HOST_BUILD is defined (32-bit
+ * host, -m32, so pointer/u32 casts in the game code still hold). The N64
+ * versions of the same functions are compiled out in that configuration.
+ *
+ * Mapping:
+ * - Each OSThread gets a pthread plus a private condition variable.
+ * - One process-wide mutex guards the OS state; it is held only inside
+ *   OS calls, so threads run truly in parallel between them.
+ * - __osDisableInt/__osRestoreInt take a second, recursive mutex, so
+ *   masked sections still exclude each other and may make OS calls.
+ * - OSMesgQueue keeps its N64 layout. The mtqueue/fullqueue lists hold
+ *   blocked OSThreads sorted by priority (FIFO within a priority), exactly
+ *   like __osEnqueueThread, so the highest-priority waiter is always the
+ *   one woken.
+ * - OS priorities are mapped onto SCHED_FIFO when the process is allowed
+ *   to use it; otherwise ordering is enforced only at the wait queues.
+ *
+ * Stopping a thread that is currently running on another core cannot
+ * preempt it; it parks at its next message call instead.
+ */
+
+#ifdef HOST_BUILD
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "types.h"
+#include "PR/os_thread.h"
+#include "PR/os_message.h"
+
+#define HOST_MAX_THREADS    16
+
+/* Host-side companion to an OSThread */
+typedef struct HostThread {
+    OSThread        *os;            /* Owning libultra thread */
+    pthread_t       handle;         /* Backing pthread */
+    pthread_cond_t  wake;           /* Signalled when woken/started */
+    void            (*entry)(void *);
+    void            *arg;
+    s32             created;        /* pthread has been spawned */
+    s32             signaled;       /* Wake-up pending */
+    s32             stop_pending;   /* Park at next OS call */
+} HostThread;
+
+/* Big OS lock - replaces interrupt masking */
+static pthread_mutex_t sHostLock = PTHREAD_MUTEX_INITIALIZER;
+
+static HostThread sHostThreads[HOST_MAX_THREADS];
+static __thread HostThread *sHostSelf;
+
+/* Stand-in for the boot thread, which never goes through osCreateThread */
+static OSThread sHostBootThread;
+
+/* Most recently scheduled thread (informational only on host) */
+OSThread *__osRunningThread;
+
+/*
+ * ==========================================================================
+ * Internal helpers (all called with sHostLock held)
+ * ==========================================================================
+ */
+
+/**
+ * Find the host record for an OSThread, optionally allocating one
+ */
+static HostThread *host_lookup(OSThread *t, s32 alloc) {
+    s32 i;
+    HostThread *free_slot = NULL;
+
+    for (i = 0; i < HOST_MAX_THREADS; i++) {
+        if (sHostThreads[i].os == t) {
+            return &sHostThreads[i];
+        }
+        if (sHostThreads[i].os == NULL && free_slot == NULL) {
+            free_slot = &sHostThreads[i];
+        }
+    }
+
+    if (alloc && free_slot != NULL) {
+        free_slot->os = t;
+        free_slot->created = 0;
+        free_slot->signaled = 0;
+        free_slot->stop_pending = 0;
+        pthread_cond_init(&free_slot->wake, NULL);
+    }
+    return alloc ? free_slot : NULL;
+}
+
+/**
+ * Host record for the calling pthread
+ *
+ * The main (boot) thread is registered lazily at priority OS_PRIORITY_APPMAX.
+ */
+static HostThread *host_self(void) {
+    if (sHostSelf == NULL) {
+        sHostBootThread.priority = OS_PRIORITY_APPMAX;
+        sHostBootThread.state = OS_STATE_RUNNING;
+        sHostSelf = host_lookup(&sHostBootThread, 1);
+        sHostSelf->handle = pthread_self();
+        sHostSelf->created = 1;
+    }
+    return sHostSelf;
+}
+
+/**
+ * Insert a thread into a priority-sorted wait list
+ */
+static void host_enqueue(OSThread **queue, OSThread *t) {
+    while (*queue != NULL && (*queue)->priority >= t->priority) {
+        queue = &(*queue)->next;
+    }
+    t->next = *queue;
+    *queue = t;
+}
+
+/**
+ * Remove a specific thread from a wait list
+ */
+static void host_dequeue(OSThread **queue, OSThread *t) {
+    while (*queue != NULL) {
+        if (*queue == t) {
+            *queue = t->next;
+            t->next = NULL;
+            return;
+        }
+        queue = &(*queue)->next;
+    }
+}
+
+/**
+ * Map an OS priority onto the host scheduler (best effort)
+ */
+static void host_apply_priority(HostThread *h) {
+    struct sched_param param;
+    s32 lo, hi;
+
+    lo = sched_get_priority_min(SCHED_FIFO);
+    hi = sched_get_priority_max(SCHED_FIFO);
+    param.sched_priority = lo + (h->os->priority * (hi - lo)) / OS_PRIORITY_MAX;
+
+    /* Fails without realtime privileges; wait-queue ordering still holds */
+    pthread_setschedparam(h->handle, SCHED_FIFO, &param);
+}
+
+/**
+ * Block the calling thread until another thread wakes it
+ *
+ * @param queue Wait list to join, or NULL to park until osStartThread
+ */
+static void host_wait(HostThread *self, OSThread **queue, u16 state) {
+    self->signaled = 0;
+    self->os->state = state;
+    self->os->queue = queue;
+    if (queue != NULL) {
+        host_enqueue(queue, self->os);
+    }
+
+    while (!self->signaled) {
+        pthread_cond_wait(&self->wake, &sHostLock);
+    }
+
+    self->os->state = OS_STATE_RUNNING;
+    self->os->queue = NULL;
+    __osRunningThread = self->os;
+}
+
+/**
+ * Wake a specific thread
+ */
+static void host_signal(OSThread *t) {
+    HostThread *h = host_lookup(t, 0);
+
+    t->state = OS_STATE_RUNNABLE;
+    if (h != NULL) {
+        h->signaled = 1;
+        pthread_cond_signal(&h->wake);
+    }
+}
+
+/**
+ * Wake the highest-priority thread on a wait list, if any
+ */
+static void host_wake(OSThread **queue) {
+    OSThread *t = *queue;
+
+    if (t != NULL) {
+        *queue = t->next;
+        t->next = NULL;
+        t->queue = NULL;
+        host_signal(t);
+    }
+}
+
+/**
+ * Honour an osStopThread issued while this thread was running
+ */
+static void host_checkpoint(HostThread *self) {
+    if (self->stop_pending) {
+        self->stop_pending = 0;
+        host_wait(self, NULL, OS_STATE_STOPPED);
+    }
+}
+
+/**
+ * pthread entry trampoline
+ */
+static void *host_thread_main(void *arg) {
+    HostThread *h = (HostThread *)arg;
+
+    sHostSelf = h;
+    pthread_detach(pthread_self());
+
+    pthread_mutex_lock(&sHostLock);
+    h->os->state = OS_STATE_RUNNING;
+    __osRunningThread = h->os;
+    pthread_mutex_unlock(&sHostLock);
+
+    h->entry(h->arg);
+
+    /* Returning from a thread entry stops it, as on hardware */
+    pthread_mutex_lock(&sHostLock);
+    h->os->state = OS_STATE_STOPPED;
+    pthread_mutex_unlock(&sHostLock);
+    return NULL;
+}
+
+/*
+ * ==========================================================================
+ * Threads
+ * ==========================================================================
+ */
+
+/**
+ * Create a thread (host)
+ *
+ * The stack argument is ignored; pthreads allocate their own.
+ */
+void osCreateThread(OSThread *thread, s32 id, void (*entry)(void *),
+                    void *arg, void *stack, s32 priority) {
+    HostThread *h;
+
+    pthread_mutex_lock(&sHostLock);
+
+    thread->id = id;
+    thread->priority = priority;
+    thread->next = NULL;
+    thread->queue = NULL;
+    thread->fp = 0;
+    thread->state = OS_STATE_STOPPED;
+    thread->flags = 0;
+
+    h = host_lookup(thread, 1);
+    if (h != NULL) {
+        h->entry = entry;
+        h->arg = arg;
+        h->created = 0;
+        h->signaled = 0;
+        h->stop_pending = 0;
+    }
+
+    pthread_mutex_unlock(&sHostLock);
+}
+
+/**
+ * Start (or resume) a thread (host)
+ */
+void osStartThread(OSThread *thread) {
+    HostThread *h;
+
+    pthread_mutex_lock(&sHostLock);
+
+    h = host_lookup(thread, 0);
+    if (h == NULL || thread->state != OS_STATE_STOPPED) {
+        pthread_mutex_unlock(&sHostLock);
+        return;
+    }
+
+    if (h->stop_pending) {
+        /* Stopped while running but not parked yet - cancel the stop */
+        h->stop_pending = 0;
+        thread->state = OS_STATE_RUNNING;
+    } else if (!h->created) {
+        /* First start - spawn the backing pthread */
+        thread->state = OS_STATE_RUNNABLE;
+        if (pthread_create(&h->handle, NULL, host_thread_main, h) == 0) {
+            h->created = 1;
+            host_apply_priority(h);
+        }
+    } else if (thread->queue != NULL) {
+        /* Stopped while blocked on a queue - rejoin the wait */
+        thread->state = OS_STATE_WAITING;
+        host_enqueue(thread->queue, thread);
+    } else {
+        host_signal(thread);
+    }
+
+    pthread_mutex_unlock(&sHostLock);
+}
+
+/**
+ * Stop a thread (host)
+ *
+ * @param thread Thread to stop, or NULL for the caller
+ */
+void osStopThread(OSThread *thread) {
+    HostThread *self;
+    HostThread *h;
+
+    pthread_mutex_lock(&sHostLock);
+    self = host_self();
+
+    if (thread == NULL || thread == self->os) {
+        host_wait(self, NULL, OS_STATE_STOPPED);
+    } else if ((h = host_lookup(thread, 0)) != NULL) {
+        switch (thread->state) {
+            case OS_STATE_WAITING:
+                /* Leave thread->queue set so osStartThread can re-enqueue */
+                host_dequeue(thread->queue, thread);
+                thread->state = OS_STATE_STOPPED;
+                break;
+
+            case OS_STATE_RUNNABLE:
+            case OS_STATE_RUNNING:
+                h->stop_pending = 1;
+                thread->state = OS_STATE_STOPPED;
+                break;
+        }
+    }
+
+    pthread_mutex_unlock(&sHostLock);
+}
+
+/**
+ * Yield/stop a thread (host) - same semantics as the N64 osYieldThread
+ */
+void osYieldThread(OSThread *thread) {
+    osStopThread(thread);
+}
+
+/**
+ * Set thread priority (host)
+ *
+ * A blocked thread is re-sorted within its wait list.
+ */
+OSPri osSetThreadPri(OSThread *thread, OSPri priority) {
+    HostThread *h;
+    OSPri old_priority;
+
+    pthread_mutex_lock(&sHostLock);
+
+    if (thread == NULL) {
+        thread = host_self()->os;
+    }
+
+    old_priority = thread->priority;
+    thread->priority = priority;
+
+    if (thread->state == OS_STATE_WAITING && thread->queue != NULL) {
+        host_dequeue(thread->queue, thread);
+        host_enqueue(thread->queue, thread);
+    }
+
+    h = host_lookup(thread, 0);
+    if (h != NULL && h->created) {
+        host_apply_priority(h);
+    }
+
+    pthread_mutex_unlock(&sHostLock);
+    return old_priority;
+}
+
+OSPri osGetThreadPri(OSThread *thread) {
+    if (thread == NULL) {
+        thread = host_self()->os;
+    }
+    return thread->priority;
+}
+
+OSId osGetThreadId(OSThread *thread) {
+    if (thread == NULL) {
+        thread = host_self()->os;
+    }
+    return thread->id;
+}
+
+/**
+ * Interrupt mask (host) - no interrupts to mask
+ */
+void osSetIntMask(s32 mask) {
+}
+
+static pthread_mutex_t sHostIntLock;
+static pthread_once_t sHostIntOnce = PTHREAD_ONCE_INIT;
+
+static void host_int_init(void) {
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&sHostIntLock, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/**
+ * Enter an interrupt-masked section (host)
+ *
+ * Sections nest like on the N64, as long as each disable is paired with
+ * one restore.
+ *
+ * @return Token for __osRestoreInt
+ */
+s32 __osDisableInt(void) {
+    pthread_once(&sHostIntOnce, host_int_init);
+    pthread_mutex_lock(&sHostIntLock);
+    return 1;
+}
+
+/**
+ * Leave an interrupt-masked section (host)
+ */
+void __osRestoreInt(s32 mask) {
+    pthread_mutex_unlock(&sHostIntLock);
+}
+
+/*
+ * ==========================================================================
+ * Message Queues
+ * ==========================================================================
+ */
+
+void osCreateMesgQueue(OSMesgQueue *mq, OSMesg *msg, s32 count) {
+    mq->mtqueue = NULL;
+    mq->fullqueue = NULL;
+    mq->validCount = 0;
+    mq->first = 0;
+    mq->msgCount = count;
+    mq->msg = msg;
+}
+
+/**
+ * Wait for space in a queue
+ *
+ * @return 0 once space is available, -1 if full and non-blocking
+ */
+static s32 host_wait_space(HostThread *self, OSMesgQueue *mq, s32 flags) {
+    while (mq->validCount >= mq->msgCount) {
+        if (flags != OS_MESG_BLOCK) {
+            return -1;
+        }
+        host_wait(self, &mq->fullqueue, OS_STATE_WAITING);
+    }
+    return 0;
+}
+
+s32 osSendMesg(OSMesgQueue *mq, OSMesg msg, s32 flags) {
+    HostThread *self;
+    s32 index;
+
+    pthread_mutex_lock(&sHostLock);
+    self = host_self();
+    host_checkpoint(self);
+
+    if (host_wait_space(self, mq, flags) < 0) {
+        pthread_mutex_unlock(&sHostLock);
+        return -1;
+    }
+
+    index = (mq->first + mq->validCount) % mq->msgCount;
+    mq->msg[index] = msg;
+    mq->validCount++;
+
+    host_wake(&mq->mtqueue);
+
+    pthread_mutex_unlock(&sHostLock);
+    return 0;
+}
+
+s32 osJamMesg(OSMesgQueue *mq, OSMesg msg, s32 flags) {
+    HostThread *self;
+
+    pthread_mutex_lock(&sHostLock);
+    self = host_self();
+    host_checkpoint(self);
+
+    if (host_wait_space(self, mq, flags) < 0) {
+        pthread_mutex_unlock(&sHostLock);
+        return -1;
+    }
+
+    mq->first = (mq->first + mq->msgCount - 1) % mq->msgCount;
+    mq->msg[mq->first] = msg;
+    mq->validCount++;
+
+    host_wake(&mq->mtqueue);
+
+    pthread_mutex_unlock(&sHostLock);
+    return 0;
+}
+
+s32 osRecvMesg(OSMesgQueue *mq, OSMesg *msg, s32 flags) {
+    HostThread *self;
+
+    pthread_mutex_lock(&sHostLock);
+    self = host_self();
+    host_checkpoint(self);
+
+    while (mq->validCount == 0) {
+        if (flags == OS_MESG_NOBLOCK) {
+            pthread_mutex_unlock(&sHostLock);
+            return -1;
+        }
+        host_wait(self, &mq->mtqueue, OS_STATE_WAITING);
+    }
+
+    if (msg != NULL) {
+        *msg = mq->msg[mq->first];
+    }
+    mq->first = (mq->first + 1) % mq->msgCount;
+    mq->validCount--;
+
+    host_wake(&mq->fullqueue);
+
+    pthread_mutex_unlock(&sHostLock);
+    return 0;
+}
+
+/*
+ * ==========================================================================
+ * Round-trip benchmark
+ * ==========================================================================
+ */
+
+static OSThread sBenchThread;
+static OSMesgQueue sBenchPingQueue;
+static OSMesgQueue sBenchPongQueue;
+static OSMesg sBenchPingBuf[1];
+static OSMesg sBenchPongBuf[1];
+
+/**
+ * Echo thread - bounces every ping back until it receives NULL
+ */
+static void host_bench_echo(void *arg) {
+    OSMesg msg;
+
+    do {
+        osRecvMesg(&sBenchPingQueue, &msg, OS_MESG_BLOCK);
+        osSendMesg(&sBenchPongQueue, msg, OS_MESG_BLOCK);
+    } while (msg != NULL);
+}
+
+/**
+ * Measure blocking send→recv→send→recv latency between two threads
+ *
+ * @param iterations Number of round trips
+ * @return Average round trip in nanoseconds
+ */
+u32 __osHostMesgRoundTrip(s32 iterations) {
+    struct timespec t0, t1;
+    OSMesg msg;
+    s64 elapsed;
+    s32 i;
+
+    if (iterations <= 0) {
+        return 0;
+    }
+
+    osCreateMesgQueue(&sBenchPingQueue, sBenchPingBuf, 1);
+    osCreateMesgQueue(&sBenchPongQueue, sBenchPongBuf, 1);
+    osCreateThread(&sBenchThread, 99, host_bench_echo, NULL, NULL, OS_PRIORITY_APPMAX);
+    osStartThread(&sBenchThread);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < iterations; i++) {
+        osSendMesg(&sBenchPingQueue, (OSMesg)1, OS_MESG_BLOCK);
+        osRecvMesg(&sBenchPongQueue, &msg, OS_MESG_BLOCK);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    /* Shut the echo thread down */
+    osSendMesg(&sBenchPingQueue, NULL, OS_MESG_BLOCK);
+    osRecvMesg(&sBenchPongQueue, &msg, OS_MESG_BLOCK);
+
+    elapsed = (s64)(t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec);
+    return (u32)(elapsed / iterations);
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,812 @@
+/**
+ * @file os_host_audio.c
+ * @brief Host interpreter for the RSP audio command list
+ *
+ * Host-only stand-in for the aspMain audio microcode plus the AI DMA, for
+ * offline regression runs and mixing-cost profiling. __osHostAudioRun()
+ * executes an Acmd list against a 4 KB DMEM image exactly where the RSP
+ * would; osAiSetNextBuffer() (replacing os_ai.c) appends the resulting
+ * PCM to a WAV file when recording.
+ *
+ * Kernels work on 8-sample blocks, mirroring the RSP's 8-lane vector
+ * unit, using GCC vector extensions so the host compiler emits SSE/NEON.
+ * Envelopes step once per block, like the microcode.
+ *
+ * Fidelity: ADPCM decode follows the VADPCM predictor exactly; the
+ * resampler is linear rather than the microcode's 4-tap filter, and the
+ * envelope ramp is linear in 16.16. Output is close, not bit-exact.
+ *
+ * Addresses: seg << 24 | offset, resolved through the segment table.
+ * Segment 0 has no base, so plain pointers work when pointers are 32-bit
+ * (-m32); 64-bit hosts register buffers with __osHostAudioSetSegment().
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "types.h"
+#include "PR/abi.h"
+#include "PR/os_ai.h"
+
+#define DMEM_SIZE       0x1000
+#define NUM_SEGMENTS    16
+#define HOST_AUDIO_MAX_VOICES   64
+
+typedef s16 v8s16 __attribute__((vector_size(16)));
+typedef s32 v8s32 __attribute__((vector_size(32)));
+
+/* Microcode registers */
+typedef struct HostAsp {
+    u8      dmem[DMEM_SIZE] __attribute__((aligned(16)));
+    u8      *seg[NUM_SEGMENTS];
+    u16     in, out, count;         /* A_SETBUFF main */
+    u16     dry_right, wet_left, wet_right;  /* A_SETBUFF A_AUX */
+    s16     vol[2];                 /* A_SETVOL A_VOL (L, R) */
+    s16     target[2];
+    s32     rate[2];                /* 16.16 step per sample */
+    s16     dry, wet;
+    s16     adpcm_book[8][2][8];    /* A_LOADADPCM codebook */
+    s32     adpcm_npred;
+    u8      *loop_state;            /* A_SETLOOP */
+} HostAsp;
+
+static HostAsp sAsp;
+static OSHostAudioStats sStats;
+static s32 sOpTiming;               /* Fill op_ns/op_count */
+
+static FILE *sWavFile;
+static u32 sWavBytes;
+static u32 sAiFrequency = 22050;
+
+/*
+ * ==========================================================================
+ * Helpers
+ * ==========================================================================
+ */
+
+static u8 *asp_addr(u32 a) {
+    u8 *base = sAsp.seg[(a >> 24) & (NUM_SEGMENTS - 1)];
+
+    if (base == NULL) {
+        return (u8 *)(size_t)a;
+    }
+    return base + (a & 0xFFFFFF);
+}
+
+static s16 *dmem16(u32 off) {
+    return (s16 *)(sAsp.dmem + (off & (DMEM_SIZE - 2)));
+}
+
+/* Bytes of count that fit between off and the end of DMEM */
+static u32 dmem_fit(u32 off, u32 count) {
+    u32 room = DMEM_SIZE - (off & (DMEM_SIZE - 1));
+
+    return count > room ? room : count;
+}
+
+/* Samples a block kernel may touch: count rounded up to whole blocks, cut
+ * back to whole blocks that fit at off */
+static s32 dmem_blocks(u32 off, u32 count) {
+    u32 bytes = (count + 15) & ~15U;
+
+    if (bytes > dmem_fit(off, bytes)) {
+        bytes = dmem_fit(off, bytes) & ~15U;
+    }
+    return (s32)(bytes >> 1);
+}
+
+static s32 min_s32(s32 a, s32 b) {
+    return a < b ? a : b;
+}
+
+static s32 clamp16(s32 v) {
+    return v < -32768 ? -32768 : (v > 32767 ? 32767 : v);
+}
+
+/*
+ * Vector helpers pass by pointer: 32-byte vectors by value would change
+ * the calling convention depending on whether AVX is enabled.
+ */
+static void v_load(v8s32 *v, const s16 *p) {
+    v8s16 a;
+
+    memcpy(&a, p, sizeof(a));
+    *v = __builtin_convertvector(a, v8s32);
+}
+
+static void v_store_sat(s16 *p, const v8s32 *in) {
+    const v8s32 hi = { 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767 };
+    const v8s32 lo = -hi - 1;
+    v8s32 v = *in;
+    v8s32 m;
+    v8s16 out;
+
+    m = v > hi;
+    v = (v & ~m) | (hi & m);
+    m = v < lo;
+    v = (v & ~m) | (lo & m);
+    out = __builtin_convertvector(v, v8s16);
+    memcpy(p, &out, sizeof(out));
+}
+
+static void v_splat(v8s32 *v, s32 x) {
+    v8s32 t = { x, x, x, x, x, x, x, x };
+    *v = t;
+}
+
+/* dst += (src * gain) >> 15, saturated */
+static void v_mac(s16 *dst, const v8s32 *src, const v8s32 *gain) {
+    v8s32 d, t;
+
+    v_load(&d, dst);
+    t = d + ((*src * *gain) >> 15);
+    v_store_sat(dst, &t);
+}
+
+/*
+ * ==========================================================================
+ * Commands
+ * ==========================================================================
+ */
+
+/**
+ * A_ADPCM - decode 9-byte VADPCM frames from in to count bytes at out
+ */
+static void asp_adpcm(u32 flags, u32 addr) {
+    s16 *state = (s16 *)asp_addr(addr);
+    u8 *src = sAsp.dmem + (sAsp.in & (DMEM_SIZE - 1));
+    s16 *dst = dmem16(sAsp.out);
+    s32 nframes = (sAsp.count + 31) >> 5;
+    s16 prev[2];
+    s32 ins[8];
+    s32 f, h, i, k, scale, pred;
+    s32 acc;
+    s16 (*book)[8];
+
+    nframes = min_s32(nframes, (s32)dmem_fit(sAsp.out, (u32)nframes << 5) >> 5);
+    nframes = min_s32(nframes, (s32)dmem_fit(sAsp.in, (u32)nframes * 9) / 9);
+    if (nframes <= 0) {
+        return;
+    }
+
+    if (flags & A_INIT) {
+        prev[0] = prev[1] = 0;
+    } else if (flags & A_LOOP) {
+        prev[0] = ((s16 *)sAsp.loop_state)[14];
+        prev[1] = ((s16 *)sAsp.loop_state)[15];
+    } else {
+        prev[0] = state[14];
+        prev[1] = state[15];
+    }
+
+    for (f = 0; f < nframes; f++) {
+        scale = 1 << (src[0] >> 4);
+        pred = src[0] & 0xF;
+        if (pred >= sAsp.adpcm_npred) {
+            pred = 0;
+        }
+        book = sAsp.adpcm_book[pred];
+        src++;
+
+        for (h = 0; h < 2; h++) {
+            for (i = 0; i < 8; i += 2) {
+                ins[i] = (s32)(s8)(src[i >> 1] & 0xF0) >> 4;
+                ins[i + 1] = (s32)(s8)(src[i >> 1] << 4) >> 4;
+                ins[i] *= scale;
+                ins[i + 1] *= scale;
+            }
+            src += 4;
+
+            for (i = 0; i < 8; i++) {
+                acc = book[0][i] * prev[0] + book[1][i] * prev[1] + (ins[i] << 11);
+                for (k = 0; k < i; k++) {
+                    acc += book[1][i - k - 1] * ins[k];
+                }
+                dst[i] = (s16)clamp16(acc >> 11);
+            }
+            prev[0] = dst[6];
+            prev[1] = dst[7];
+            dst += 8;
+        }
+    }
+
+    /* Last 16 samples are the next frame's history */
+    memcpy(state, dst - 16, 32);
+}
+
+/**
+ * A_RESAMPLE - pitch-shift in to count bytes at out (linear)
+ *
+ * State: [0] last input sample, [1..2] 16.16 phase.
+ */
+static void asp_resample(u32 flags, u32 pitch, u32 addr) {
+    s16 *state = (s16 *)asp_addr(addr);
+    s16 *src = dmem16(sAsp.in);
+    s16 *dst = dmem16(sAsp.out);
+    s32 n = (s32)dmem_fit(sAsp.out, sAsp.count) >> 1;
+    s32 avail = (s32)dmem_fit(sAsp.in, DMEM_SIZE) >> 1;
+    u32 step = pitch << 1;          /* 1.15 -> 16.16 */
+    u32 phase;
+    s32 last, a, b, i, idx;
+
+    if (flags & A_INIT) {
+        last = 0;
+        phase = 0;
+    } else {
+        last = state[0];
+        phase = ((u32)(u16)state[1] << 16) | (u16)state[2];
+    }
+
+    for (i = 0; i < n; i++) {
+        idx = (s32)(phase >> 16);
+        if (idx >= avail) {
+            break;
+        }
+        a = idx == 0 ? last : src[idx - 1];
+        b = src[idx];
+        dst[i] = (s16)(a + (((b - a) * (s32)(phase & 0xFFFF)) >> 16));
+        phase += step;
+    }
+
+    idx = min_s32((s32)(phase >> 16), avail);
+    state[0] = idx == 0 ? (s16)last : src[idx - 1];
+    phase &= 0xFFFF;
+    state[1] = (s16)(phase >> 16);
+    state[2] = (s16)phase;
+}
+
+/**
+ * A_ENVMIXER - apply L/R envelopes and mix into dry and wet buses
+ */
+static void asp_envmixer(u32 flags, u32 addr) {
+    s32 *state = (s32 *)asp_addr(addr);
+    s16 *src = dmem16(sAsp.in);
+    s16 *dl = dmem16(sAsp.out);
+    s16 *dr = dmem16(sAsp.dry_right);
+    s16 *wl = dmem16(sAsp.wet_left);
+    s16 *wr = dmem16(sAsp.wet_right);
+    s32 vol[2], target[2], rate[2], dry, wet;
+    s32 n;
+    s32 i, c;
+    v8s32 s, l, r, vd, vw, vl, vr;
+
+    n = min_s32(dmem_blocks(sAsp.in, sAsp.count), dmem_blocks(sAsp.out, sAsp.count));
+    n = min_s32(n, dmem_blocks(sAsp.dry_right, sAsp.count));
+    if (flags & A_AUX) {
+        n = min_s32(n, dmem_blocks(sAsp.wet_left, sAsp.count));
+        n = min_s32(n, dmem_blocks(sAsp.wet_right, sAsp.count));
+    }
+
+    if (flags & A_INIT) {
+        for (c = 0; c < 2; c++) {
+            vol[c] = (s32)sAsp.vol[c] << 16;
+            target[c] = (s32)sAsp.target[c] << 16;
+            rate[c] = sAsp.rate[c];
+        }
+        dry = sAsp.dry;
+        wet = sAsp.wet;
+    } else {
+        for (c = 0; c < 2; c++) {
+            vol[c] = state[c];
+            target[c] = state[2 + c];
+            rate[c] = state[4 + c];
+        }
+        dry = state[6];
+        wet = state[7];
+    }
+
+    v_splat(&vd, dry);
+    v_splat(&vw, wet);
+
+    for (i = 0; i < n; i += 8) {
+        v_load(&s, src + i);
+        v_splat(&vl, vol[0] >> 16);
+        v_splat(&vr, vol[1] >> 16);
+        l = (s * vl) >> 15;
+        r = (s * vr) >> 15;
+
+        v_mac(dl + i, &l, &vd);
+        v_mac(dr + i, &r, &vd);
+        if (flags & A_AUX) {
+            v_mac(wl + i, &l, &vw);
+            v_mac(wr + i, &r, &vw);
+        }
+
+        /* Ramp once per block, stopping at the target */
+        for (c = 0; c < 2; c++) {
+            vol[c] += rate[c] * 8;
+            if ((rate[c] > 0 && vol[c] > target[c]) || (rate[c] < 0 && vol[c] < target[c])) {
+                vol[c] = target[c];
+            }
+        }
+    }
+
+    for (c = 0; c < 2; c++) {
+        state[c] = vol[c];
+        state[2 + c] = target[c];
+        state[4 + c] = rate[c];
+    }
+    state[6] = dry;
+    state[7] = wet;
+}
+
+/**
+ * A_MIXER - out += in * gain (Q15)
+ */
+static void asp_mixer(u32 gain, u32 in, u32 out) {
+    s16 *src = dmem16(in);
+    s16 *dst = dmem16(out);
+    s32 n = min_s32(dmem_blocks(in, sAsp.count), dmem_blocks(out, sAsp.count));
+    s32 i;
+    v8s32 g, s;
+
+    v_splat(&g, (s16)gain);
+    for (i = 0; i < n; i += 8) {
+        v_load(&s, src + i);
+        v_mac(dst + i, &s, &g);
+    }
+}
+
+/**
+ * A_POLEF - one-pole low-pass, in to out (reverb damping)
+ */
+static void asp_polef(u32 flags, u32 gain, u32 addr) {
+    s16 *state = (s16 *)asp_addr(addr);
+    s16 *src = dmem16(sAsp.in);
+    s16 *dst = dmem16(sAsp.out);
+    s32 n = (s32)min_s32(dmem_fit(sAsp.in, sAsp.count), dmem_fit(sAsp.out, sAsp.count)) >> 1;
+    s32 g = (s16)gain;
+    s32 y, i;
+
+    y = (flags & A_INIT) ? 0 : state[0];
+    for (i = 0; i < n; i++) {
+        y = (src[i] * g + y * (0x7FFF - g)) >> 15;
+        dst[i] = (s16)y;
+    }
+    state[0] = (s16)y;
+}
+
+static void asp_interleave(u32 left, u32 right) {
+    s16 *l = dmem16(left);
+    s16 *r = dmem16(right);
+    s16 tmp[DMEM_SIZE / 2];
+    s32 n = sAsp.count >> 1;
+    s32 i;
+
+    /* n samples from each side, 2n out */
+    n = min_s32(n, (s32)dmem_fit(left, DMEM_SIZE) >> 1);
+    n = min_s32(n, (s32)dmem_fit(right, DMEM_SIZE) >> 1);
+    n = min_s32(n, (s32)dmem_fit(sAsp.out, DMEM_SIZE) >> 2);
+
+    for (i = 0; i < n; i++) {
+        tmp[i * 2] = l[i];
+        tmp[i * 2 + 1] = r[i];
+    }
+    memcpy(dmem16(sAsp.out), tmp, n * 4);
+}
+
+/**
+ * Execute one audio command list
+ *
+ * @param cmds Command list
+ * @param count Number of commands
+ */
+void __osHostAudioRun(Acmd *cmds, s32 count) {
+    struct timespec t0, t1, c0, c1;
+    Acmd *a;
+    u32 op, flags, w0, w1;
+    u32 seen[HOST_AUDIO_MAX_VOICES];
+    s32 i, j, voices = 0;
+    u64 ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (i = 0; i < count; i++) {
+        a = &cmds[i];
+        w0 = a->w0;
+        w1 = a->w1;
+        op = w0 >> 24;
+        flags = (w0 >> 16) & 0xFF;
+
+        if (sOpTiming) {
+            clock_gettime(CLOCK_MONOTONIC, &c0);
+        }
+
+        switch (op) {
+            case A_ADPCM:
+                asp_adpcm(flags, w1);
+                break;
+
+            case A_CLEARBUFF:
+                memset(sAsp.dmem + (w0 & (DMEM_SIZE - 1)), 0,
+                       dmem_fit(w0 & 0xFFFF, w1 & 0xFFFF));
+                break;
+
+            case A_ENVMIXER:
+                asp_envmixer(flags, w1);
+                /* A voice is one envmixer state, however many chunks it spans */
+                for (j = 0; j < voices && seen[j] != w1; j++) {
+                }
+                if (j == voices && voices < HOST_AUDIO_MAX_VOICES) {
+                    seen[voices++] = w1;
+                }
+                break;
+
+            case A_LOADBUFF:
+                memcpy(sAsp.dmem + (sAsp.in & (DMEM_SIZE - 1)), asp_addr(w1),
+                       dmem_fit(sAsp.in, sAsp.count));
+                break;
+
+            case A_RESAMPLE:
+                asp_resample(flags, w0 & 0xFFFF, w1);
+                break;
+
+            case A_SAVEBUFF:
+                memcpy(asp_addr(w1), sAsp.dmem + (sAsp.out & (DMEM_SIZE - 1)),
+                       dmem_fit(sAsp.out, sAsp.count));
+                break;
+
+            case A_SEGMENT:
+                sAsp.seg[(w1 >> 24) & (NUM_SEGMENTS - 1)] = asp_addr(w1 & 0xFFFFFF);
+                break;
+
+            case A_SETBUFF:
+                if (flags & A_AUX) {
+                    sAsp.dry_right = w0 & 0xFFFF;
+                    sAsp.wet_left = w1 >> 16;
+                    sAsp.wet_right = w1 & 0xFFFF;
+                } else {
+                    sAsp.in = w0 & 0xFFFF;
+                    sAsp.out = w1 >> 16;
+                    sAsp.count = w1 & 0xFFFF;
+                }
+                break;
+
+            case A_SETVOL:
+                if (flags & A_AUX) {
+                    sAsp.dry = (s16)w0;
+                    sAsp.wet = (s16)(w1 >> 16);
+                } else if (flags & A_VOL) {
+                    sAsp.vol[(flags & A_LEFT) ? 0 : 1] = (s16)w0;
+                } else {
+                    sAsp.target[(flags & A_LEFT) ? 0 : 1] = (s16)w0;
+                    sAsp.rate[(flags & A_LEFT) ? 0 : 1] = (s32)w1;
+                }
+                break;
+
+            case A_DMEMMOVE:
+                memmove(sAsp.dmem + ((w1 >> 16) & (DMEM_SIZE - 1)),
+                        sAsp.dmem + (w0 & (DMEM_SIZE - 1)),
+                        dmem_fit(w1 >> 16, dmem_fit(w0 & 0xFFFF, w1 & 0xFFFF)));
+                break;
+
+            case A_LOADADPCM:
+                sAsp.adpcm_npred = (s32)((w0 & 0xFFFF) / sizeof(sAsp.adpcm_book[0]));
+                if (sAsp.adpcm_npred > 8) {
+                    sAsp.adpcm_npred = 8;
+                }
+                memcpy(sAsp.adpcm_book, asp_addr(w1),
+                       sAsp.adpcm_npred * sizeof(sAsp.adpcm_book[0]));
+                break;
+
+            case A_MIXER:
+                asp_mixer(w0 & 0xFFFF, w1 >> 16, w1 & 0xFFFF);
+                break;
+
+            case A_INTERLEAVE:
+                asp_interleave(w1 >> 16, w1 & 0xFFFF);
+                break;
+
+            case A_POLEF:
+                asp_polef(flags, w0 & 0xFFFF, w1);
+                break;
+
+            case A_SETLOOP:
+                sAsp.loop_state = asp_addr(w1);
+                break;
+
+            default:
+                break;
+        }
+
+        if (sOpTiming) {
+            clock_gettime(CLOCK_MONOTONIC, &c1);
+            sStats.op_ns[op & 0xF] += (u64)((c1.tv_sec - c0.tv_sec) * 1000000000LL +
+                                            (c1.tv_nsec - c0.tv_nsec));
+            sStats.op_count[op & 0xF]++;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns = (u64)((t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec));
+
+    sStats.frames++;
+    sStats.voices_last = voices;
+    sStats.ns_last = ns;
+    sStats.ns_per_voice_last = voices > 0 ? ns / voices : 0;
+    sStats.ns_total += ns;
+    sStats.voice_frames_total += voices;
+}
+
+void __osHostAudioSetSegment(s32 seg, void *base) {
+    sAsp.seg[seg & (NUM_SEGMENTS - 1)] = base;
+}
+
+OSHostAudioStats *__osHostAudioGetStats(void) {
+    return &sStats;
+}
+
+void __osHostAudioResetStats(void) {
+    memset(&sStats, 0, sizeof(sStats));
+}
+
+/**
+ * Enable per-opcode timing (op_ns/op_count)
+ *
+ * Off by default: the clock reads around every command cost about as much
+ * as the cheap commands themselves and would inflate ns_total.
+ */
+void __osHostAudioSetOpTiming(s32 on) {
+    sOpTiming = on;
+}
+
+/*
+ * ==========================================================================
+ * AI output (replaces os_ai.c)
+ * ==========================================================================
+ */
+
+static void wav_put32(u8 *p, u32 v) {
+    p[0] = (u8)v;
+    p[1] = (u8)(v >> 8);
+    p[2] = (u8)(v >> 16);
+    p[3] = (u8)(v >> 24);
+}
+
+static void wav_write_header(void) {
+    u8 h[44];
+
+    memcpy(h, "RIFF", 4);
+    wav_put32(h + 4, 36 + sWavBytes);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    wav_put32(h + 16, 16);
+    h[20] = 1;                              /* PCM */
+    h[21] = 0;
+    h[22] = 2;                              /* Stereo */
+    h[23] = 0;
+    wav_put32(h + 24, sAiFrequency);
+    wav_put32(h + 28, sAiFrequency * 4);
+    h[32] = 4;                              /* Block align */
+    h[33] = 0;
+    h[34] = 16;                             /* Bits per sample */
+    h[35] = 0;
+    memcpy(h + 36, "data", 4);
+    wav_put32(h + 40, sWavBytes);
+
+    fseek(sWavFile, 0, SEEK_SET);
+    fwrite(h, 1, sizeof(h), sWavFile);
+    fseek(sWavFile, 0, SEEK_END);
+}
+
+/**
+ * Start capturing AI output to a 16-bit stereo WAV file
+ * @return 0 on success, -1 on failure
+ */
+s32 __osHostAudioRecord(const char *path) {
+    __osHostAudioStopRecord();
+
+    sWavFile = fopen(path, "wb");
+    if (sWavFile == NULL) {
+        return -1;
+    }
+    sWavBytes = 0;
+    wav_write_header();
+    return 0;
+}
+
+void __osHostAudioStopRecord(void) {
+    if (sWavFile != NULL) {
+        wav_write_header();
+        fclose(sWavFile);
+        sWavFile = NULL;
+    }
+}
+
+/**
+ * Queue an audio buffer (host): interleaved s16 in host byte order, as
+ * written by A_INTERLEAVE/A_SAVEBUFF here (big-endian only on real N64)
+ */
+s32 osAiSetNextBuffer(void *addr, u32 size) {
+    u8 *src = (u8 *)addr;
+    u8 buf[512];
+    u32 i, n;
+
+    if (sWavFile == NULL) {
+        return 0;
+    }
+
+    while (size > 0) {
+        n = size > sizeof(buf) ? sizeof(buf) : size;
+        for (i = 0; i + 1 < n; i += 2) {
+            /* Host-native s16 -> little-endian WAV */
+            s16 s = *(s16 *)(src + i);
+            buf[i] = (u8)s;
+            buf[i + 1] = (u8)(s >> 8);
+        }
+        fwrite(buf, 1, n & ~1U, sWavFile);
+        sWavBytes += n & ~1U;
+        src += n;
+        size -= n;
+    }
+    return 0;
+}
+
+s32 osAiSetFrequency(u32 frequency) {
+    sAiFrequency = frequency;
+    return (s32)frequency;
+}
+
+/*
+ * ==========================================================================
+ * Engine-voice benchmark
+ * ==========================================================================
+ */
+
+#define BENCH_RATE          22050
+#define BENCH_FRAME         368         /* Samples per 60 Hz frame */
+#define BENCH_CHUNK         184         /* Samples per DMEM pass */
+#define BENCH_MAX_VOICES    24
+#define BENCH_SAMPLE_FRAMES 2048        /* ADPCM frames in the test sample */
+#define BENCH_DELAY         4096        /* Reverb delay line (samples) */
+
+/* DMEM layout (bytes) */
+#define DM_ADPCM_IN     0x000
+#define DM_DECODE_OUT   0x0D0
+#define DM_RESAMPLE_OUT 0x3D0
+#define DM_DRY_L        0x540
+#define DM_DRY_R        0x6B0
+#define DM_WET_L        0x820
+#define DM_WET_R        0x990
+#define DM_OUT          0xB00
+#define DM_REVERB       0xDE0
+#define DM_CHUNK_BYTES  (BENCH_CHUNK * 2)
+
+typedef struct BenchArena {
+    u8      sample[BENCH_SAMPLE_FRAMES * 9];
+    s16     book[1][2][8];
+    s16     adpcm_state[BENCH_MAX_VOICES][ADPCM_STATE];
+    s16     resample_state[BENCH_MAX_VOICES][RESAMPLE_STATE];
+    s32     env_state[BENCH_MAX_VOICES][ENVMIX_STATE / 2];
+    s16     polef_state[POLEF_STATE];
+    s16     delay[BENCH_DELAY];
+    s16     out[BENCH_FRAME * 2];
+} BenchArena;
+
+static BenchArena sBench;
+static Acmd sBenchCmds[2048];
+
+#define BENCH_SEG       1
+#define BENCH_ADDR(p)   ((BENCH_SEG << 24) | (u32)((u8 *)(p) - (u8 *)&sBench))
+
+/**
+ * Mix a synthetic engine field through the interpreter
+ *
+ * Each voice streams the same noisy ADPCM sample at its own pitch,
+ * envelope and pan, with a wet send into a damped delay-line reverb -
+ * the same command shape the synthesizer emits per engine voice.
+ *
+ * @param voices Engine voices (12 for a full grid)
+ * @param frames 60 Hz audio frames to mix
+ * @param wav_path Optional WAV output (NULL for none)
+ * @return Average mixing cost per voice per frame, in ns
+ */
+u32 __osHostAudioBench(s32 voices, s32 frames, const char *wav_path) {
+    u32 pos[BENCH_MAX_VOICES];      /* 16.16 sample position */
+    u32 pitch[BENCH_MAX_VOICES];
+    u32 seed = 0x2049;
+    s32 f, ch, v, n, i, first, start, need, nframes;
+    u32 delay_pos = 0;
+    Acmd *a;
+
+    if (voices > BENCH_MAX_VOICES) {
+        voices = BENCH_MAX_VOICES;
+    }
+
+    /* Noise-like sample; zero codebook so each frame decodes on its own */
+    for (i = 0; i < (s32)sizeof(sBench.sample); i++) {
+        seed = seed * 1103515245 + 12345;
+        sBench.sample[i] = (i % 9 == 0) ? 0x90 : (u8)(seed >> 16);
+    }
+    memset(sBench.book, 0, sizeof(sBench.book));
+    memset(sBench.delay, 0, sizeof(sBench.delay));
+
+    for (v = 0; v < voices; v++) {
+        pos[v] = 0;
+        pitch[v] = A_UNITY_PITCH / 2 + (u32)v * (A_UNITY_PITCH / voices);
+    }
+
+    __osHostAudioSetSegment(BENCH_SEG, &sBench);
+    osAiSetFrequency(BENCH_RATE);
+    if (wav_path != NULL) {
+        __osHostAudioRecord(wav_path);
+    }
+    __osHostAudioResetStats();
+
+    for (f = 0; f < frames; f++) {
+        a = sBenchCmds;
+        first = f == 0;
+
+        aLoadADPCM(a++, sizeof(sBench.book), BENCH_ADDR(sBench.book));
+
+        for (ch = 0; ch < BENCH_FRAME; ch += BENCH_CHUNK) {
+            aClearBuffer(a++, DM_DRY_L, DM_CHUNK_BYTES * 4);
+
+            for (v = 0; v < voices; v++) {
+                /* Decode enough whole frames to cover this chunk at pitch */
+                start = (s32)(pos[v] >> 16) & ~(ADPCMFSIZE - 1);
+                need = (s32)((pos[v] + (u32)BENCH_CHUNK * (pitch[v] << 1)) >> 16) + 1 - start;
+                nframes = (need + ADPCMFSIZE - 1) / ADPCMFSIZE;
+                start = (start / ADPCMFSIZE) % (BENCH_SAMPLE_FRAMES - 32);
+
+                aSetBuffer(a++, 0, DM_ADPCM_IN, 0, nframes * 9);
+                aLoadBuffer(a++, BENCH_ADDR(&sBench.sample[start * 9]));
+                aSetBuffer(a++, 0, DM_ADPCM_IN, DM_DECODE_OUT, nframes * ADPCMFSIZE * 2);
+                aADPCMdec(a++, A_INIT, BENCH_ADDR(sBench.adpcm_state[v]));
+
+                aSetBuffer(a++, 0, DM_DECODE_OUT + ((pos[v] >> 16) & (ADPCMFSIZE - 1)) * 2,
+                           DM_RESAMPLE_OUT, DM_CHUNK_BYTES);
+                aResample(a++, first && ch == 0 ? A_INIT : 0, pitch[v],
+                          BENCH_ADDR(sBench.resample_state[v]));
+                pos[v] += (u32)BENCH_CHUNK * (pitch[v] << 1);
+                pos[v] = (pos[v] & 0xFFFF) | ((pos[v] >> 16) % ((BENCH_SAMPLE_FRAMES - 64) * ADPCMFSIZE) << 16);
+
+                aSetBuffer(a++, 0, DM_RESAMPLE_OUT, DM_DRY_L, DM_CHUNK_BYTES);
+                aSetBuffer(a++, A_AUX, DM_DRY_R, DM_WET_L, DM_WET_R);
+                aSetVolume(a++, A_LEFT | A_VOL, 0x7FFF * (v + 1) / (voices + 1), 0, 0);
+                aSetVolume(a++, A_RIGHT | A_VOL, 0x7FFF * (voices - v) / (voices + 1), 0, 0);
+                aSetVolume(a++, A_LEFT | A_RATE, 0x6000, 0, 0x40);
+                aSetVolume(a++, A_RIGHT | A_RATE, 0x6000, 0, 0x40);
+                aSetVolume(a++, A_AUX, 0x7FFF / voices, 0x2000 / voices, 0);
+                aEnvMixer(a++, (first && ch == 0 ? A_INIT : 0) | A_AUX,
+                          BENCH_ADDR(sBench.env_state[v]));
+            }
+
+            /* Reverb: damp the wet bus into the delay line, mix the tap back */
+            n = DM_CHUNK_BYTES / 2;
+            aSetBuffer(a++, 0, DM_REVERB, DM_REVERB, DM_CHUNK_BYTES);
+            aLoadBuffer(a++, BENCH_ADDR(&sBench.delay[delay_pos]));
+            aMix(a++, 0, 0x3000, DM_REVERB, DM_DRY_L);
+            aMix(a++, 0, 0x3000, DM_REVERB, DM_DRY_R);
+            aMix(a++, 0, 0x7FFF, DM_WET_R, DM_WET_L);
+            aMix(a++, 0, 0x4000, DM_REVERB, DM_WET_L);
+            aSetBuffer(a++, 0, DM_WET_L, DM_REVERB, DM_CHUNK_BYTES);
+            aPoleFilter(a++, first && ch == 0 ? A_INIT : 0, 0x5000,
+                        BENCH_ADDR(sBench.polef_state));
+            aSaveBuffer(a++, BENCH_ADDR(&sBench.delay[delay_pos]));
+            delay_pos = (delay_pos + n) % (BENCH_DELAY - BENCH_CHUNK);
+
+            /* Interleave to the AI buffer */
+            aSetBuffer(a++, 0, 0, DM_OUT, DM_CHUNK_BYTES);
+            aInterleave(a++, DM_DRY_L, DM_DRY_R);
+            aSetBuffer(a++, 0, 0, DM_OUT, DM_CHUNK_BYTES * 2);
+            aSaveBuffer(a++, BENCH_ADDR(&sBench.out[ch * 2]));
+        }
+
+        __osHostAudioRun(sBenchCmds, (s32)(a - sBenchCmds));
+        osAiSetNextBuffer(sBench.out, sizeof(sBench.out));
+    }
+
+    if (wav_path != NULL) {
+        __osHostAudioStopRecord();
+    }
+
+    if (sStats.voice_frames_total == 0) {
+        return 0;
+    }
+    return (u32)(sStats.ns_total / sStats.voice_frames_total);
+}
+
+#endif /* HOST_BUILD */
@@ -0,0 +1,132 @@
+/**
+ * @file os_host_pi.c
+ * @brief Host PI DMA served from a cartridge image file
+ *
+ * Host-only replacement for os_pi_dma.c, compiled when HOST_BUILD is
+ * defined. __osHostRomOpen() reads a ROM image into memory and
+ * osPiStartDma() copies from it, so loaders that stream from the
+ * cartridge run unchanged against a real image.
+ *
+ * A request completes before osPiStartDma() returns: the copy is done and
+ * the OSIoMesg is posted to its queue, the way the PI manager posts it
+ * once the hardware finishes. Reads past the end of the image are zero
+ * filled, like open bus on a short cartridge.
+ */
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "PR/os_pi.h"
+
+static u8 *sHostRom;
+static u32 sHostRomSize;
+static OSHostPiStats sHostPiStats;
+
+/**
+ * Load a cartridge image for osPiStartDma
+ *
+ * @param path ROM image (big-endian .z64)
+ * @return Image size in bytes, or 0 if it could not be read
+ */
+u32 __osHostRomOpen(const char *path) {
+    FILE *f;
+    long size;
+
+    __osHostRomClose();
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if (size > 0) {
+        sHostRom = (u8 *)malloc((size_t)size);
+    }
+    if (sHostRom == NULL || fread(sHostRom, 1, (size_t)size, f) != (size_t)size) {
+        fclose(f);
+        __osHostRomClose();
+        return 0;
+    }
+    fclose(f);
+
+    sHostRomSize = (u32)size;
+    return sHostRomSize;
+}
+
+/**
+ * Release the loaded image
+ */
+void __osHostRomClose(void) {
+    free(sHostRom);
+    sHostRom = NULL;
+    sHostRomSize = 0;
+}
+
+/**
+ * Start (and finish) a PI DMA transfer against the loaded image
+ *
+ * Same contract as os_pi_dma.c. Writes to the cartridge are accepted
+ * and dropped.
+ *
+ * @return 0 on success, -1 if no image is loaded
+ */
+s32 osPiStartDma(OSIoMesg *mb, s32 priority, s32 direction,
+                 u32 devAddr, void *dramAddr, u32 size, OSMesgQueue *mq) {
+    u32 avail;
+
+    if (sHostRom == NULL) {
+        return -1;
+    }
+
+    if (mb != NULL) {
+        mb->hdr.type = (direction == OS_READ) ? OS_MESG_TYPE_DMAREAD
+                                              : OS_MESG_TYPE_DMAWRITE;
+        mb->hdr.pri = (u8)priority;
+        mb->hdr.status = 0;
+        mb->hdr.retQueue = mq;
+        mb->dramAddr = dramAddr;
+        mb->devAddr = devAddr;
+        mb->size = size;
+        mb->piHandle = NULL;
+    }
+
+    if (direction == OS_READ) {
+        /* Cartridge domain addresses map onto the image */
+        devAddr &= 0x0FFFFFFF;
+        avail = (devAddr < sHostRomSize) ? sHostRomSize - devAddr : 0;
+        if (avail > size) {
+            avail = size;
+        }
+        memcpy(dramAddr, sHostRom + devAddr, avail);
+        memset((u8 *)dramAddr + avail, 0, size - avail);
+        sHostPiStats.bytes += size;
+    }
+    sHostPiStats.requests++;
+
+    if (mq != NULL) {
+        osSendMesg(mq, (OSMesg)mb, OS_MESG_NOBLOCK);
+    }
+    return 0;
+}
+
+/**
+ * Transfer counters since the last reset
+ */
+OSHostPiStats *__osHostPiGetStats(s32 reset) {
+    static OSHostPiStats snap;
+
+    snap = sHostPiStats;
+    if (reset) {
+        memset(&sHostPiStats, 0, sizeof(sHostPiStats));
+    }
+    return &snap;
+}
+
+#endif /* HOST_BUILD */
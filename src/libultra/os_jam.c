@@ -10,6 +10,9 @@
 #include "PR/os_message.h"
 #include "PR/os_thread.h"
 
+/* Host builds use the pthread backend in os_host.c */
+#ifndef HOST_BUILD
+
 /* External functions */
 extern s32 __osDisableInt(void);
 extern void __osRestoreInt(s32 mask);
@@ -65,3 +68,5 @@ s32 osJamMesg(OSMesgQueue *mq, void *msg, s32 flags) {
     __osRestoreInt(savedMask);
     return 0;
 }
+
+#endif /* HOST_BUILD */
@@ -9,6 +9,9 @@
 #include "PR/os_thread.h"
 #include "PR/os_message.h"
 
+/* Host builds use the pthread backend in os_host.c */
+#ifndef HOST_BUILD
+
 /* External functions */
 extern s32 __osDisableInt(void);
 extern void __osRestoreInt(s32 mask);
@@ -89,3 +92,5 @@ void __osSetThreadMesgQueue(OSMesgQueue *mq) {
 
     __osRestoreInt(saved);
 }
+
+#endif /* HOST_BUILD */
@@ -8,6 +8,9 @@
 #include "PR/os_message.h"
 #include "PR/os_thread.h"
 
+/* Host builds use the pthread backend in os_host.c */
+#ifndef HOST_BUILD
+
 /* Empty thread queue sentinel */
 extern OSThread *__osThreadQueue;
 
@@ -109,3 +112,5 @@ s32 osRecvMesg(OSMesgQueue *mq, OSMesg *msg, s32 flags) {
     __osRestoreInt(savedMask);
     return 0;
 }
+
+#endif /* HOST_BUILD */
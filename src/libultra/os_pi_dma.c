@@ -11,6 +11,9 @@
 #include "types.h"
 #include "PR/os_pi.h"
 
+/* Host builds use os_host_pi.c */
+#ifndef HOST_BUILD
+
 /* External data (standard libultra name) */
 extern s32 __osPiInitialized;   /* PI initialized flag: 0x8002C380 */
 
@@ -71,3 +74,5 @@ s32 osPiStartDma(OSIoMesg *mb, s32 priority, s32 direction,
 
     return result;
 }
+
+#endif /* HOST_BUILD */
@@ -9,6 +9,8 @@
 #include "types.h"
 #include "PR/os_thread.h"
 #include "PR/os_message.h"
+#include "PR/os_sctrace.h"
+#include "PR/os_sched.h"
 
 /* OS Event types for osSetEventMesg */
 #define OS_EVENT_SW1        0   /* Software interrupt 1 */
@@ -74,6 +76,14 @@ extern s32 __osScDeadlineCount;         /* Deadline frame count */
 extern s32 __osScStartCount;            /* Start frame count */
 extern s32 __osScLastCount;             /* Last frame count */
 
+/* Deadline policy hook (new code; compiled out of matching builds) */
+#if defined(NON_MATCHING) || defined(HOST_BUILD)
+static void __scDeadlineUpdate(u32 frameTicks);
+#define SC_DEADLINE_UPDATE(ticks)   __scDeadlineUpdate(ticks)
+#else
+#define SC_DEADLINE_UPDATE(ticks)
+#endif
+
 /* Forward declarations */
 static void __scMain(void *sc);
 static void __scSchedule(void *sc);
@@ -265,6 +275,7 @@ static void __scMain(void *arg) {
                     break;
 
                 case 1:  /* SC_MSG_RETRACE - VI Retrace */
+                    SC_TRACE(SC_TRACE_RETRACE, SC_TRACE_INSTANT, SC_TRACK_SCHED);
                     *(s64 *)&__osScRetraceTimeLo = osGetCount();
                     __scHandleRetrace(sc);
                     __scSchedule(sc);
@@ -276,6 +287,7 @@ static void __scMain(void *arg) {
 
                 case 3:  /* SC_MSG_RDP_DONE - RDP done */
                     __osScFrameTime = osGetCount() - *(s64 *)&__osScRetraceTimeLo;
+                    SC_DEADLINE_UPDATE((u32)__osScFrameTime);
                     __scHandleRDP(sc);
                     break;
 
@@ -380,6 +392,9 @@ static void __scHandleRSP(void *arg) {
     task = *(void **)(sc + SCHED_CUR_RSP_TASK);
     *(void **)(sc + SCHED_CUR_RSP_TASK) = NULL;
 
+    SC_TRACE(*(s32 *)((u8 *)task + TASK_TYPE) == SC_TASK_AUDIO ?
+             SC_TRACE_AUDIO_TASK : SC_TRACE_GFX_TASK, SC_TRACE_END, SC_TRACK_RSP);
+
     /* Check if task yielded and has pending work */
     if ((*(s32 *)((u8 *)task + TASK_STATE) & SC_TASK_YIELD_REQ) &&
         osSpTaskYielded((u8 *)task + TASK_TYPE) != 0) {
@@ -432,6 +447,7 @@ static void __scHandleRDP(void *arg) {
 
     task = *(void **)(sc + SCHED_CUR_RDP_TASK);
     *(void **)(sc + SCHED_CUR_RDP_TASK) = NULL;
+    SC_TRACE(SC_TRACE_RDP, SC_TRACE_END, SC_TRACK_RDP);
 
     /* Clear RDP busy flag */
     *(s32 *)((u8 *)task + TASK_STATE) &= ~SC_TASK_RDP_BUSY;
@@ -572,6 +588,8 @@ static void __scExec(void *arg, void *rspTask, void *rdpTask) {
         return;
     }
 
+    SC_TRACE(SC_TRACE_EXEC, SC_TRACE_INSTANT, SC_TRACK_SCHED);
+
     if (rspTask != NULL) {
         /* Audio task */
         if (*(s32 *)(rsp + TASK_TYPE) == SC_TASK_AUDIO) {
@@ -585,17 +603,21 @@ static void __scExec(void *arg, void *rspTask, void *rdpTask) {
         /* Clear SP status and load task */
         osSpClearStatus();
         *(s32 *)(rsp + TASK_STATE) &= ~(SC_TASK_YIELD_REQ | SC_TASK_YIELDED);
+        SC_TRACE(*(s32 *)(rsp + TASK_TYPE) == SC_TASK_AUDIO ?
+                 SC_TRACE_AUDIO_TASK : SC_TRACE_GFX_TASK, SC_TRACE_BEGIN, SC_TRACK_RSP);
         osSpTaskLoad(rsp + TASK_TYPE);
         osSpTaskStartGo(rsp + TASK_TYPE);
 
         *(void **)(sc + SCHED_CUR_RSP_TASK) = rspTask;
         if (rspTask == rdpTask) {
+            SC_TRACE(SC_TRACE_RDP, SC_TRACE_BEGIN, SC_TRACK_RDP);
             *(void **)(sc + SCHED_CUR_RDP_TASK) = rdpTask;
         }
     }
 
     /* Set up RDP if different task */
     if (rdpTask != NULL && rdpTask != rspTask) {
+        SC_TRACE(SC_TRACE_RDP, SC_TRACE_BEGIN, SC_TRACK_RDP);
         osDpSetNextBuffer(*(void **)(rdp + TASK_RDP_BUFFER), 0);
         *(void **)(sc + SCHED_CUR_RDP_TASK) = rdpTask;
     }
@@ -614,6 +636,7 @@ static void __scYield(void *arg) {
         task = *(u8 **)(sc + SCHED_CUR_RSP_TASK);
         /* Set yield request flag */
         *(s32 *)(task + TASK_STATE) |= SC_TASK_YIELD_REQ;
+        SC_TRACE(SC_TRACE_YIELD, SC_TRACE_INSTANT, SC_TRACK_RSP);
         osSpTaskYield();
     }
 }
@@ -763,3 +786,94 @@ s32 osScDeadlinePassed(void) {
 void osScStub(void) {
     /* Empty */
 }
+
+#if defined(NON_MATCHING) || defined(HOST_BUILD)
+
+/*
+ * ==========================================================================
+ * Deadline policy
+ * ==========================================================================
+ *
+ * Runs once per graphics frame at RDP-done. The prediction is the larger
+ * of the smoothed and the last frame time, so it reacts to a spike at
+ * once but only relaxes as the average comes down. Pressure rises one
+ * level per frame while the prediction sits above the raise mark and
+ * falls one level after a run of calm frames, so quality does not
+ * oscillate at the boundary.
+ */
+
+static OSScFrameStats sScFrameStats = {
+    0, 0, 0, 0, OS_SC_BUDGET_60HZ, 0, 0, 0, 0, OS_SC_PRESSURE_NONE, 0
+};
+static OSScPressureFunc sScPressureFunc;
+
+/**
+ * Set the per-frame RDP budget (e.g. two fields for 30 fps split screen)
+ * @param ticks Budget in osGetCount() ticks
+ */
+void osScSetFrameBudget(u32 ticks) {
+    sScFrameStats.budget_ticks = ticks;
+}
+
+/**
+ * Register the client notified on pressure level changes
+ */
+void osScSetPressureCallback(OSScPressureFunc func) {
+    sScPressureFunc = func;
+}
+
+OSScFrameStats *osScGetFrameStats(void) {
+    return &sScFrameStats;
+}
+
+/**
+ * Fold one frame's RDP time into the prediction and act on it
+ * @param frameTicks Retrace→RDP-done time for the frame just finished
+ */
+static void __scDeadlineUpdate(u32 frameTicks) {
+    OSScFrameStats *st = &sScFrameStats;
+    u32 budget = st->budget_ticks;
+    u32 predicted;
+    s32 level = st->level;
+
+    st->frames++;
+    st->last_ticks = frameTicks;
+    if (st->frames == 1) {
+        st->avg_ticks = frameTicks;
+    } else {
+        st->avg_ticks = st->avg_ticks - (st->avg_ticks >> 2) + (frameTicks >> 2);
+    }
+
+    predicted = st->avg_ticks > frameTicks ? st->avg_ticks : frameTicks;
+    st->predicted_ticks = predicted;
+
+    if (frameTicks > budget) {
+        st->missed++;
+    }
+
+    if (predicted > (budget >> 4) * OS_SC_RAISE_16THS) {
+        st->predicted_over++;
+        st->calm_frames = 0;
+        if (level < OS_SC_PRESSURE_CRITICAL) {
+            level++;
+            st->raises++;
+        }
+    } else if (predicted < (budget >> 4) * OS_SC_LOWER_16THS) {
+        if (++st->calm_frames >= OS_SC_LOWER_FRAMES && level > OS_SC_PRESSURE_NONE) {
+            level--;
+            st->lowers++;
+            st->calm_frames = 0;
+        }
+    } else {
+        st->calm_frames = 0;
+    }
+
+    if (level != st->level) {
+        st->level = level;
+        if (sScPressureFunc != NULL) {
+            sScPressureFunc(level, predicted, budget);
+        }
+    }
+}
+
+#endif /* NON_MATCHING || HOST_BUILD */
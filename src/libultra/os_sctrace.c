@@ -0,0 +1,324 @@
+/**
+ * @file os_sctrace.c
+ * @brief Scheduler timeline profiler
+ *
+ * Records scheduler and game-thread events into a fixed ring and exports
+ * them as Chrome trace-event JSON. Recording is one interrupt-masked
+ * slot claim plus an 8-byte store, so it is cheap enough to leave wired
+ * into the scheduler; the ring is only walked on export.
+ *
+ * Timestamps are raw osGetCount() ticks (CPU clock / 2 = 46.875 MHz).
+ * Export unwraps the 32-bit counter event-to-event, so spans are correct
+ * as long as no two consecutive events are more than ~91 s apart.
+ */
+
+#include "types.h"
+#include "PR/os_thread.h"
+#include "PR/os_sctrace.h"
+
+extern u32 osGetCount(void);
+extern s32 __osDisableInt(void);
+extern void __osRestoreInt(s32 mask);
+
+OSScTrace __osScTrace;
+
+static const char *sKindNames[] = {
+    "gfx", "audio", "rdp", "yield", "retrace", "exec", "marker"
+};
+
+static const char *sTrackNames[] = {
+    "scheduler", "RSP", "RDP"
+};
+
+static const char sThreadLabel[] = "thread ";
+
+static const char *sMarkerNames[SC_TRACE_MAX_MARKERS] = {
+    "game_frame", "game_loop"
+};
+
+/*
+ * ==========================================================================
+ * Recording
+ * ==========================================================================
+ */
+
+void osScTraceEnable(s32 enable) {
+    __osScTrace.enabled = enable;
+}
+
+void osScTraceReset(void) {
+    s32 saved;
+
+    saved = __osDisableInt();
+    __osScTrace.head = 0;
+    __osRestoreInt(saved);
+}
+
+/**
+ * Append one event to the ring
+ * @param kind SC_TRACE_* kind
+ * @param phase SC_TRACE_BEGIN, SC_TRACE_END or SC_TRACE_INSTANT
+ * @param track SC_TRACK_* row
+ * @param id Marker id (0 for scheduler events)
+ */
+void osScTraceRecord(s32 kind, s32 phase, s32 track, s32 id) {
+    OSScTraceEvent *ev;
+    s32 saved;
+
+    if (!__osScTrace.enabled) {
+        return;
+    }
+
+    saved = __osDisableInt();
+    ev = &__osScTrace.events[__osScTrace.head & (SC_TRACE_MAX_EVENTS - 1)];
+    __osScTrace.head++;
+    ev->count = osGetCount();
+    ev->kind = (u8)kind;
+    ev->phase = (u8)phase;
+    ev->track = (u8)track;
+    ev->id = (u8)id;
+    __osRestoreInt(saved);
+}
+
+void osScTraceSetMarkerName(s32 id, const char *name) {
+    if (id >= 0 && id < SC_TRACE_MAX_MARKERS) {
+        sMarkerNames[id] = name;
+    }
+}
+
+/**
+ * Open a marker span on the calling thread's row
+ */
+void osScTraceBegin(s32 marker) {
+    osScTraceRecord(SC_TRACE_MARKER, SC_TRACE_BEGIN,
+                    SC_TRACK_THREAD + osGetThreadId(NULL), marker);
+}
+
+/**
+ * Close a marker span on the calling thread's row
+ */
+void osScTraceEnd(s32 marker) {
+    osScTraceRecord(SC_TRACE_MARKER, SC_TRACE_END,
+                    SC_TRACK_THREAD + osGetThreadId(NULL), marker);
+}
+
+/*
+ * ==========================================================================
+ * Chrome trace export
+ * ==========================================================================
+ */
+
+/* Output cursor; always leaves room for the closing "]}\n" */
+typedef struct TraceWriter {
+    char    *buf;
+    s32     len;
+    s32     size;
+    s32     full;
+} TraceWriter;
+
+#define TRACE_TAIL_RESERVE  4
+
+static void tw_puts(TraceWriter *w, const char *s) {
+    while (*s != '\0') {
+        if (w->len >= w->size - TRACE_TAIL_RESERVE) {
+            w->full = 1;
+            return;
+        }
+        w->buf[w->len++] = *s++;
+    }
+}
+
+static void tw_putu(TraceWriter *w, u32 v, s32 min_digits) {
+    char tmp[12];
+    s32 n = 0;
+
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0 || n < min_digits);
+
+    while (n > 0 && !w->full) {
+        char c[2];
+        c[0] = tmp[--n];
+        c[1] = '\0';
+        tw_puts(w, c);
+    }
+}
+
+/**
+ * Write one trace event object
+ * @param ns Event time in nanoseconds since the first exported event
+ */
+static void tw_event(TraceWriter *w, const OSScTraceEvent *ev, u64 ns, s32 first) {
+    char ph[2];
+    const char *name;
+    s32 mark;
+    s32 save_len = w->len;
+
+    if (ev->kind == SC_TRACE_MARKER) {
+        mark = ev->id < SC_TRACE_MAX_MARKERS ? ev->id : 0;
+        name = sMarkerNames[mark] != NULL ? sMarkerNames[mark] : "marker";
+    } else {
+        name = sKindNames[ev->kind <= SC_TRACE_MARKER ? ev->kind : SC_TRACE_MARKER];
+    }
+    ph[0] = (char)ev->phase;
+    ph[1] = '\0';
+
+    tw_puts(w, first ? "\n{\"name\":\"" : ",\n{\"name\":\"");
+    tw_puts(w, name);
+    tw_puts(w, "\",\"ph\":\"");
+    tw_puts(w, ph);
+    tw_puts(w, "\",\"ts\":");
+    tw_putu(w, (u32)(ns / 1000), 1);
+    tw_puts(w, ".");
+    tw_putu(w, (u32)(ns % 1000), 3);
+    tw_puts(w, ",\"pid\":0,\"tid\":");
+    tw_putu(w, ev->track, 1);
+    if (ev->phase == SC_TRACE_INSTANT) {
+        tw_puts(w, ",\"s\":\"t\"");
+    }
+    tw_puts(w, "}");
+
+    /* Never leave a half-written object behind */
+    if (w->full) {
+        w->len = save_len;
+    }
+}
+
+/**
+ * Write a thread_name metadata record so rows get readable labels
+ */
+static void tw_track_name(TraceWriter *w, s32 track, const char *name, s32 first) {
+    s32 save_len = w->len;
+
+    tw_puts(w, first ? "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+                     : ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":");
+    tw_putu(w, (u32)track, 1);
+    tw_puts(w, ",\"args\":{\"name\":\"");
+    tw_puts(w, name);
+    tw_puts(w, "\"}}");
+
+    /* Never leave a half-written object behind */
+    if (w->full) {
+        w->len = save_len;
+    }
+}
+
+/**
+ * Export the ring as Chrome trace-event JSON
+ *
+ * Oldest surviving event is time zero. If the buffer is too small the
+ * newest events are dropped, but the output is always valid JSON.
+ *
+ * @param buf Output buffer
+ * @param size Buffer size in bytes
+ * @return Bytes written (excluding NUL), or -1 if size is too small
+ */
+s32 osScTraceExport(char *buf, s32 size) {
+    TraceWriter w;
+    OSScTraceEvent *ev;
+    u32 head, start, i, prev;
+    u64 ticks;
+    s32 saved, was_enabled, first, n;
+    u32 threads;
+    char label[12];
+
+    if (buf == NULL || size < 64) {
+        return -1;
+    }
+
+    /* Freeze recording while walking the ring */
+    saved = __osDisableInt();
+    was_enabled = __osScTrace.enabled;
+    __osScTrace.enabled = 0;
+    head = __osScTrace.head;
+    __osRestoreInt(saved);
+
+    w.buf = buf;
+    w.len = 0;
+    w.size = size;
+    w.full = 0;
+
+    tw_puts(&w, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    start = head > SC_TRACE_MAX_EVENTS ? head - SC_TRACE_MAX_EVENTS : 0;
+    ticks = 0;
+    prev = 0;
+    threads = 0;
+    first = 1;
+    for (i = start; i < head && !w.full; i++) {
+        ev = &__osScTrace.events[i & (SC_TRACE_MAX_EVENTS - 1)];
+        if (i != start) {
+            ticks += (u32)(ev->count - prev);
+        }
+        prev = ev->count;
+        if (ev->track >= SC_TRACK_THREAD && ev->track < SC_TRACK_THREAD + 32) {
+            threads |= 1u << (ev->track - SC_TRACK_THREAD);
+        }
+
+        /* 46.875 MHz: 1 tick = 64/3 ns */
+        tw_event(&w, ev, (ticks * 64) / 3, first);
+        first = 0;
+    }
+
+    for (i = 0; i < 3 && !w.full; i++) {
+        tw_track_name(&w, (s32)i, sTrackNames[i], first);
+        first = 0;
+    }
+
+    /* Marker rows are named after the OSThread id that recorded them */
+    for (i = 0; i < 32 && !w.full; i++) {
+        if (threads & (1u << i)) {
+            n = 0;
+            while (sThreadLabel[n] != '\0') {
+                label[n] = sThreadLabel[n];
+                n++;
+            }
+            if (i >= 10) {
+                label[n++] = (char)('0' + i / 10);
+            }
+            label[n++] = (char)('0' + i % 10);
+            label[n] = '\0';
+            tw_track_name(&w, SC_TRACK_THREAD + (s32)i, label, first);
+            first = 0;
+        }
+    }
+
+    /* Reserved space guarantees the terminator fits */
+    buf[w.len++] = ']';
+    buf[w.len++] = '}';
+    buf[w.len++] = '\n';
+    buf[w.len] = '\0';
+
+    __osScTrace.enabled = was_enabled;
+    return w.len;
+}
+
+#ifdef HOST_BUILD
+
+#include <stdio.h>
+
+/**
+ * Export the ring straight to a file (host only)
+ * @return Bytes written, or -1 on failure
+ */
+s32 osScTraceWriteFile(const char *path) {
+    static char sExportBuf[SC_TRACE_MAX_EVENTS * 96 + 1024];
+    FILE *fp;
+    s32 len;
+
+    len = osScTraceExport(sExportBuf, sizeof(sExportBuf));
+    if (len < 0) {
+        return -1;
+    }
+
+    fp = fopen(path, "w");
+    if (fp == NULL) {
+        return -1;
+    }
+    fwrite(sExportBuf, 1, (u32)len, fp);
+    fclose(fp);
+    return len;
+}
+
+#endif /* HOST_BUILD */
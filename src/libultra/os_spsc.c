@@ -0,0 +1,235 @@
+/**
+ * @file os_spsc.c
+ * @brief Single-producer/single-consumer message queue
+ *
+ * Fast-path alternative to OSMesgQueue for a fixed pair of threads.
+ * Capacity must be a power of two so indexing is a mask rather than the
+ * % msgCount used by osSendMesg/osRecvMesg. Send and receive touch only
+ * their own index and never disable interrupts; a side falls back to a
+ * blocking osRecvMesg on its bell queue only when the ring is empty
+ * (receiver) or full (sender).
+ *
+ * Queues fed from interrupt context via osSetEventMesg or PI DMA must
+ * stay OSMesgQueues, since the OS posts to those directly.
+ */
+
+#include "types.h"
+#include "PR/os_message.h"
+
+/*
+ * Index publication. On the single N64 CPU, volatile access order is all
+ * that is needed. Host builds may run the two sides on different cores:
+ * indices are read with acquire and published with a sequentially
+ * consistent exchange, which also orders the following read of the other
+ * side's waiting flag (the store→load pair that decides whether to ring
+ * a bell). The slow path's flag store gets an explicit fence.
+ */
+#ifdef HOST_BUILD
+#define SPSC_LOAD(v)        __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define SPSC_PUBLISH(v, x)  ((void)__atomic_exchange_n(&(v), (x), __ATOMIC_SEQ_CST))
+#define SPSC_FENCE()        __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define SPSC_LOAD(v)        (v)
+#define SPSC_PUBLISH(v, x)  ((v) = (x))
+#define SPSC_FENCE()
+#endif
+
+/**
+ * Initialize an SPSC queue
+ * @param q Queue to initialize
+ * @param msg Message buffer array
+ * @param count Capacity, must be a power of two
+ * @return 0 on success, -1 if count is not a power of two
+ */
+s32 osCreateSpscQueue(OSSpscQueue *q, OSMesg *msg, s32 count) {
+    if (count <= 0 || (count & (count - 1)) != 0) {
+        return -1;
+    }
+
+    q->head = 0;
+    q->tail = 0;
+    q->mask = (u32)count - 1;
+    q->msg = msg;
+    q->recvWaiting = 0;
+    q->sendWaiting = 0;
+
+    osCreateMesgQueue(&q->recvBell, q->recvBellBuf, 1);
+    osCreateMesgQueue(&q->sendBell, q->sendBellBuf, 1);
+    return 0;
+}
+
+/**
+ * Send a message (producer side only)
+ * @param q SPSC queue
+ * @param msg Message to send
+ * @param flags OS_MESG_NOBLOCK or OS_MESG_BLOCK
+ * @return 0 on success, -1 if queue full and non-blocking
+ */
+s32 osSpscSend(OSSpscQueue *q, OSMesg msg, s32 flags) {
+    u32 tail = q->tail;
+
+    while (tail - SPSC_LOAD(q->head) > q->mask) {
+        if (flags == OS_MESG_NOBLOCK) {
+            return -1;
+        }
+
+        /* Announce, then re-check so a pop in between is not missed */
+        q->sendWaiting = 1;
+        SPSC_FENCE();
+        if (tail - SPSC_LOAD(q->head) <= q->mask) {
+            q->sendWaiting = 0;
+            break;
+        }
+        osRecvMesg(&q->sendBell, NULL, OS_MESG_BLOCK);
+        q->sendWaiting = 0;
+    }
+
+    ((OSMesg volatile *)q->msg)[tail & q->mask] = msg;
+    SPSC_PUBLISH(q->tail, tail + 1);
+
+    if (q->recvWaiting) {
+        /* A stale bell only costs the receiver one extra re-check */
+        osSendMesg(&q->recvBell, NULL, OS_MESG_NOBLOCK);
+    }
+    return 0;
+}
+
+/**
+ * Receive a message (consumer side only)
+ * @param q SPSC queue
+ * @param msg Pointer to store received message (can be NULL)
+ * @param flags OS_MESG_NOBLOCK or OS_MESG_BLOCK
+ * @return 0 on success, -1 if queue empty and non-blocking
+ */
+s32 osSpscRecv(OSSpscQueue *q, OSMesg *msg, s32 flags) {
+    u32 head = q->head;
+
+    while (SPSC_LOAD(q->tail) == head) {
+        if (flags == OS_MESG_NOBLOCK) {
+            return -1;
+        }
+
+        q->recvWaiting = 1;
+        SPSC_FENCE();
+        if (SPSC_LOAD(q->tail) != head) {
+            q->recvWaiting = 0;
+            break;
+        }
+        osRecvMesg(&q->recvBell, NULL, OS_MESG_BLOCK);
+        q->recvWaiting = 0;
+    }
+
+    if (msg != NULL) {
+        *msg = ((OSMesg volatile *)q->msg)[head & q->mask];
+    }
+    SPSC_PUBLISH(q->head, head + 1);
+
+    if (q->sendWaiting) {
+        osSendMesg(&q->sendBell, NULL, OS_MESG_NOBLOCK);
+    }
+    return 0;
+}
+
+#ifdef HOST_BUILD
+
+#include <time.h>
+
+#define BENCH_QUEUE_SIZE    64
+
+static OSThread sBenchProducer;
+static OSMesgQueue sBenchQueue;
+static OSSpscQueue sBenchSpsc;
+static OSMesg sBenchBuf[BENCH_QUEUE_SIZE];
+static s32 sBenchCount;
+
+static void bench_produce_mq(void *arg) {
+    s32 i;
+
+    for (i = 1; i <= sBenchCount; i++) {
+        osSendMesg(&sBenchQueue, (OSMesg)(intptr_t)i, OS_MESG_BLOCK);
+    }
+}
+
+static void bench_produce_spsc(void *arg) {
+    s32 i;
+
+    for (i = 1; i <= sBenchCount; i++) {
+        osSpscSend(&sBenchSpsc, (OSMesg)(intptr_t)i, OS_MESG_BLOCK);
+    }
+}
+
+/**
+ * Measure message throughput
+ *
+ * Threaded mode streams from a producer thread to the caller, so the
+ * figure includes sleep/wake costs when the ring runs empty or full.
+ * Unthreaded mode fills and drains the ring from the caller alone with
+ * OS_MESG_NOBLOCK, which isolates the per-message fast-path cost.
+ * Run it after any thread has been started: glibc skips the mutex atomics
+ * while a process is still single-threaded, which flatters OSMesgQueue.
+ *
+ * @param count Messages to send
+ * @param use_spsc 0 = OSMesgQueue, 1 = OSSpscQueue (same capacity)
+ * @param threaded Use a separate producer thread
+ * @return Messages per second received
+ */
+u32 __osHostMesgThroughput(s32 count, s32 use_spsc, s32 threaded) {
+    struct timespec t0, t1;
+    OSMesg msg;
+    s64 elapsed;
+    s32 i, j;
+
+    if (count <= 0) {
+        return 0;
+    }
+    sBenchCount = count;
+
+    if (use_spsc) {
+        osCreateSpscQueue(&sBenchSpsc, sBenchBuf, BENCH_QUEUE_SIZE);
+    } else {
+        osCreateMesgQueue(&sBenchQueue, sBenchBuf, BENCH_QUEUE_SIZE);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    if (threaded) {
+        osCreateThread(&sBenchProducer, 98, use_spsc ? bench_produce_spsc : bench_produce_mq,
+                       NULL, NULL, OS_PRIORITY_APPMAX);
+        osStartThread(&sBenchProducer);
+        for (i = 0; i < count; i++) {
+            if (use_spsc) {
+                osSpscRecv(&sBenchSpsc, &msg, OS_MESG_BLOCK);
+            } else {
+                osRecvMesg(&sBenchQueue, &msg, OS_MESG_BLOCK);
+            }
+        }
+    } else {
+        for (i = 0; i < count; i += BENCH_QUEUE_SIZE) {
+            for (j = 0; j < BENCH_QUEUE_SIZE; j++) {
+                if (use_spsc) {
+                    osSpscSend(&sBenchSpsc, (OSMesg)(intptr_t)j, OS_MESG_NOBLOCK);
+                } else {
+                    osSendMesg(&sBenchQueue, (OSMesg)(intptr_t)j, OS_MESG_NOBLOCK);
+                }
+            }
+            for (j = 0; j < BENCH_QUEUE_SIZE; j++) {
+                if (use_spsc) {
+                    osSpscRecv(&sBenchSpsc, &msg, OS_MESG_NOBLOCK);
+                } else {
+                    osRecvMesg(&sBenchQueue, &msg, OS_MESG_NOBLOCK);
+                }
+            }
+        }
+        count = i;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    elapsed = (s64)(t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec);
+    if (elapsed <= 0) {
+        elapsed = 1;
+    }
+    return (u32)(((s64)count * 1000000000LL) / elapsed);
+}
+
+#endif /* HOST_BUILD */
@@ -10,6 +10,9 @@
 #include "PR/os_thread.h"
 #include "PR/os_message.h"
 
+/* Host builds use the pthread backend in os_host.c */
+#ifndef HOST_BUILD
+
 /* External functions */
 extern s32 __osDisableInt(void);
 extern void __osRestoreInt(s32 mask);
@@ -293,3 +296,5 @@ OSId osGetThreadId(OSThread *thread) {
     }
     return t->id;
 }
+
+#endif /* HOST_BUILD */
@@ -18,6 +18,9 @@ extern OSTimer *__osTimerList;  /* 0x8002C3F0 */
 /* External functions */
 extern OSTime __osInsertTimer(OSTimer *timer);          /* 0x8000C308 */
 extern void __osSetCompare(u32 hi, u32 lo);             /* 0x8000C294 */
+#ifdef NON_MATCHING
+extern void dll_insert(OSTimer *timer);                 /* dll.c heap queue */
+#endif
 
 /**
  * Initialize and start a timer
@@ -56,6 +59,14 @@ s32 osSetTimer(OSTimer *timer, OSTime countdown, OSTime interval,
     timer->mq = mq;
     timer->msg = msg;
 
+#ifdef NON_MATCHING
+    /*
+     * The heap queue takes value as a countdown and reprograms Compare
+     * itself when the timer becomes the earliest; it keeps no
+     * __osTimerList chain and returns no deadline to test here.
+     */
+    dll_insert(timer);
+#else
     /* Insert timer into sorted list */
     result = __osInsertTimer(timer);
     hi = (u32)(result >> 32);
@@ -65,6 +76,7 @@ s32 osSetTimer(OSTimer *timer, OSTime countdown, OSTime interval,
     if (__osTimerList == timer) {
         __osSetCompare(hi, lo);
     }
+#endif
 
     return 0;
 }
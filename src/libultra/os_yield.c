@@ -11,6 +11,9 @@
 #include "types.h"
 #include "PR/os_thread.h"
 
+/* Host builds use the pthread backend in os_host.c */
+#ifndef HOST_BUILD
+
 /* External functions */
 extern s32 __osDisableInt(void);
 extern void __osRestoreInt(s32 mask);
@@ -75,3 +78,5 @@ OSPri osGetThreadPri(OSThread *thread) {
     }
     return thread->priority;
 }
+
+#endif /* HOST_BUILD */
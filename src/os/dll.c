@@ -5,9 +5,15 @@
  * Decompiled from asm/us/CC50.s
  * Similar to arcade GUTS timer queue (OS/os_proto.h struct tq)
  *
- * This implements a delta-queue timer system where each node stores
- * the time remaining relative to the previous node. This allows O(1)
- * timer decrements - only the head node's delta needs updating each tick.
+ * The matching build implements a delta-queue timer system where each
+ * node stores the time remaining relative to the previous node. This
+ * allows O(1) timer decrements - only the head node's delta needs
+ * updating each tick - but insert walks the list with interrupts off.
+ *
+ * NON_MATCHING builds replace it with a binary min-heap keyed on absolute
+ * 64-bit deadlines: O(log n) insert and cancel, O(1) next-expiry peek,
+ * and periodic timers re-armed from their previous deadline so they do
+ * not drift.
  */
 
 #include "types.h"
@@ -82,6 +88,9 @@ extern void __osRestoreInt(s32 mask);               /* Restore interrupts */
 /* Forward declarations */
 void dll_reschedule(u32 hi, u32 lo);
 void dll_insert(TimerNode *node);
+void dll_cancel(TimerNode *node);
+s32 dll_peek_next(u64 *deadline);
+s32 dll_stress(TimerNode *nodes, s32 count);
 
 /**
  * Remove a node from a singly-linked list
@@ -102,6 +111,8 @@ void dll_remove(DLLNode **list, DLLNode *node) {
     }
 }
 
+#ifndef NON_MATCHING
+
 /**
  * Initialize the global timer queue
  * (0x8000C090)
@@ -214,6 +225,8 @@ loop:
     goto loop;
 }
 
+#endif /* !NON_MATCHING */
+
 /**
  * Reschedule timer interrupt
  * (0x8000C294)
@@ -245,6 +258,8 @@ void dll_reschedule(u32 hi, u32 lo) {
     __osRestoreInt(savedMask);
 }
 
+#ifndef NON_MATCHING
+
 /**
  * Insert a timer node into the delta queue
  * (0x8000C308)
@@ -308,6 +323,335 @@ void dll_insert(TimerNode *node) {
     __osRestoreInt(savedMask);
 }
 
+#else /* NON_MATCHING */
+
+/*
+ * ==========================================================================
+ * Min-heap timer queue
+ * ==========================================================================
+ *
+ * Nodes keep their arcade layout. While queued, delta_hi:delta_lo holds
+ * the absolute deadline on a 64-bit timeline extended from osGetCount(),
+ * next is NULL and prev holds the node's heap slot (so cancel does not
+ * need to search). Callers still pass a relative countdown in
+ * delta_hi:delta_lo to dll_insert.
+ */
+
+#define TIMER_HEAP_MAX      1024
+
+static TimerNode *sTimerHeap[TIMER_HEAP_MAX];
+static s32 sTimerHeapCount;
+static u64 sTimerNow;           /* Extended osGetCount() timeline */
+static u32 sTimerHeapCompares;  /* Key comparisons, for dll_stress */
+
+#define TIMER_KEY(n)        (((u64)(n)->delta_hi << 32) | (n)->delta_lo)
+#define TIMER_SLOT(n)       (*(s32 *)&(n)->prev)
+
+static void timer_set_key(TimerNode *n, u64 key) {
+    n->delta_hi = (u32)(key >> 32);
+    n->delta_lo = (u32)key;
+}
+
+/**
+ * Advance the 64-bit timeline to the current count
+ */
+static u64 timer_now(void) {
+    u32 current_time = osGetCount();
+
+    sTimerNow += (u32)(current_time - __osTimerCounter);
+    __osTimerCounter = current_time;
+    return sTimerNow;
+}
+
+static void heap_place(TimerNode *n, s32 slot) {
+    sTimerHeap[slot] = n;
+    TIMER_SLOT(n) = slot;
+}
+
+static void heap_sift_up(s32 slot) {
+    TimerNode *n = sTimerHeap[slot];
+    u64 key = TIMER_KEY(n);
+    s32 parent;
+
+    while (slot > 0) {
+        parent = (slot - 1) >> 1;
+        sTimerHeapCompares++;
+        if (TIMER_KEY(sTimerHeap[parent]) <= key) {
+            break;
+        }
+        heap_place(sTimerHeap[parent], slot);
+        slot = parent;
+    }
+    heap_place(n, slot);
+}
+
+static void heap_sift_down(s32 slot) {
+    TimerNode *n = sTimerHeap[slot];
+    u64 key = TIMER_KEY(n);
+    s32 child;
+
+    for (;;) {
+        child = slot * 2 + 1;
+        if (child >= sTimerHeapCount) {
+            break;
+        }
+        if (child + 1 < sTimerHeapCount) {
+            sTimerHeapCompares++;
+            if (TIMER_KEY(sTimerHeap[child + 1]) < TIMER_KEY(sTimerHeap[child])) {
+                child++;
+            }
+        }
+        sTimerHeapCompares++;
+        if (key <= TIMER_KEY(sTimerHeap[child])) {
+            break;
+        }
+        heap_place(sTimerHeap[child], slot);
+        slot = child;
+    }
+    heap_place(n, slot);
+}
+
+/**
+ * Add a node with an absolute deadline already in its key
+ * @return 0 on success, -1 if the heap is full
+ */
+static s32 heap_push(TimerNode *n) {
+    if (sTimerHeapCount >= TIMER_HEAP_MAX) {
+        return -1;
+    }
+    n->next = NULL;
+    heap_place(n, sTimerHeapCount++);
+    heap_sift_up(TIMER_SLOT(n));
+    return 0;
+}
+
+/**
+ * Remove the node in a heap slot
+ */
+static void heap_remove_slot(s32 slot) {
+    TimerNode *n = sTimerHeap[slot];
+    TimerNode *last;
+
+    sTimerHeapCount--;
+    if (slot != sTimerHeapCount) {
+        last = sTimerHeap[sTimerHeapCount];
+        heap_place(last, slot);
+        if (slot > 0 && TIMER_KEY(last) < TIMER_KEY(sTimerHeap[(slot - 1) >> 1])) {
+            heap_sift_up(slot);
+        } else {
+            heap_sift_down(slot);
+        }
+    }
+
+    n->next = NULL;
+    n->prev = NULL;
+}
+
+/**
+ * Program the compare register for the current earliest deadline
+ *
+ * Arms from the count timer_now() just sampled rather than going through
+ * dll_reschedule, which would re-read the count and drop the ticks in
+ * between from the 64-bit timeline.
+ */
+static void heap_rearm(void) {
+    u64 now, key, remaining;
+
+    if (sTimerHeapCount == 0) {
+        __osSetCompare(0);
+        return;
+    }
+
+    now = timer_now();
+    key = TIMER_KEY(sTimerHeap[0]);
+    remaining = key > now ? key - now : 0;
+    if (remaining > 0xFFFFFFFF) {
+        /* Fire early; dll_update finds nothing due and re-arms */
+        remaining = 0xFFFFFFFF;
+    }
+    __osSetCompare((s32)(__osTimerCounter + (u32)remaining));
+}
+
+/**
+ * Initialize the global timer queue (heap)
+ */
+void dll_init(void) {
+    gViTimeAccumHi = 0;
+    gViTimeAccumLo = 0;
+    gViLastCount = 0;
+    gViRetraceCount = 0;
+
+    sTimerHeapCount = 0;
+    sTimerNow = 0;
+    __osTimerCounter = osGetCount();
+}
+
+/**
+ * Fire every expired timer (heap)
+ *
+ * Each expiry is an O(log n) pop; periodic timers are re-armed from
+ * their own deadline rather than from "now".
+ */
+void dll_update(void) {
+    TimerNode *node;
+    u64 now, reload;
+
+    while (sTimerHeapCount > 0) {
+        now = timer_now();
+        node = sTimerHeap[0];
+        if (TIMER_KEY(node) > now) {
+            break;
+        }
+
+        heap_remove_slot(0);
+
+        if (node->mq != NULL) {
+            osJamMesg(node->mq, node->msg, 0);
+        }
+
+        reload = ((u64)node->reload_hi << 32) | node->reload_lo;
+        if (reload != 0) {
+            timer_set_key(node, TIMER_KEY(node) + reload);
+            heap_push(node);
+        }
+    }
+
+    heap_rearm();
+}
+
+/**
+ * Insert a timer node (heap)
+ *
+ * @param node Timer node; delta_hi:delta_lo is the countdown from now
+ */
+void dll_insert(TimerNode *node) {
+    s32 savedMask;
+    TimerNode *old_first;
+
+    savedMask = __osDisableInt();
+
+    old_first = sTimerHeapCount > 0 ? sTimerHeap[0] : NULL;
+    timer_set_key(node, timer_now() + TIMER_KEY(node));
+
+    if (heap_push(node) == 0 && sTimerHeap[0] != old_first) {
+        heap_rearm();
+    }
+
+    __osRestoreInt(savedMask);
+}
+
+/**
+ * Cancel a queued timer in O(log n)
+ *
+ * @param node Timer node (ignored if not queued)
+ */
+void dll_cancel(TimerNode *node) {
+    s32 savedMask;
+    s32 slot;
+
+    savedMask = __osDisableInt();
+
+    slot = TIMER_SLOT(node);
+    if (slot >= 0 && slot < sTimerHeapCount && sTimerHeap[slot] == node) {
+        heap_remove_slot(slot);
+        if (slot == 0) {
+            heap_rearm();
+        }
+    }
+
+    __osRestoreInt(savedMask);
+}
+
+/**
+ * Peek the earliest deadline in O(1)
+ *
+ * @param deadline Output absolute deadline (may be NULL)
+ * @return 1 if a timer is queued, 0 if the queue is empty
+ */
+s32 dll_peek_next(u64 *deadline) {
+    if (sTimerHeapCount == 0) {
+        return 0;
+    }
+    if (deadline != NULL) {
+        *deadline = TIMER_KEY(sTimerHeap[0]);
+    }
+    return 1;
+}
+
+/**
+ * Heap stress test
+ *
+ * Queues count timers with scattered deadlines (directly on the heap, no
+ * interrupts or messages), cancels every third one, then drains the heap
+ * checking that deadlines come out in order. The live queue is parked at
+ * the top of the heap array for the run, so count is clamped to the slots
+ * it leaves free. Wrap in osGetCount() for a timing figure.
+ *
+ * @param nodes Scratch nodes supplied by the caller
+ * @param count Number of timers (at most TIMER_HEAP_MAX minus live timers)
+ * @return Key comparisons performed, or -1 if ordering was violated
+ */
+s32 dll_stress(TimerNode *nodes, s32 count) {
+    s32 savedMask;
+    s32 saved_count;
+    s32 i, ok;
+    u32 seed = 0x2049;
+    u64 prev_key;
+    TimerNode *n;
+
+    savedMask = __osDisableInt();
+
+    /* Park the live queue above the test range */
+    saved_count = sTimerHeapCount;
+    if (count > TIMER_HEAP_MAX - saved_count) {
+        count = TIMER_HEAP_MAX - saved_count;
+    }
+    for (i = 0; i < saved_count; i++) {
+        sTimerHeap[TIMER_HEAP_MAX - 1 - i] = sTimerHeap[i];
+    }
+    sTimerHeapCount = 0;
+    sTimerHeapCompares = 0;
+
+    for (i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        n = &nodes[i];
+        n->mq = NULL;
+        n->reload_hi = 0;
+        n->reload_lo = 0;
+        timer_set_key(n, (u64)(seed >> 8));
+        heap_push(n);
+    }
+
+    for (i = 0; i < count; i += 3) {
+        if (sTimerHeap[TIMER_SLOT(&nodes[i])] == &nodes[i]) {
+            heap_remove_slot(TIMER_SLOT(&nodes[i]));
+        }
+    }
+
+    ok = 1;
+    prev_key = 0;
+    while (sTimerHeapCount > 0) {
+        n = sTimerHeap[0];
+        if (TIMER_KEY(n) < prev_key) {
+            ok = 0;
+        }
+        prev_key = TIMER_KEY(n);
+        heap_remove_slot(0);
+    }
+
+    /* Restore the live queue */
+    for (i = 0; i < saved_count; i++) {
+        heap_place(sTimerHeap[TIMER_HEAP_MAX - 1 - i], i);
+    }
+    sTimerHeapCount = saved_count;
+
+    __osRestoreInt(savedMask);
+
+    return ok ? (s32)sTimerHeapCompares : -1;
+}
+
+#endif /* NON_MATCHING */
+
 /**
  * Get thread priority (helper)
  * (0x8000C490)